@@ -1,8 +1,68 @@
 #include "CommandBuilder.h"
 
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
 #include "networking/clientbound_packets.h"
+#include "networking/compression_policy.h"
+#include "networking/packet_capture.h"
+#include "networking/packet_stats.h"
 #include "core/config.h"
 
+constexpr const char* PACKET_STATS_FILE = "packet_stats.json";
+constexpr size_t NETSTATS_TOP_PACKETS = 10;
+
+// The packet types that cost the most in one direction, by wire bytes clientbound and by count serverbound
+static void formatDirection(std::stringstream& out, std::vector<PacketTrafficStats> stats, const PacketDirection direction) {
+    std::erase_if(stats, [direction](const PacketTrafficStats& entry) { return entry.direction != direction; });
+    uint64_t totalCount = 0;
+    uint64_t totalBytes = 0;
+    for (const PacketTrafficStats& entry : stats) {
+        totalCount += entry.count;
+        totalBytes += entry.wireBytes;
+    }
+    bool clientbound = direction == PacketDirection::Clientbound;
+    std::sort(stats.begin(), stats.end(), [clientbound](const PacketTrafficStats& a, const PacketTrafficStats& b) {
+        return clientbound ? a.wireBytes > b.wireBytes : a.count > b.count;
+    });
+
+    out << (clientbound ? "Clientbound" : "Serverbound") << ": " << totalCount << " packets, " << totalBytes << " bytes";
+    for (size_t i = 0; i < stats.size() && i < NETSTATS_TOP_PACKETS; i++) {
+        const PacketTrafficStats& entry = stats[i];
+        out << "\n  0x" << std::hex << std::setw(2) << std::setfill('0') << entry.packetID << std::dec << std::setfill(' ')
+            << ": " << entry.count << " (" << std::fixed << std::setprecision(1) << 100.0 * entry.count / std::max<uint64_t>(totalCount, 1) << "%), "
+            << entry.wireBytes << " bytes (" << 100.0 * entry.wireBytes / std::max<uint64_t>(totalBytes, 1) << "%)";
+        if (clientbound) {
+            out << std::setprecision(2) << ", serialize " << entry.serializeNanos / 1e6 << " ms, compress " << entry.compressNanos / 1e6
+                << " ms, encrypt " << entry.encryptNanos / 1e6 << " ms";
+        } else if (entry.compressNanos > 0) {
+            out << std::setprecision(2) << ", inflate " << entry.compressNanos / 1e6 << " ms";
+        }
+    }
+}
+
+static std::string formatPacketStats() {
+    std::vector<PacketTrafficStats> stats = getPacketStats();
+    std::stringstream out;
+    formatDirection(out, stats, PacketDirection::Clientbound);
+    out << "\n";
+    formatDirection(out, stats, PacketDirection::Serverbound);
+
+    std::vector<PacketCompressionStats> compression = getCompressionStats();
+    if (!compression.empty()) {
+        out << "\nCompression:";
+        for (const PacketCompressionStats& entry : compression) {
+            out << "\n  0x" << std::hex << std::setw(2) << std::setfill('0') << entry.packetID << std::dec << std::setfill(' ')
+                << ": ratio " << std::setprecision(2) << entry.ratio << ", " << entry.packets << " compressed, " << entry.skipped << " skipped"
+                << (entry.disabled ? " (disabled)" : "");
+        }
+    }
+    return out.str();
+}
+
 void buildAllCommands() {
     CommandBuilder builder;
 
@@ -895,6 +955,70 @@ void buildAllCommands() {
                 .end() // End <duration> argument
             .end() // End "thunder" subcommand
         .end(); // End "weather" command
+
+    // List command: /list
+    builder
+        .literal("list", true, true)
+            .handler([](const Player* player, const std::vector<std::string>& args, const std::function<void(const std::string&, bool, const std::vector<std::string>& args)> &sendOutput) {
+                // Served from the same snapshot as the server list ping and Query
+                std::shared_ptr<const StatusSnapshot> status = serverStatus.current();
+                std::string playerList;
+                for (const std::string& name : status->playerNames) {
+                    playerList += playerList.empty() ? name : ", " + name;
+                }
+                sendOutput("commands.list.players", false, {std::to_string(status->onlinePlayers), std::to_string(status->maxPlayers), playerList});
+            })
+        .end(); // End "list" command
+
+    // Network statistics command: /netstats [dump|reset]
+    builder
+        .literal("netstats", true, true)
+            .handler([](const Player* player, const std::vector<std::string>& args, const std::function<void(const std::string&, bool, const std::vector<std::string>& args)> &sendOutput) {
+                sendOutput(formatPacketStats(), false, {});
+            })
+            .literal("dump", true, true)
+                .handler([](const Player* player, const std::vector<std::string>& args, const std::function<void(const std::string&, bool, const std::vector<std::string>& args)> &sendOutput) {
+                    std::ofstream file(PACKET_STATS_FILE);
+                    if (!file) {
+                        sendOutput("Could not write " + std::string(PACKET_STATS_FILE), true, {});
+                        return;
+                    }
+                    file << dumpPacketStats();
+                    sendOutput("Packet statistics written to " + std::string(PACKET_STATS_FILE), false, {});
+                })
+            .end() // End "dump" subcommand
+            .literal("reset", true, true)
+                .handler([](const Player* player, const std::vector<std::string>& args, const std::function<void(const std::string&, bool, const std::vector<std::string>& args)> &sendOutput) {
+                    resetPacketStats();
+                    sendOutput("Packet statistics reset", false, {});
+                })
+            .end() // End "reset" subcommand
+        .end(); // End "netstats" command
+    // Packet capture command: /capture <start|stop>
+    builder
+        .literal("capture", true, true)
+            .literal("start", true, true)
+                .handler([](const Player* player, const std::vector<std::string>& args, const std::function<void(const std::string&, bool, const std::vector<std::string>& args)> &sendOutput) {
+                    std::time_t now = std::time(nullptr);
+                    std::stringstream path;
+                    path << "capture-" << std::put_time(std::localtime(&now), "%Y%m%d-%H%M%S") << ".mcpc";
+                    if (!startPacketCapture(path.str())) {
+                        sendOutput("A capture is already running or " + path.str() + " could not be created", true, {});
+                        return;
+                    }
+                    sendOutput("Capturing packets to " + path.str(), false, {});
+                })
+            .end() // End "start" subcommand
+            .literal("stop", true, true)
+                .handler([](const Player* player, const std::vector<std::string>& args, const std::function<void(const std::string&, bool, const std::vector<std::string>& args)> &sendOutput) {
+                    if (!stopPacketCapture()) {
+                        sendOutput("No capture is running", true, {});
+                        return;
+                    }
+                    sendOutput("Packet capture stopped", false, {});
+                })
+            .end() // End "stop" subcommand
+        .end(); // End "capture" command
     // Inventory command: /inventory <player>
     builder
         .literal("inventory", true, true)
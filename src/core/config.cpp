@@ -38,6 +38,17 @@ void loadConfig() {
         serverConfig.enableRcon = false;
         serverConfig.ticksPerSecond = 20;
         serverConfig.consoleLang = "en_us";
+        serverConfig.networkThreads = 4;
+        serverConfig.reusePort = false;
+        serverConfig.compressionThreads = 2;
+        serverConfig.cryptoThreads = 2;
+        serverConfig.rsaKeyFile = "server_key.pem";
+        serverConfig.outboundHighWatermark = 524288;
+        serverConfig.outboundLowWatermark = 131072;
+        serverConfig.sessionServerURL = "https://sessionserver.mojang.com";
+        serverConfig.profileApiURL = "https://api.mojang.com";
+        serverConfig.authThreads = 16;
+        serverConfig.profileCacheTTL = 600;
         logMessage("Failed to open config file: " + configFilePath, LOG_ERROR);
         return;
     }
@@ -67,6 +78,19 @@ void loadConfig() {
     serverConfig.enableEncryption = (jsonConfig.value("enable_encryption", true) || serverConfig.onlineMode);
     serverConfig.enableCompression = jsonConfig.value("enable_compression", true);
     serverConfig.compressionThreshold = jsonConfig.value("compression_threshold", 256);
+    if (jsonConfig.contains("compression_policy")) {
+        const auto& policy = jsonConfig["compression_policy"];
+        serverConfig.compressionPolicy.defaultLevel = std::clamp(policy.value("default_level", 6), 1, 9);
+        serverConfig.compressionPolicy.maxRatio = policy.value("max_ratio", 0.9);
+        for (const auto& packet : policy.value("packets", nlohmann::json::array())) {
+            try {
+                int32_t packetID = std::stoi(packet.value("packet_id", ""), nullptr, 16);
+                serverConfig.compressionPolicy.packetLevels[packetID] = std::clamp(packet.value("level", 6), 0, 9);
+            } catch (const std::exception&) {
+                logMessage("Invalid packet_id in compression_policy: " + packet.dump(), LOG_WARNING);
+            }
+        }
+    }
     serverConfig.enableSecureChat = jsonConfig.value("enable_secure_chat", true) && serverConfig.enableEncryption;
     if (serverConfig.serverId.empty()) {
         serverConfig.serverId = generateServerID();
@@ -175,5 +199,27 @@ void loadConfig() {
 
     serverConfig.ticksPerSecond = jsonConfig.value("ticks_per_second", 20);
     serverConfig.consoleLang = jsonConfig.value("console_language", "en_us");
+    serverConfig.networkThreads = jsonConfig.value("network_threads", 4);
+    serverConfig.networkThreads = std::clamp(serverConfig.networkThreads, 1, 64);
+    serverConfig.reusePort = jsonConfig.value("reuse_port", false);
+    serverConfig.compressionThreads = jsonConfig.value("compression_threads", 2);
+    serverConfig.compressionThreads = std::clamp(serverConfig.compressionThreads, 1, 64);
+    serverConfig.cryptoThreads = jsonConfig.value("crypto_threads", 2);
+    serverConfig.cryptoThreads = std::clamp(serverConfig.cryptoThreads, 1, 64);
+    serverConfig.rsaKeyFile = jsonConfig.value("rsa_key_file", "server_key.pem");
+    // If key path is relative, resolve it relative to the config file directory
+    if (!isAbsolutePath(serverConfig.rsaKeyFile)) {
+        serverConfig.rsaKeyFile = configDirectory + "/" + serverConfig.rsaKeyFile;
+    }
+    serverConfig.outboundHighWatermark = jsonConfig.value("outbound_high_watermark", 524288);
+    serverConfig.outboundHighWatermark = std::max(serverConfig.outboundHighWatermark, 65536);
+    serverConfig.outboundLowWatermark = jsonConfig.value("outbound_low_watermark", 131072);
+    serverConfig.outboundLowWatermark = std::clamp(serverConfig.outboundLowWatermark, 0, serverConfig.outboundHighWatermark - 1);
+    serverConfig.sessionServerURL = jsonConfig.value("session_server_url", "https://sessionserver.mojang.com");
+    serverConfig.profileApiURL = jsonConfig.value("profile_api_url", "https://api.mojang.com");
+    serverConfig.authThreads = jsonConfig.value("auth_threads", 16);
+    serverConfig.authThreads = std::clamp(serverConfig.authThreads, 1, 256);
+    serverConfig.profileCacheTTL = jsonConfig.value("profile_cache_ttl", 600);
+    serverConfig.profileCacheTTL = std::max(serverConfig.profileCacheTTL, 0);
 }
 
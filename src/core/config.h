@@ -4,6 +4,7 @@
 #include <array>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 struct ResourcePack {
@@ -27,6 +28,12 @@ struct WorldBorderConfig {
     int32_t warningBlocks = 5;                             // In meters
 };
 
+struct CompressionPolicyConfig {
+    int defaultLevel = 6;                           // zlib level for packets without an override
+    std::unordered_map<int32_t, int> packetLevels;  // Per packet ID, 0 sends the packet uncompressed
+    double maxRatio = 0.9;                          // Stop compressing a packet type once compressed/raw stays above this
+};
+
 struct ServerConfig {
     std::string server_version;
     int protocol_version;
@@ -41,6 +48,7 @@ struct ServerConfig {
     bool enableEncryption;
     bool enableCompression;
     int compressionThreshold;
+    CompressionPolicyConfig compressionPolicy;
     bool enableSecureChat;
     std::string serverId{};
     int opPermissionLevel;
@@ -57,6 +65,19 @@ struct ServerConfig {
     WorldBorderConfig worldBorder;
     int ticksPerSecond;
     std::string consoleLang;
+    // Networking
+    int networkThreads;
+    bool reusePort; // One SO_REUSEPORT listening socket per network thread instead of a single accept loop
+    int compressionThreads;
+    int cryptoThreads;
+    std::string rsaKeyFile;
+    int outboundHighWatermark;
+    int outboundLowWatermark;
+    // Session authentication
+    std::string sessionServerURL;
+    std::string profileApiURL;
+    int authThreads;
+    int profileCacheTTL; // In seconds, 0 disables the cache
 };
 
 extern ServerConfig serverConfig;
@@ -8,10 +8,14 @@
 #include "commands/CommandBuilder.h"
 #include "data/crafting_recipes.h"
 #include "entities/item_entity.h"
+#include "networking/chunk_sender.h"
 #include "networking/clientbound_packets.h"
+#include "networking/fetch.h"
+#include "networking/reactor.h"
 #include "server/query_server.h"
 #include "server/rcon_server.h"
 #include "utils/translation.h"
+#include "world/chunk.h"
 #include "world/world.h"
 
 void tickingSystem() {
@@ -30,22 +34,21 @@ void tickingSystem() {
     while (true) {
         // Wait until the next tick
         std::this_thread::sleep_until(nextTick);
+        // Apply what players did since the last tick
+        processIngestedPackets();
+        // Next chunk batch for every player with room for one
+        sendChunkBatches();
         // Increment world time
         worldTime.tick();
         if (tickCount % 20 == 0) {
             // Every second
 
             // Notify all connected clients about the updated time
-            {
-                std::lock_guard lock(connectedClientsMutex);
-                for (auto &existingClient: connectedClients | std::views::values) {
-                    sendTimeUpdatePacket(*existingClient);
-                }
-            }
+            broadcastTimeUpdatePacket();
         }
 
-        // Update weather
-        weather.handleTick();
+        // Keep alives, mining stages and weather changes
+        timerWheel.tick();
         std::unordered_map<int32_t, std::shared_ptr<Entity>> entities = entityManager.getAllEntities();
         for (auto &entity: entityManager.getAllEntities() | std::views::values) {
             if (entity->type != EntityType::Item) {
@@ -201,9 +204,11 @@ void tickingSystem() {
             auto deltaYShort = static_cast<short>(relativeDeltaY * 4096.0);
             auto deltaZShort = static_cast<short>(relativeDeltaZ * 4096.0);
 
-            // Send relative move packet to clients
-            sendEntityRelativeMovePacket(item, deltaXShort, deltaYShort, deltaZShort);
-            sendEntityVelocity(item);
+            // Queue the move for the end-of-tick entity sync, items at rest send nothing
+            if (deltaXShort != 0 || deltaYShort != 0 || deltaZShort != 0) {
+                entitySync.markMoved(item, deltaXShort, deltaYShort, deltaZShort);
+            }
+            entitySync.markVelocityChanged(item);
             // Items crossing a block boundary are processed every 2 ticks
             if (tickCount % 2 == 0 &&
             (static_cast<int32_t>(std::floor(item->getPositionX())) != static_cast<int32_t>(std::floor(oldPosX)) ||
@@ -223,25 +228,39 @@ void tickingSystem() {
             }
         }
 
+        // Send this tick's entity movement to the players that can see it, one bundle per client,
+        // then spawn and destroy entities for players they came into or went out of range of
+        entitySync.flush();
+        entityTracker.update();
+
+        // One packet per changed chunk section
+        flushBlockChanges();
+
+        // Have the I/O threads write out everything queued during this tick, one call per client
+        {
+            std::lock_guard lock(connectedClientsMutex);
+            for (auto &existingClient: connectedClients | std::views::values) {
+                scheduleFlush(*existingClient);
+            }
+        }
+
         // Schedule the next tick
         nextTick += tickInterval;
         tickCount++;
     }
 }
 
-void startMiningScheduler() {
-    miningRunning = true;
-    miningThread = std::thread(miningScheduler, std::ref(globalPlayers), std::ref(miningRunning));
-}
 
-void stopMiningScheduler() {
-    miningRunning = false;
-    if (miningThread.joinable()) {
-        miningThread.join();
-    }
+void loadGameData() {
+    blocks = loadBlocks("../resources/blocks.json");
+    biomes = loadBiomes("../resources/biomes.json");
+    items = loadItems("../resources/items.json");
+    itemIDs = loadItemIDs("../resources/items.json");
+    translations = loadTranslations("../resources/languages.json");
+    loadCollisions("../resources/blockCollisionShapes.json");
+    craftingRecipes = loadCraftingRecipes("../resources/recipes/crafting_recipes.json");
 }
 
-
 void runServer() {
     auto startTime = std::chrono::system_clock::now();
 
@@ -249,6 +268,13 @@ void runServer() {
     manageResourcePacks();
     buildAllCommands();
 
+    try {
+        serverKeyPair = std::make_unique<RSAKeyPair>(serverConfig.rsaKeyFile);
+    } catch (const std::exception& e) {
+        logMessage("Failed to set up the server key pair: " + std::string(e.what()), LOG_ERROR);
+        return;
+    }
+
 #ifdef _WIN32
     // Initialize Winsock
     WSADATA wsaData;
@@ -259,53 +285,32 @@ void runServer() {
     }
 #endif
 
-    SocketType serverSock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
-    if (serverSock == INVALID_SOCKET) {
-        logMessage("Failed to create socket.", LOG_ERROR);
-#ifdef _WIN32
-        WSACleanup();
-#endif
-        return;
+    bool reusePort = serverConfig.reusePort;
+#ifndef __linux__
+    if (reusePort) {
+        logMessage("reuse_port is only supported on Linux, accepting on a single socket", LOG_WARNING);
+        reusePort = false;
     }
-
-    // Set socket options
-    int opt = 1;
-#ifdef _WIN32
-    setsockopt(serverSock, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&opt), sizeof(opt));
-#else
-    setsockopt(serverSock, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
 #endif
 
-    sockaddr_in serverAddr{};
-    serverAddr.sin_family = AF_INET;
-#ifdef _WIN32
-    serverAddr.sin_addr.s_addr = INADDR_ANY;
-#else
-    serverAddr.sin_addr.s_addr = htonl(INADDR_ANY);
-#endif
-    serverAddr.sin_port = htons(serverConfig.port);
-
-    if (bind(serverSock, reinterpret_cast<sockaddr*>(&serverAddr), sizeof(serverAddr)) == SOCKET_ERROR) {
-        logMessage("Failed to bind socket.", LOG_ERROR);
-#ifdef _WIN32
-        closesocket(serverSock);
-        WSACleanup();
-#else
-        close(serverSock);
-#endif
-        return;
-    }
-
-    if (listen(serverSock, SOMAXCONN) == SOCKET_ERROR) {
-        logMessage("Failed to listen on socket.", LOG_ERROR);
+    // With reuse_port every network thread gets its own socket and the kernel balances new
+    // connections over them, otherwise this thread accepts them all on one socket
+    std::vector<SocketType> listenSockets;
+    size_t socketCount = reusePort ? static_cast<size_t>(serverConfig.networkThreads) : 1;
+    while (listenSockets.size() < socketCount) {
+        SocketType listenSock = openListenSocket(serverConfig.port, reusePort);
+        if (listenSock == INVALID_SOCKET) {
+            for (SocketType openSock : listenSockets) {
+                closeSocket(openSock);
+            }
 #ifdef _WIN32
-        closesocket(serverSock);
-        WSACleanup();
-#else
-        close(serverSock);
+            WSACleanup();
 #endif
-        return;
+            return;
+        }
+        listenSockets.push_back(listenSock);
     }
+    SocketType serverSock = listenSockets.front();
 
     // Load world
     auto world = new World("world");
@@ -313,13 +318,12 @@ void runServer() {
         logMessage("Failed to load world.", LOG_ERROR);
     }
 
-    blocks = loadBlocks("../resources/blocks.json");
-    biomes = loadBiomes("../resources/biomes.json");
-    items = loadItems("../resources/items.json");
-    itemIDs = loadItemIDs("../resources/items.json");
-    translations = loadTranslations("../resources/languages.json");
-    loadCollisions("../resources/blockCollisionShapes.json");
-    craftingRecipes = loadCraftingRecipes("../resources/recipes/crafting_recipes.json");
+    loadGameData();
+    if (serverConfig.enableSecureChat && !loadMojangPublicKeys()) {
+        logMessage("Player chat sessions can't be verified without Mojang's public keys", LOG_WARNING);
+    }
+    // Needs the biomes, recipes and command graph
+    rebuildConfigurationFrames();
 
     auto endTime = std::chrono::system_clock::now();
     std::chrono::duration<double> elapsedSeconds = endTime - startTime;
@@ -341,7 +345,7 @@ void runServer() {
         }
     }
 
-    startMiningScheduler();
+    weather.start();
 
     // Start the console input thread
     std::thread consoleThread([&]() {
@@ -358,6 +362,22 @@ void runServer() {
     std::thread tickThread(tickingSystem);
     tickThread.detach();
 
+    NetworkReactor reactor(serverConfig.networkThreads);
+    if (!reactor.start(reusePort ? listenSockets : std::vector<SocketType>{})) {
+        logMessage("Failed to start network reactor.", LOG_ERROR);
+        if (!reusePort) {
+            // Only handed to the reactor with SO_REUSEPORT, otherwise it is still ours
+            closeSocket(serverSock);
+        }
+        return;
+    }
+
+    if (reusePort) {
+        // The network threads own the listening sockets and accept on them
+        reactor.wait();
+        return;
+    }
+
     while (true) {
         sockaddr_in clientAddr{};
 #ifdef _WIN32
@@ -371,10 +391,10 @@ void runServer() {
             continue;
         }
 
-        std::thread(handleClient, clientSock).detach();
+        reactor.addConnection(clientSock);
     }
 
-    stopMiningScheduler();
+    reactor.stop();
 
     if (serverConfig.enableRcon) {
         rconServer->stop();
@@ -6,11 +6,16 @@
 
 #include "data/crafting_recipes.h"
 #include "data/data.h"
+#include "encryption/rsa_key.h"
 #include "entities/entity.h"
 #include "entities/entity_manager.h"
+#include "networking/entity_sync.h"
+#include "networking/entity_tracker.h"
 #include "world/flatworld.h"
 #include "server/rcon_server.h"
+#include "server/server_status.h"
 #include "utils/thread_pool.h"
+#include "utils/timer_wheel.h"
 #include "world/boss_bar.h"
 #include "world/weather.h"
 #include "world/world_border.h"
@@ -23,6 +28,8 @@ class RootNode;
 struct ClientConnection;
 
 void runServer();
+// Blocks, biomes, items, translations, collision shapes and recipes from ../resources
+void loadGameData();
 
 enum class GameEvent : uint8_t {
     NoRespawnBlockAvailable = 0,
@@ -48,6 +55,8 @@ inline std::unordered_map<std::string, FlatWorldSettings> flatWorldPresets = loa
             "../resources/flatworld_presets.json");
 
 inline EntityManager entityManager;
+inline EntitySync entitySync;
+inline EntityTracker entityTracker;
 
 inline std::unordered_map<std::string, BiomeData> biomes;
 inline std::unordered_map<std::string, BlockData> blocks;
@@ -63,16 +72,17 @@ inline std::pair<std::vector<uint8_t>, int> serializedCommandGraph;
 inline std::unordered_map<std::string, std::shared_ptr<Player>> globalPlayers; // Key: UUID
 inline std::unordered_map<std::string, std::shared_ptr<Player>> globalPlayersName; // Key: Username
 inline std::mutex playersMutex;
-
-inline std::thread miningThread;
-inline std::atomic<bool> miningRunning;
+inline std::atomic<int> playerCount(0);
 
 inline std::unordered_map<std::string, ClientConnection*> connectedClients;
 inline std::mutex connectedClientsMutex;
 
 inline thread_pool threadPool(std::thread::hardware_concurrency());
+inline TimerWheel timerWheel; // Advanced by the tick loop, one slot per tick
 
 inline std::unique_ptr<RCONServer> rconServer;
+inline std::unique_ptr<RSAKeyPair> serverKeyPair; // Shared by every login
+inline ServerStatus serverStatus;
 
 // TODO: Create a world class to hold all world data
 inline WorldBorder worldBorder;
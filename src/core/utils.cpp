@@ -405,47 +405,89 @@ std::vector<uint8_t> decompressGZip(const std::vector<uint8_t>& compressedData)
     return decompressedData;
 }
 
-std::vector<uint8_t> compressData(const std::vector<uint8_t>& data) {
-    z_stream zs = {};
+// zlib streams kept alive for the lifetime of a thread and reset between packets.
+// deflateInit allocates ~256 KiB of state, far too much to set up for every packet.
+struct DeflateContext {
+    z_stream stream{};
+    bool initialized = false;
+    int level = Z_DEFAULT_COMPRESSION;
 
-    if (deflateInit(&zs, Z_DEFAULT_COMPRESSION) != Z_OK) {
-        throw std::runtime_error("deflateInit failed while compressing.");
+    ~DeflateContext() {
+        if (initialized) deflateEnd(&stream);
     }
+};
 
-    zs.next_in = const_cast<Bytef*>(data.data());
-    zs.avail_in = data.size();
+struct InflateContext {
+    z_stream stream{};
+    bool initialized = false;
 
-    int ret;
-    std::vector<uint8_t> out;
+    ~InflateContext() {
+        if (initialized) inflateEnd(&stream);
+    }
+};
 
-    do {
-        char outbuffer[32768];
-        zs.next_out = reinterpret_cast<Bytef*>(outbuffer);
-        zs.avail_out = sizeof(outbuffer);
+static z_stream& acquireDeflateStream(int level) {
+    thread_local DeflateContext context;
+    if (!context.initialized) {
+        if (deflateInit(&context.stream, level) != Z_OK) {
+            throw std::runtime_error("deflateInit failed while compressing.");
+        }
+        context.initialized = true;
+        context.level = level;
+        return context.stream;
+    }
 
-        ret = deflate(&zs, Z_FINISH);
+    if (deflateReset(&context.stream) != Z_OK) {
+        throw std::runtime_error("deflateReset failed while compressing.");
+    }
+    // Switching levels on a freshly reset stream keeps the allocated state
+    if (context.level != level) {
+        if (deflateParams(&context.stream, level, Z_DEFAULT_STRATEGY) != Z_OK) {
+            throw std::runtime_error("deflateParams failed while compressing.");
+        }
+        context.level = level;
+    }
+    return context.stream;
+}
 
-        if (out.size() < zs.total_out) {
-            out.insert(out.end(), outbuffer, outbuffer + sizeof(outbuffer) - zs.avail_out);
+static z_stream& acquireInflateStream() {
+    thread_local InflateContext context;
+    if (!context.initialized) {
+        if (inflateInit(&context.stream) != Z_OK) {
+            throw std::runtime_error("inflateInit failed while decompressing.");
         }
-    } while (ret == Z_OK);
+        context.initialized = true;
+    } else if (inflateReset(&context.stream) != Z_OK) {
+        throw std::runtime_error("inflateReset failed while decompressing.");
+    }
+    return context.stream;
+}
+
+std::vector<uint8_t> compressData(const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> out;
+    compressData(data, out, 0, Z_DEFAULT_COMPRESSION);
+    return out;
+}
 
-    deflateEnd(&zs);
+// Deflates into out starting at offset, in a single pass sized by deflateBound
+void compressData(std::span<const uint8_t> data, std::vector<uint8_t>& out, size_t offset, int level) {
+    z_stream& zs = acquireDeflateStream(level);
+    out.resize(offset + deflateBound(&zs, data.size()));
 
-    if (ret != Z_STREAM_END) { // an error occurred that was not EOF
+    zs.next_in = const_cast<Bytef*>(data.data());
+    zs.avail_in = data.size();
+    zs.next_out = out.data() + offset;
+    zs.avail_out = out.size() - offset;
+
+    if (deflate(&zs, Z_FINISH) != Z_STREAM_END) {
         throw std::runtime_error("Exception during zlib compression.");
     }
-
-    return out;
+    out.resize(offset + zs.total_out);
 }
 
 // Decompress data using zlib (inflate)
 std::vector<uint8_t> decompressData(const std::vector<uint8_t>& data) {
-    z_stream zs = {};
-
-    if (inflateInit(&zs) != Z_OK) {
-        throw std::runtime_error("inflateInit failed while decompressing.");
-    }
+    z_stream& zs = acquireInflateStream();
 
     zs.next_in = const_cast<Bytef*>(data.data());
     zs.avail_in = data.size();
@@ -466,8 +508,6 @@ std::vector<uint8_t> decompressData(const std::vector<uint8_t>& data) {
 
     } while (ret == Z_OK);
 
-    inflateEnd(&zs);
-
     if (ret != Z_STREAM_END) { // an error occurred that was not EOF
         throw std::runtime_error("Exception during zlib decompression.");
     }
@@ -475,6 +515,25 @@ std::vector<uint8_t> decompressData(const std::vector<uint8_t>& data) {
     return out;
 }
 
+// Inflates straight into out, whose size is known up front from the packet's Data Length
+void decompressData(std::span<const uint8_t> data, size_t uncompressedSize, std::vector<uint8_t>& out) {
+    constexpr size_t MAX_UNCOMPRESSED_SIZE = 8388608; // Same limit as vanilla
+    if (uncompressedSize > MAX_UNCOMPRESSED_SIZE) {
+        throw std::runtime_error("Uncompressed packet is too large.");
+    }
+    out.resize(uncompressedSize);
+
+    z_stream& zs = acquireInflateStream();
+    zs.next_in = const_cast<Bytef*>(data.data());
+    zs.avail_in = data.size();
+    zs.next_out = out.data();
+    zs.avail_out = out.size();
+
+    if (inflate(&zs, Z_FINISH) != Z_STREAM_END || zs.total_out != uncompressedSize) {
+        throw std::runtime_error("Exception during zlib decompression.");
+    }
+}
+
 std::string computeServerHash(const std::string& serverId, const std::array<uint8_t, 16>& sharedSecret, const std::vector<uint8_t>& serverPublicKey) {
     minecraft::protocol::daft_hash_impl hasher;
     hasher.update(serverId);
@@ -3,6 +3,7 @@
 
 #include <array>
 #include <cstdint>
+#include <span>
 #include <vector>
 #include <string>
 #include <tag_compound.h>
@@ -110,7 +111,9 @@ void decodePosition(uint64_t val, int32_t &x, int32_t &y, int32_t &z);
 std::vector<uint8_t> compressGZip(const std::vector<uint8_t>& data);
 std::vector<uint8_t> decompressGZip(const std::vector<uint8_t>& compressedData);
 std::vector<uint8_t> compressData(const std::vector<uint8_t>& data);
+void compressData(std::span<const uint8_t> data, std::vector<uint8_t>& out, size_t offset, int level = -1);
 std::vector<uint8_t> decompressData(const std::vector<uint8_t>& data);
+void decompressData(std::span<const uint8_t> data, size_t uncompressedSize, std::vector<uint8_t>& out);
 std::string computeServerHash(const std::string& serverId, const std::array<uint8_t, 16>& sharedSecret, const std::vector<uint8_t>& serverPublicKey);
 std::string getClientIPAddress(const ClientConnection& client);
 std::string generateServerID();
@@ -1,11 +1,72 @@
 #include "rsa_key.h"
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 #include <openssl/err.h>
+#include <openssl/pem.h>
 #include <stdexcept>
 #include <openssl/x509.h>
 
+#include "core/utils.h"
+
 RSAKeyPair::RSAKeyPair()
     : pkey_(nullptr, EVP_PKEY_free)
 {
+    generate();
+    publicKeyDER_ = encodePublicKeyDER();
+}
+
+RSAKeyPair::RSAKeyPair(const std::string& keyFile)
+    : pkey_(nullptr, EVP_PKEY_free)
+{
+    if (std::filesystem::exists(keyFile)) {
+        BIO* bio = BIO_new_file(keyFile.c_str(), "rb");
+        if (!bio) {
+            throw std::runtime_error("Failed to open key file " + keyFile);
+        }
+        pkey_.reset(PEM_read_bio_PrivateKey(bio, nullptr, nullptr, nullptr));
+        BIO_free(bio);
+        if (!pkey_ || EVP_PKEY_get_base_id(pkey_.get()) != EVP_PKEY_RSA) {
+            throw std::runtime_error("Key file " + keyFile + " does not contain an RSA private key");
+        }
+        logMessage("Loaded server key pair from " + keyFile, LOG_INFO);
+    } else {
+        generate();
+        save(keyFile);
+        logMessage("Generated a new server key pair and saved it to " + keyFile, LOG_INFO);
+    }
+    publicKeyDER_ = encodePublicKeyDER();
+}
+
+// Writes the private key to a new file that only the owner can read. The file is created with
+// those permissions, so the key is never readable by other users, not even briefly.
+void RSAKeyPair::save(const std::string& keyFile) const {
+#ifdef _WIN32
+    BIO* bio = BIO_new_file(keyFile.c_str(), "wb");
+#else
+    int fd = open(keyFile.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd == -1) {
+        throw std::runtime_error("Failed to create key file " + keyFile + ": " + strerror(errno));
+    }
+    BIO* bio = BIO_new_fd(fd, BIO_CLOSE);
+    if (!bio) {
+        close(fd);
+    }
+#endif
+    bool written = bio && PEM_write_bio_PrivateKey(bio, pkey_.get(), nullptr, nullptr, 0, nullptr, nullptr) == 1 && BIO_flush(bio) == 1;
+    BIO_free(bio);
+    if (!written) {
+        std::error_code error;
+        std::filesystem::remove(keyFile, error);
+        throw std::runtime_error("Failed to save the server key pair to " + keyFile);
+    }
+}
+
+void RSAKeyPair::generate() {
     /// Generate RSA key using EVP_PKEY_Q_keygen
     // Parameters:
     // libctx = NULL (default library context)
@@ -33,7 +94,7 @@ EVP_PKEY* RSAKeyPair::getPublicKey() const {
     return pkey_.get();
 }
 
-std::vector<uint8_t> RSAKeyPair::getPublicKeyDER() const {
+std::vector<uint8_t> RSAKeyPair::encodePublicKeyDER() const {
     std::vector<uint8_t> der;
 
     // Create a memory BIO to hold the DER-encoded public key
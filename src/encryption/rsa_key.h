@@ -2,25 +2,37 @@
 #define RSA_KEY_H
 
 #include <memory>
+#include <string>
 #include <vector>
 #include <openssl/evp.h>
 
+// The server's login key pair. A single instance is shared by every connection;
+// decrypt() may be called from several threads at once.
 class RSAKeyPair {
 public:
+    // Generates a new 2048-bit key pair
     RSAKeyPair();
+    // Loads the private key from a PEM file, or generates one and saves it there if the file does not exist
+    explicit RSAKeyPair(const std::string& keyFile);
     ~RSAKeyPair();
 
     EVP_PKEY *getPublicKey() const;
 
     // Returns the public key in DER format
-    std::vector<uint8_t> getPublicKeyDER() const;
+    const std::vector<uint8_t>& getPublicKeyDER() const { return publicKeyDER_; }
 
     // Decrypts data using the private key
     std::vector<uint8_t> decrypt(const std::vector<uint8_t>& encryptedData) const;
 
 private:
+    void generate();
+    // Throws if the key can't be written
+    void save(const std::string& keyFile) const;
+    std::vector<uint8_t> encodePublicKeyDER() const;
+
     // Using EVP_PKEY for better abstraction
     std::unique_ptr<EVP_PKEY, decltype(&EVP_PKEY_free)> pkey_;
+    std::vector<uint8_t> publicKeyDER_;
 };
 
 #endif //RSA_KEY_H
@@ -7,6 +7,7 @@
 
 #include "equipment.h"
 #include "data/data.h"
+#include "utils/timer_wheel.h"
 
 // TODO: Replace with actual entity types
 enum class EntityType : int32_t {
@@ -48,8 +49,9 @@ struct MiningProgress {
     int8_t currentStage;
     Position blockPos;
     int32_t sequence;
+    TimerId stageTimer; // Moves it to the next destroy stage
 
-    MiningProgress() : totalTime(0), currentStage(0), sequence(0) {}
+    MiningProgress() : totalTime(0), currentStage(0), sequence(0), stageTimer(0) {}
 };
 
 struct Attribute {
@@ -3,6 +3,7 @@
 #include <functional>
 
 #include "entity.h"
+#include "core/server.h"
 #include "networking/clientbound_packets.h"
 
 int32_t EntityManager::generateUniqueEntityID() {
@@ -22,7 +23,8 @@ void EntityManager::removeEntity(const std::string& uuidString) {
     auto it = uuidToEntityID.find(uuidString);
     if (it != uuidToEntityID.end()) {
         int32_t entityID = it->second;
-        sendRemoveEntityPacket(entityID);
+        entitySync.forget(entityID);
+        entityTracker.remove(entityID);
         entitiesByID.erase(entityID);
         uuidToEntityID.erase(it);
     }
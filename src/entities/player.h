@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "world/chunk.h"
+#include "networking/chunk_sender.h"
 #include "networking/client.h"
 #include "entity.h"
 #include "core/utils.h"
@@ -25,7 +26,8 @@ struct Player : Entity {
     uint8_t flags; // Bitfield for player states
     ClientConnection* client;
     std::unordered_set<ChunkCoordinates> currentViewedChunks;
-    std::unordered_set<ChunkCoordinates> loadedChunks;
+    std::unordered_set<ChunkCoordinates> loadedChunks; // Guarded by chunkQueue.mutex
+    ChunkSendQueue chunkQueue;
     int viewDistance;
     uint8_t activeSlot = 0;
     std::shared_ptr<PlayerInventory> inventory;
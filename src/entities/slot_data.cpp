@@ -1,18 +1,16 @@
 #include "slot_data.h"
 
-#include "networking/network.h"
+#include "networking/packet_reader.h"
 
-Component parseComponent(const std::vector<uint8_t>& data, size_t& index) {
+Component parseComponent(PacketReader& reader) {
     Component component;
-    size_t typeVarInt = parseVarInt(data, index);
+    size_t typeVarInt = reader.readVarInt();
     component.type = static_cast<ComponentType>(typeVarInt);
 
     // TODO: Parse component data based on type
     // Placeholder: Read a VarInt indicating data length followed by data
-    size_t dataLength = parseVarInt(data, index);
-    std::vector componentData(data.begin() + index, data.begin() + index + dataLength);
-    component.data = componentData;
-    index += dataLength;
+    std::span<const uint8_t> componentData = reader.readByteArray(reader.remaining());
+    component.data = std::vector(componentData.begin(), componentData.end());
 
     return component;
 }
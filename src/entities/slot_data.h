@@ -5,6 +5,8 @@
 #include <variant>
 #include <vector>
 
+class PacketReader;
+
 enum class ComponentType : size_t {
     CustomData = 0,
     MaxStackSize = 1,
@@ -83,6 +85,6 @@ struct SlotData {
     std::optional<std::vector<ComponentType>> compsToRemove;
 };
 
-Component parseComponent(const std::vector<uint8_t>& data, size_t& index);
+Component parseComponent(PacketReader& reader);
 
 #endif //SLOT_DATA_H
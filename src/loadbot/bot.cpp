@@ -0,0 +1,417 @@
+#include "bot.h"
+
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/tcp.h>
+#include <random>
+#include <unistd.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <openssl/rsa.h>
+#include <openssl/x509.h>
+
+#include "core/utils.h"
+#include "enums/enums.h"
+#include "networking/packet_ids.h"
+#include "networking/packet_reader.h"
+#include "networking/packet_writer.h"
+
+constexpr int32_t PROTOCOL_VERSION = 767; // 1.21.1
+constexpr size_t RECEIVE_CHUNK_SIZE = 65536;
+constexpr size_t MAX_PUBLIC_KEY_LENGTH = 1024;
+constexpr size_t MAX_VERIFY_TOKEN_LENGTH = 256;
+constexpr double WALK_RADIUS = 8.0;  // Blocks
+constexpr double WALK_SPEED = 0.2;   // Blocks per tick, a little slower than sprinting
+constexpr int32_t RESOURCE_PACK_LOADED = 0;
+
+// Encrypts data with the server's public key, the way the client does for the shared secret and the verify token
+static bool rsaEncrypt(EVP_PKEY* publicKey, std::span<const uint8_t> data, std::vector<uint8_t>& out) {
+    EVP_PKEY_CTX* ctx = EVP_PKEY_CTX_new(publicKey, nullptr);
+    size_t outLength = 0;
+    bool success = ctx && EVP_PKEY_encrypt_init(ctx) == 1 && EVP_PKEY_CTX_set_rsa_padding(ctx, RSA_PKCS1_PADDING) == 1 &&
+                   EVP_PKEY_encrypt(ctx, nullptr, &outLength, data.data(), data.size()) == 1;
+    if (success) {
+        out.resize(outLength);
+        success = EVP_PKEY_encrypt(ctx, out.data(), &outLength, data.data(), data.size()) == 1;
+        out.resize(outLength);
+    }
+    EVP_PKEY_CTX_free(ctx);
+    return success;
+}
+
+Bot::Bot(std::string name, const BotScript& script, LoadStats& stats) : name(std::move(name)), script(script), stats(stats) {}
+
+Bot::~Bot() {
+    if (sock != INVALID_SOCKET) {
+        ::close(sock);
+    }
+    EVP_CIPHER_CTX_free(encryptCtx);
+    EVP_CIPHER_CTX_free(decryptCtx);
+}
+
+bool Bot::connect(const sockaddr_in& address, const std::string& host, const uint16_t port) {
+    connectedAt = std::chrono::steady_clock::now();
+    sock = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (sock == INVALID_SOCKET || ::connect(sock, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        close("Failed to connect: " + std::string(strerror(errno)));
+        return false;
+    }
+    int noDelay = 1;
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+
+    PacketWriter handshake(HANDSHAKE);
+    writeVarInt(handshake.buffer(), PROTOCOL_VERSION);
+    writeString(handshake.buffer(), host);
+    writeShort(handshake.buffer(), static_cast<int16_t>(port));
+    writeVarInt(handshake.buffer(), 2); // Next State: Login
+    send(handshake);
+
+    PacketWriter loginStart(LOGIN_START);
+    writeString(loginStart.buffer(), name);
+    std::array<uint8_t, 16> uuid = generateUUID();
+    loginStart.buffer().insert(loginStart.buffer().end(), uuid.begin(), uuid.end());
+    send(loginStart);
+
+    flush();
+    return currentState != BotState::Closed;
+}
+
+void Bot::receive() {
+    while (currentState != BotState::Closed) {
+        std::span<uint8_t> space = inbound.writableSpan(RECEIVE_CHUNK_SIZE);
+        ssize_t bytesRead = recv(sock, space.data(), space.size(), 0);
+        if (bytesRead == 0) {
+            close("Connection closed by the server");
+            return;
+        }
+        if (bytesRead < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                close("Failed to receive: " + std::string(strerror(errno)));
+            }
+            return;
+        }
+        inbound.commit(bytesRead);
+        stats.bytesReceived.fetch_add(bytesRead, std::memory_order_relaxed);
+
+        // Same framing as the server's extractPacket, the cipher may be switched on between two frames
+        while (currentState != BotState::Closed) {
+            if (decryptCtx && !inbound.decrypt(decryptCtx)) {
+                close("Failed to decrypt");
+                return;
+            }
+            std::span<const uint8_t> frame;
+            PacketReadResult result = inbound.nextFrame(frame);
+            if (result == PacketReadResult::Incomplete) {
+                break;
+            }
+            if (result == PacketReadResult::Error) {
+                close("Malformed frame");
+                return;
+            }
+
+            try {
+                std::span<const uint8_t> packet = frame;
+                if (compressionThreshold >= 0) {
+                    PacketReader header(frame);
+                    int32_t dataLength = header.readVarInt();
+                    packet = header.readRemaining();
+                    if (dataLength != 0) {
+                        decompressData(packet, dataLength, scratch);
+                        packet = scratch;
+                    }
+                }
+
+                PacketReader reader(packet);
+                int32_t packetID = reader.readVarInt();
+                stats.packetsReceived.fetch_add(1, std::memory_order_relaxed);
+                switch (currentState) {
+                    case BotState::Login:
+                        handleLoginPacket(packetID, reader);
+                        break;
+                    case BotState::Configuration:
+                        handleConfigurationPacket(packetID, reader);
+                        break;
+                    case BotState::Play:
+                        handlePlayPacket(packetID, reader);
+                        break;
+                    case BotState::Closed:
+                        break;
+                }
+            } catch (const std::exception& e) {
+                close("Bad packet: " + std::string(e.what()));
+                return;
+            }
+        }
+    }
+}
+
+void Bot::handleLoginPacket(const int32_t packetID, PacketReader& reader) {
+    switch (packetID) {
+        case DISCONNECT:
+            close("Disconnected during login: " + std::string(reader.readString()));
+            return;
+        case ENCRYPTION_REQUEST:
+            handleEncryptionRequest(reader);
+            return;
+        case LOGIN_SUCCESS: {
+            PacketWriter acknowledge(LOGIN_ACKNOWLEDGE);
+            send(acknowledge);
+            currentState = BotState::Configuration;
+
+            PacketWriter information(CLIENT_INFORMATION);
+            std::vector<uint8_t>& data = information.buffer();
+            writeString(data, "en_us");
+            writeByte(data, 12); // View Distance
+            writeVarInt(data, 0);    // Chat Mode: enabled
+            writeByte(data, 1);      // Chat Colors
+            writeUByte(data, 0x7F);  // Displayed Skin Parts
+            writeVarInt(data, 1);    // Main Hand: right
+            writeByte(data, 0);      // Enable Text Filtering
+            writeByte(data, 1);      // Allow Server Listings
+            send(information);
+            return;
+        }
+        case SET_COMPRESSION:
+            compressionThreshold = reader.readVarInt();
+            return;
+        default:
+            return;
+    }
+}
+
+void Bot::handleEncryptionRequest(PacketReader& reader) {
+    reader.readString(20); // Server ID
+    std::span<const uint8_t> publicKeyDER = reader.readByteArray(MAX_PUBLIC_KEY_LENGTH);
+    std::span<const uint8_t> verifyToken = reader.readByteArray(MAX_VERIFY_TOKEN_LENGTH);
+    if (reader.readBool()) {
+        close("The server is in online mode, bots can only join with online_mode off");
+        return;
+    }
+
+    std::array<uint8_t, 16> sharedSecret{};
+    if (RAND_bytes(sharedSecret.data(), sharedSecret.size()) != 1) {
+        close("Failed to generate a shared secret");
+        return;
+    }
+
+    const unsigned char* keyData = publicKeyDER.data();
+    EVP_PKEY* publicKey = d2i_PUBKEY(nullptr, &keyData, static_cast<long>(publicKeyDER.size()));
+    std::vector<uint8_t> encryptedSecret;
+    std::vector<uint8_t> encryptedToken;
+    bool encrypted = publicKey && rsaEncrypt(publicKey, sharedSecret, encryptedSecret) && rsaEncrypt(publicKey, verifyToken, encryptedToken);
+    EVP_PKEY_free(publicKey);
+    if (!encrypted) {
+        close("Failed to encrypt the shared secret");
+        return;
+    }
+
+    // The response is the last packet sent in the clear
+    PacketWriter response(ENCRYPTION_RESPONSE);
+    writeVarInt(response.buffer(), static_cast<int32_t>(encryptedSecret.size()));
+    writeBytes(response.buffer(), encryptedSecret);
+    writeVarInt(response.buffer(), static_cast<int32_t>(encryptedToken.size()));
+    writeBytes(response.buffer(), encryptedToken);
+    send(response);
+
+    encryptCtx = EVP_CIPHER_CTX_new();
+    decryptCtx = EVP_CIPHER_CTX_new();
+    if (!encryptCtx || !decryptCtx ||
+        EVP_EncryptInit_ex(encryptCtx, EVP_aes_128_cfb8(), nullptr, sharedSecret.data(), sharedSecret.data()) != 1 ||
+        EVP_DecryptInit_ex(decryptCtx, EVP_aes_128_cfb8(), nullptr, sharedSecret.data(), sharedSecret.data()) != 1) {
+        close("Failed to set up encryption");
+    }
+}
+
+void Bot::handleConfigurationPacket(const int32_t packetID, PacketReader& reader) {
+    switch (packetID) {
+        case DISCONNECT_CONFIG:
+            close("Disconnected during configuration");
+            return;
+        case FINISH_CONFIGURATION: {
+            PacketWriter acknowledge(ACKNOWLEDGE_FINISH_CONFIGURATION);
+            send(acknowledge);
+            currentState = BotState::Play;
+            return;
+        }
+        case KEEP_ALIVE_CONFIG: {
+            PacketWriter keepAlive(SERVERBOUND_KEEP_ALIVE_CONFIG);
+            writeLong(keepAlive.buffer(), reader.readLong());
+            send(keepAlive);
+            return;
+        }
+        case PING_CONFIG: {
+            PacketWriter pong(PONG_CONFIG);
+            writeInt(pong.buffer(), reader.readInt());
+            send(pong);
+            return;
+        }
+        case CLIENTBOUND_KNOWN_PACKS: {
+            // Claim to know every pack the server offers
+            PacketWriter knownPacks(SERVERBOUND_KNOWN_PACKS);
+            std::span<const uint8_t> packs = reader.readRemaining();
+            knownPacks.buffer().insert(knownPacks.buffer().end(), packs.begin(), packs.end());
+            send(knownPacks);
+            return;
+        }
+        default:
+            return;
+    }
+}
+
+void Bot::handlePlayPacket(const int32_t packetID, PacketReader& reader) {
+    switch (packetID) {
+        case DISCONNECT_PLAY:
+            close("Disconnected by the server");
+            return;
+        case KEEP_ALIVE_PLAY: {
+            PacketWriter keepAlive(SERVERBOUND_KEEP_ALIVE);
+            writeLong(keepAlive.buffer(), reader.readLong());
+            send(keepAlive);
+            return;
+        }
+        case PING_PLAY: {
+            PacketWriter pong(PONG_PLAY);
+            writeInt(pong.buffer(), reader.readInt());
+            send(pong);
+            return;
+        }
+        case SYNCHRONIZE_PLAYER_POSITION:
+            handleSynchronizePosition(reader);
+            return;
+        case CHUNK_DATA:
+            stats.chunksReceived.fetch_add(1, std::memory_order_relaxed);
+            return;
+        case CHUNK_BATCH_FINISHED: {
+            PacketWriter received(CHUNK_BATCH_RECEIVED);
+            writeFloat(received.buffer(), script.chunksPerTick);
+            send(received);
+            return;
+        }
+        case ADD_RESOURCE_PACK_PLAY: {
+            PacketWriter response(RESOURCE_PACK_RESPONSE_PLAY);
+            std::span<const uint8_t> uuid = reader.readBytes(16);
+            response.buffer().insert(response.buffer().end(), uuid.begin(), uuid.end());
+            writeVarInt(response.buffer(), RESOURCE_PACK_LOADED);
+            send(response);
+            return;
+        }
+        default:
+            return;
+    }
+}
+
+void Bot::handleSynchronizePosition(PacketReader& reader) {
+    double newX = reader.readDouble();
+    double newY = reader.readDouble();
+    double newZ = reader.readDouble();
+    reader.readFloat(); // Yaw
+    reader.readFloat(); // Pitch
+    uint8_t flags = reader.readByte();
+    int32_t teleportID = reader.readVarInt();
+
+    x = (flags & 0x01 ? x : 0) + newX;
+    y = (flags & 0x02 ? y : 0) + newY;
+    z = (flags & 0x04 ? z : 0) + newZ;
+    // Walk the circle that starts where the server put us
+    centerX = x - WALK_RADIUS * std::cos(walkAngle);
+    centerZ = z - WALK_RADIUS * std::sin(walkAngle);
+
+    PacketWriter confirm(ZERO_PACKET); // Confirm Teleportation
+    writeVarInt(confirm.buffer(), teleportID);
+    send(confirm);
+
+    if (spawned) {
+        return;
+    }
+    spawned = true;
+    auto now = std::chrono::steady_clock::now();
+    nextDig = now + script.digInterval;
+    nextChat = now + script.chatInterval;
+    stats.joined.fetch_add(1, std::memory_order_relaxed);
+    std::lock_guard lock(stats.latencyMutex);
+    stats.joinLatencies.push_back(std::chrono::duration<double, std::milli>(now - connectedAt).count());
+}
+
+void Bot::tick(const std::chrono::steady_clock::time_point now) {
+    if (currentState != BotState::Play || !spawned) {
+        return;
+    }
+
+    if (script.move) {
+        walkAngle += WALK_SPEED / WALK_RADIUS;
+        x = centerX + WALK_RADIUS * std::cos(walkAngle);
+        z = centerZ + WALK_RADIUS * std::sin(walkAngle);
+        PacketWriter position(PLAYER_POSITION);
+        writeDouble(position.buffer(), x);
+        writeDouble(position.buffer(), y);
+        writeDouble(position.buffer(), z);
+        writeByte(position.buffer(), 1); // On Ground
+        send(position);
+    }
+
+    if (script.digInterval.count() > 0 && now >= nextDig) {
+        nextDig += script.digInterval;
+        // The block under the one ahead of us, from the top
+        PacketWriter action(PLAYER_ACTION);
+        writeVarInt(action.buffer(), STARTED_DIGGING);
+        writeLong(action.buffer(), static_cast<int64_t>(encodePosition(static_cast<int32_t>(std::floor(x)) + 1, static_cast<int32_t>(std::floor(y)) - 1, static_cast<int32_t>(std::floor(z)))));
+        writeByte(action.buffer(), 1); // Face: top
+        writeVarInt(action.buffer(), ++digSequence);
+        send(action);
+    }
+
+    if (script.chatInterval.count() > 0 && now >= nextChat) {
+        nextChat += script.chatInterval;
+        static thread_local std::mt19937_64 random(std::random_device{}());
+        PacketWriter chat(CHAT_MESSAGE);
+        std::vector<uint8_t>& data = chat.buffer();
+        writeString(data, name + " says hello #" + std::to_string(++chatMessages));
+        writeLong(data, std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+        writeLong(data, static_cast<int64_t>(random())); // Salt
+        writeByte(data, 0);   // Has Signature
+        writeVarInt(data, 0); // Message Count
+        data.insert(data.end(), 3, 0); // Acknowledged (Fixed BitSet of 20 bits)
+        send(chat);
+    }
+}
+
+void Bot::send(PacketWriter& writer) {
+    if (currentState == BotState::Closed) {
+        return;
+    }
+    std::span<const uint8_t> payload = writer.payload();
+    if (compressionThreshold >= 0 && payload.size() >= static_cast<size_t>(compressionThreshold)) {
+        PooledBuffer compressed;
+        compressData(payload, *compressed, PacketWriter::HEADROOM);
+        outbound.write(finishFrame(*compressed, static_cast<int32_t>(payload.size())), encryptCtx);
+    } else {
+        outbound.write(writer.frame(compressionThreshold >= 0), encryptCtx);
+    }
+    stats.packetsSent.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Bot::flush() {
+    if (currentState != BotState::Closed && !outbound.empty() && !outbound.flush(sock)) {
+        close("Failed to send: " + std::string(strerror(errno)));
+    }
+}
+
+void Bot::close(const std::string& reason) {
+    if (currentState == BotState::Closed) {
+        return;
+    }
+    if (!spawned) {
+        stats.failed.fetch_add(1, std::memory_order_relaxed);
+        logMessage(name + " failed to join: " + reason, LOG_ERROR);
+    } else {
+        logMessage(name + " left: " + reason, LOG_WARNING);
+    }
+    currentState = BotState::Closed;
+    if (sock != INVALID_SOCKET) {
+        ::close(sock);
+        sock = INVALID_SOCKET;
+    }
+}
@@ -0,0 +1,103 @@
+#ifndef BOT_H
+#define BOT_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <openssl/types.h>
+
+#include "networking/inbound_buffer.h"
+#include "networking/network.h"
+#include "networking/outbound_queue.h"
+
+class PacketReader;
+class PacketWriter;
+
+enum class BotState {
+    Login,
+    Configuration,
+    Play,
+    Closed
+};
+
+// What every bot does once it has spawned
+struct BotScript {
+    bool move = true;                            // Walk in a circle around the spawn point, one step per tick
+    std::chrono::milliseconds digInterval{0};    // Break the block in front of the bot, 0 to disable
+    std::chrono::milliseconds chatInterval{0};   // Send a chat message, 0 to disable
+    float chunksPerTick = 25.0f;                 // Answer to Chunk Batch Finished
+};
+
+// Totals of every bot, updated by the worker threads and read by the reporter
+struct LoadStats {
+    std::atomic<uint64_t> bytesReceived{0}; // Server to client, as read from the sockets
+    std::atomic<uint64_t> packetsReceived{0};
+    std::atomic<uint64_t> chunksReceived{0};
+    std::atomic<uint64_t> packetsSent{0};
+    std::atomic<int> joined{0};
+    std::atomic<int> failed{0};
+
+    std::mutex latencyMutex;
+    std::vector<double> joinLatencies; // Milliseconds from connect() to the first position sync
+};
+
+// One headless offline-mode client. Not thread-safe: each bot is driven by a single worker thread.
+class Bot {
+public:
+    Bot(std::string name, const BotScript& script, LoadStats& stats);
+    ~Bot();
+
+    Bot(const Bot&) = delete;
+    Bot& operator=(const Bot&) = delete;
+
+    // Connects and sends the Handshake and Login Start packets
+    bool connect(const sockaddr_in& address, const std::string& host, uint16_t port);
+    // Reads everything the socket has and answers it
+    void receive();
+    // Runs the scripted actions that are due, called once per game tick
+    void tick(std::chrono::steady_clock::time_point now);
+    // Writes as much of the outbound queue as the socket takes
+    void flush();
+
+    SocketType socket() const { return sock; }
+    BotState state() const { return currentState; }
+    bool wantsWrite() const { return !outbound.empty(); }
+
+private:
+    void handleLoginPacket(int32_t packetID, PacketReader& reader);
+    void handleConfigurationPacket(int32_t packetID, PacketReader& reader);
+    void handlePlayPacket(int32_t packetID, PacketReader& reader);
+    void handleEncryptionRequest(PacketReader& reader);
+    void handleSynchronizePosition(PacketReader& reader);
+
+    void send(PacketWriter& writer);
+    void close(const std::string& reason);
+
+    std::string name;
+    const BotScript& script;
+    LoadStats& stats;
+
+    SocketType sock = INVALID_SOCKET;
+    BotState currentState = BotState::Login;
+    InboundBuffer inbound;
+    OutboundQueue outbound;
+    std::vector<uint8_t> scratch; // Inflated packets
+    EVP_CIPHER_CTX* encryptCtx = nullptr;
+    EVP_CIPHER_CTX* decryptCtx = nullptr;
+    int32_t compressionThreshold = -1; // -1 until Set Compression
+
+    std::chrono::steady_clock::time_point connectedAt;
+    std::chrono::steady_clock::time_point nextDig;
+    std::chrono::steady_clock::time_point nextChat;
+    bool spawned = false;
+    double x = 0, y = 0, z = 0;
+    double centerX = 0, centerZ = 0;
+    double walkAngle = 0;
+    int32_t digSequence = 0;
+    uint64_t chatMessages = 0;
+};
+
+#endif //BOT_H
@@ -0,0 +1,248 @@
+// MCppServerLoadBot: headless protocol bots for benchmarking the server on one Linux box.
+// Opens N offline-mode connections, takes each through login, configuration and play, then walks,
+// digs and chats on a script while reporting join latency, chunk throughput and bandwidth.
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <netdb.h>
+#include <poll.h>
+#include <sstream>
+#include <thread>
+
+#include "bot.h"
+
+constexpr auto TICK_INTERVAL = std::chrono::milliseconds(50);
+
+struct LoadOptions {
+    std::string host = "127.0.0.1";
+    uint16_t port = 25565;
+    int bots = 10;
+    int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::chrono::seconds duration{60};
+    std::chrono::milliseconds joinInterval{50}; // Between two connection attempts
+    std::chrono::seconds reportInterval{5};
+    BotScript script;
+};
+
+static std::atomic<bool> stopRequested{false};
+
+static void printUsage() {
+    std::cout << "Usage: MCppServerLoadBot [options]\n"
+                 "  --host <address>        Server address (127.0.0.1)\n"
+                 "  --port <port>           Server port (25565)\n"
+                 "  --bots <count>          Connections to open (10)\n"
+                 "  --threads <count>       Worker threads driving the bots (one per core)\n"
+                 "  --duration <seconds>    How long to run after the first connection (60)\n"
+                 "  --join-interval <ms>    Delay between two connections (50)\n"
+                 "  --report-interval <s>   Delay between two progress lines (5)\n"
+                 "  --no-move               Stand still instead of walking in circles\n"
+                 "  --dig-interval <ms>     Break a block this often, 0 to disable (0)\n"
+                 "  --chat-interval <ms>    Send a chat message this often, 0 to disable (0)\n"
+                 "  --chunks-per-tick <n>   Answer to Chunk Batch Finished (25)\n";
+}
+
+static bool parseOptions(int argc, char* argv[], LoadOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string option = argv[i];
+        if (option == "--help" || option == "-h") {
+            return false;
+        }
+        if (option == "--no-move") {
+            options.script.move = false;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << option << "\n";
+            return false;
+        }
+        std::string value = argv[++i];
+        try {
+            if (option == "--host") {
+                options.host = value;
+            } else if (option == "--port") {
+                options.port = static_cast<uint16_t>(std::stoi(value));
+            } else if (option == "--bots") {
+                options.bots = std::max(1, std::stoi(value));
+            } else if (option == "--threads") {
+                options.threads = std::max(1, std::stoi(value));
+            } else if (option == "--duration") {
+                options.duration = std::chrono::seconds(std::max(1, std::stoi(value)));
+            } else if (option == "--join-interval") {
+                options.joinInterval = std::chrono::milliseconds(std::max(0, std::stoi(value)));
+            } else if (option == "--report-interval") {
+                options.reportInterval = std::chrono::seconds(std::max(1, std::stoi(value)));
+            } else if (option == "--dig-interval") {
+                options.script.digInterval = std::chrono::milliseconds(std::max(0, std::stoi(value)));
+            } else if (option == "--chat-interval") {
+                options.script.chatInterval = std::chrono::milliseconds(std::max(0, std::stoi(value)));
+            } else if (option == "--chunks-per-tick") {
+                options.script.chunksPerTick = std::max(0.01f, std::stof(value));
+            } else {
+                std::cerr << "Unknown option " << option << "\n";
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value for " << option << ": " << value << "\n";
+            return false;
+        }
+    }
+    options.threads = std::min(options.threads, options.bots);
+    return true;
+}
+
+static bool resolve(const std::string& host, uint16_t port, sockaddr_in& address) {
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host.c_str(), nullptr, &hints, &result) != 0 || !result) {
+        return false;
+    }
+    address = *reinterpret_cast<sockaddr_in*>(result->ai_addr);
+    address.sin_port = htons(port);
+    freeaddrinfo(result);
+    return true;
+}
+
+// Drives every worker'th bot: connects them on their turn, polls their sockets and ticks their scripts
+static void runWorker(const int worker, const LoadOptions& options, const sockaddr_in& address, LoadStats& stats,
+                      const std::chrono::steady_clock::time_point start, const std::chrono::steady_clock::time_point deadline) {
+    struct Slot {
+        std::unique_ptr<Bot> bot;
+        std::chrono::steady_clock::time_point connectAt;
+    };
+    std::vector<Slot> slots;
+    for (int index = worker; index < options.bots; index += options.threads) {
+        slots.push_back({std::make_unique<Bot>("Bot" + std::to_string(index), options.script, stats), start + options.joinInterval * index});
+    }
+
+    std::vector<pollfd> pollFds;
+    std::vector<Bot*> polled;
+    auto nextTick = start;
+    while (!stopRequested.load(std::memory_order_relaxed)) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            break;
+        }
+
+        pollFds.clear();
+        polled.clear();
+        for (Slot& slot : slots) {
+            if (slot.connectAt <= now && slot.bot->socket() == INVALID_SOCKET && slot.bot->state() == BotState::Login) {
+                slot.bot->connect(address, options.host, options.port);
+            }
+            if (slot.bot->socket() != INVALID_SOCKET) {
+                pollFds.push_back({slot.bot->socket(), static_cast<short>(POLLIN | (slot.bot->wantsWrite() ? POLLOUT : 0)), 0});
+                polled.push_back(slot.bot.get());
+            }
+        }
+
+        auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(nextTick - now).count();
+        if (poll(pollFds.data(), pollFds.size(), static_cast<int>(std::max<int64_t>(timeout, 0))) < 0 && errno != EINTR) {
+            break;
+        }
+        for (size_t i = 0; i < pollFds.size(); i++) {
+            if (pollFds[i].revents & (POLLIN | POLLERR | POLLHUP)) {
+                polled[i]->receive();
+            }
+        }
+
+        now = std::chrono::steady_clock::now();
+        if (now >= nextTick) {
+            for (Slot& slot : slots) {
+                slot.bot->tick(now);
+            }
+            nextTick += TICK_INTERVAL;
+            if (nextTick < now) {
+                nextTick = now + TICK_INTERVAL; // Don't try to catch up after a stall
+            }
+        }
+        for (Bot* bot : polled) {
+            bot->flush();
+        }
+    }
+}
+
+static double percentile(const std::vector<double>& sorted, const double fraction) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    auto index = static_cast<size_t>(fraction * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+static std::string formatJoinLatencies(LoadStats& stats) {
+    std::vector<double> latencies;
+    {
+        std::lock_guard lock(stats.latencyMutex);
+        latencies = stats.joinLatencies;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    std::stringstream out;
+    out << std::fixed << std::setprecision(1) << "join latency ms p50 " << percentile(latencies, 0.5) << " p90 " << percentile(latencies, 0.9)
+        << " p99 " << percentile(latencies, 0.99) << " max " << (latencies.empty() ? 0.0 : latencies.back());
+    return out.str();
+}
+
+int main(int argc, char* argv[]) {
+    LoadOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+    sockaddr_in address{};
+    if (!resolve(options.host, options.port, address)) {
+        std::cerr << "Could not resolve " << options.host << "\n";
+        return 1;
+    }
+    std::signal(SIGINT, [](int) { stopRequested = true; });
+    std::signal(SIGPIPE, SIG_IGN);
+
+    LoadStats stats;
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + options.duration;
+    std::vector<std::thread> workers;
+    for (int worker = 0; worker < options.threads; worker++) {
+        workers.emplace_back(runWorker, worker, std::cref(options), std::cref(address), std::ref(stats), start, deadline);
+    }
+
+    // Progress every report interval, rates over the last interval
+    uint64_t lastBytes = 0;
+    uint64_t lastChunks = 0;
+    auto lastReport = start;
+    while (!stopRequested && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_until(std::min(lastReport + options.reportInterval, deadline));
+        auto now = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(now - lastReport).count();
+        uint64_t bytes = stats.bytesReceived.load();
+        uint64_t chunks = stats.chunksReceived.load();
+        std::stringstream line;
+        line << std::fixed << std::setprecision(1) << "[" << std::chrono::duration<double>(now - start).count() << "s] joined "
+             << stats.joined.load() << "/" << options.bots << ", failed " << stats.failed.load() << ", "
+             << (chunks - lastChunks) / seconds << " chunks/s, " << (bytes - lastBytes) / seconds / 1048576.0 << " MiB/s down, "
+             << formatJoinLatencies(stats);
+        std::cout << line.str() << std::endl;
+        lastBytes = bytes;
+        lastChunks = chunks;
+        lastReport = now;
+    }
+    stopRequested = true;
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::fixed << std::setprecision(1)
+              << "Summary after " << elapsed << "s:\n"
+              << "  bots joined:   " << stats.joined.load() << "/" << options.bots << " (" << stats.failed.load() << " failed)\n"
+              << "  " << formatJoinLatencies(stats) << "\n"
+              << "  chunks:        " << stats.chunksReceived.load() << " (" << stats.chunksReceived.load() / elapsed << "/s)\n"
+              << "  server->client " << stats.bytesReceived.load() / 1048576.0 << " MiB (" << stats.bytesReceived.load() / elapsed / 1048576.0
+              << " MiB/s), " << stats.packetsReceived.load() << " packets\n"
+              << "  client->server " << stats.packetsSent.load() << " packets" << std::endl;
+    return stats.joined.load() > 0 ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+#include "chunk_sender.h"
+
+#include <algorithm>
+#include <cmath>
+#include <ranges>
+
+#include "client.h"
+#include "packet_ids.h"
+#include "packet_writer.h"
+#include "shared_frame.h"
+#include "core/config.h"
+#include "core/server.h"
+#include "entities/player.h"
+
+// Bounds of the rate a client may ask for, as on vanilla
+constexpr float MIN_CHUNKS_PER_TICK = 0.01f;
+constexpr float MAX_CHUNKS_PER_TICK = 64.0f;
+constexpr int MAX_UNACKNOWLEDGED_BATCHES = 10;
+// Chunks still loading that a batch looks past before it settles for what is ready
+constexpr size_t MAX_LOADING_LOOKAHEAD = 32;
+
+// The client's view distance capped by the server's, or the server's if the client never sent one
+static int getViewDistance(const Player& player) {
+    if (player.viewDistance <= 0) {
+        return serverConfig.viewDistance;
+    }
+    return std::min(player.viewDistance, serverConfig.viewDistance);
+}
+
+void queueChunksInView(Player& player) {
+    std::vector<ChunkCoordinates> chunks = getChunksInView(player.currentChunkX, player.currentChunkZ, getViewDistance(player));
+
+    ChunkSendQueue& queue = player.chunkQueue;
+    std::lock_guard lock(queue.mutex);
+    queue.pending.clear();
+    for (const ChunkCoordinates& coords : chunks) {
+        if (!player.loadedChunks.contains(coords)) {
+            queue.pending.push_back(coords);
+        }
+    }
+}
+
+void handleChunkBatchReceived(Player& player, float desiredChunksPerTick) {
+    ChunkSendQueue& queue = player.chunkQueue;
+    std::lock_guard lock(queue.mutex);
+    queue.unacknowledgedBatches = std::max(queue.unacknowledgedBatches - 1, 0);
+    queue.desiredChunksPerTick = std::isnan(desiredChunksPerTick) ? MIN_CHUNKS_PER_TICK : std::clamp(desiredChunksPerTick, MIN_CHUNKS_PER_TICK, MAX_CHUNKS_PER_TICK);
+    if (queue.unacknowledgedBatches == 0) {
+        queue.batchQuota = 1.0f;
+    }
+    queue.maxUnacknowledgedBatches = MAX_UNACKNOWLEDGED_BATCHES;
+}
+
+static void sendChunkBatch(ClientConnection& client, Player& player) {
+    ChunkSendQueue& queue = player.chunkQueue;
+    std::vector<std::shared_ptr<const SharedFrame>> batch;
+    {
+        std::lock_guard lock(queue.mutex);
+        if (queue.pending.empty() || queue.unacknowledgedBatches >= queue.maxUnacknowledgedBatches) {
+            return;
+        }
+        queue.batchQuota = std::min(queue.batchQuota + queue.desiredChunksPerTick, std::max(1.0f, queue.desiredChunksPerTick));
+        if (queue.batchQuota < 1.0f) {
+            return;
+        }
+
+        // Nearest first, skipping chunks that are still being loaded or whose packet is still being
+        // built, so the tick thread never serializes or compresses a chunk itself
+        auto limit = static_cast<size_t>(queue.batchQuota);
+        size_t loading = 0;
+        for (auto it = queue.pending.begin(); it != queue.pending.end() && batch.size() < limit && loading < MAX_LOADING_LOOKAHEAD;) {
+            std::shared_ptr<const SharedFrame> packet;
+            if (!requestChunkPacket(it->chunkX, it->chunkZ, packet)) {
+                ++loading;
+                ++it;
+                continue;
+            }
+            player.loadedChunks.insert(*it);
+            it = queue.pending.erase(it);
+            if (packet) {
+                batch.push_back(std::move(packet));
+            }
+        }
+        if (batch.empty()) {
+            return;
+        }
+        queue.batchQuota -= static_cast<float>(batch.size());
+        queue.unacknowledgedBatches++;
+    }
+
+    PacketWriter start(CHUNK_BATCH_START);
+    sendPacket(client, start);
+    for (const std::shared_ptr<const SharedFrame>& packet : batch) {
+        sendPacket(client, packet);
+    }
+    PacketWriter finished(CHUNK_BATCH_FINISHED);
+    // Batch Size (VarInt)
+    writeVarInt(finished.buffer(), static_cast<int32_t>(batch.size()));
+    sendPacket(client, finished);
+}
+
+void sendChunkBatches() {
+    std::vector<std::shared_ptr<ClientConnection>> clients;
+    {
+        std::lock_guard lock(connectedClientsMutex);
+        clients.reserve(connectedClients.size());
+        for (ClientConnection* client : connectedClients | std::views::values) {
+            if (std::shared_ptr<ClientConnection> connection = client->weak_from_this().lock()) {
+                clients.push_back(std::move(connection));
+            }
+        }
+    }
+
+    for (const std::shared_ptr<ClientConnection>& client : clients) {
+        if (!client->connectionClosed && client->player) {
+            sendChunkBatch(*client, *client->player);
+        }
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef CHUNK_SENDER_H
+#define CHUNK_SENDER_H
+
+#include <deque>
+#include <mutex>
+
+#include "world/chunk.h"
+
+struct Player;
+
+// Per-player state of the chunk stream. Chunks are sent nearest-first in Chunk Batch Start /
+// Chunk Batch Finished pairs, and the client answers every batch with Chunk Batch Received and
+// the number of chunks per tick it can take, which becomes the player's send rate (as on vanilla).
+struct ChunkSendQueue {
+    std::mutex mutex;
+    std::deque<ChunkCoordinates> pending;  // Not sent yet, nearest first
+    float desiredChunksPerTick = 9.0f;     // What the client last asked for
+    float batchQuota = 0.0f;               // Chunks the next batch may hold, refilled every tick
+    int unacknowledgedBatches = 0;
+    int maxUnacknowledgedBatches = 1;      // Raised once the client answered its first batch
+};
+
+// Queues the chunks around the player's current chunk that it has not received yet, replacing
+// whatever was still pending from an earlier position
+void queueChunksInView(Player& player);
+// Chunk Batch Received
+void handleChunkBatchReceived(Player& player, float desiredChunksPerTick);
+// Sends the next batch to every player whose client has room for one. Called by the tick loop.
+void sendChunkBatches();
+
+#endif //CHUNK_SENDER_H
@@ -4,19 +4,24 @@
 #include "core/config.h"
 #include <iostream>
 #include <atomic>
+#include <cmath>
 #include <nlohmann/json.hpp>
 #include <nlohmann/json_fwd.hpp>
 #include <openssl/err.h>
+#include <openssl/evp.h>
 #include <openssl/rand.h>
 #include <openssl/x509.h>
 
 #include "world/chunk.h"
+#include "chunk_sender.h"
 #include "clientbound_packets.h"
 #include "commands/CommandBuilder.h"
 #include "registries/dimension_type.h"
 #include "enums/enums.h"
 #include "fetch.h"
+#include "packet_capture.h"
 #include "packet_ids.h"
+#include "packet_reader.h"
 #include "entities/player.h"
 #include "registries/registry_manager.h"
 #include "core/server.h"
@@ -26,22 +31,40 @@
 #include "inventories/crafting_table_inventory.h"
 #include "utils/translation.h"
 
+constexpr int KEEP_ALIVE_INTERVAL_SECONDS = 15;
+// Play packets a connection may have waiting for the tick thread, and the most handled per tick
+constexpr size_t MAX_INGEST_PACKETS = 4096;
+
 // TODO: Make sure EntityManager and connectedClients are thread-safe
 
-// Global player count
-std::atomic<int> playerCount(0);
+ClientConnection::~ClientConnection() {
+    if (encryptCtx) {
+        EVP_CIPHER_CTX_free(encryptCtx);
+    }
+    if (decryptCtx) {
+        EVP_CIPHER_CTX_free(decryptCtx);
+    }
+    if (socket != INVALID_SOCKET) {
+#ifdef _WIN32
+        closesocket(socket);
+#else
+        close(socket);
+#endif
+    }
+}
 
 // Function to disconnect client
 void disconnectClient(const std::shared_ptr<Player>& player, const std::string& reason, bool disconnectPacket) {
+    // Kicks and socket errors can race, only clean up once
+    if (player->client->disconnected.exchange(true)) {
+        return;
+    }
+    timerWheel.cancel(player->client->keepAliveTimer);
     if (disconnectPacket) {
         sendDisconnectionPacket(*player->client, reason);
         logMessage("Player " + player->name + " disconnected. Reason: " + reason, LOG_INFO);
-        // Close the socket
-#ifdef _WIN32
-        closesocket(player->client->socket);
-#else
-        close(player->client->socket);
-#endif
+        // Kicks come from the tick thread, the socket's I/O thread writes the packet and closes it
+        shutdownAfterFlush(*player->client);
     }
     player->client->connectionClosed = true;
     playersMutex.lock();
@@ -52,10 +75,11 @@ void disconnectClient(const std::shared_ptr<Player>& player, const std::string&
     connectedClientsMutex.lock();
     connectedClients.erase(player->uuidString);
     connectedClientsMutex.unlock();
+    serverStatus.invalidate();
 
     sendPlayerInfoRemove(player);
 
-    std::lock_guard lock(chunkMapMutex);
+    std::unique_lock lock(chunkViewersMutex);
     for (auto it = chunkViewersMap.begin(); it != chunkViewersMap.end(); )
     {
         // Remove the player from the vector
@@ -73,124 +97,47 @@ void disconnectClient(const std::shared_ptr<Player>& player, const std::string&
             ++it; // Just advance the iterator
         }
     }
+    lock.unlock();
+
+    // Stop sending entities to the player before the connection goes away
+    entityTracker.removeViewer(player);
 
     sendTranslatedChatMessage("multiplayer.player.left", false, "yellow", nullptr, true, player->name);
     entityManager.removeEntity(player->uuidString);
 }
 
-void handleStatusRequest(ClientConnection& client) {
-    // Read Status Request packet
-    std::vector<uint8_t> packetData;
-    // Read and respond to Ping packet
-    if (readUnencryptedPacket(client, packetData)) {
-        size_t index = 0;
-        int32_t packetID = parseVarInt(packetData, index);
-        if (packetID == STATUS_REQUEST) {
-            // Build JSON response using serverConfig
-            nlohmann::json responseJson = {
-                {"version", {{"name", serverConfig.server_version}, {"protocol", serverConfig.protocol_version}}},
-                {"players", {{"max", serverConfig.maxPlayers}, {"online", playerCount.load()}, {"sample", nlohmann::json::array()}}},
-                {"description", {{"text", serverConfig.motd}}}
-            };
-
-            // Add favicon if available
-            std::vector<uint8_t> faviconData = readFile(serverConfig.icon);
-            if (!faviconData.empty()) {
-                std::string faviconBase64 = base64Encode(faviconData);
-                responseJson["favicon"] = "data:image/png;base64," + faviconBase64;
-            }
-
-            std::string jsonResponse = responseJson.dump();
-
-            // Build response packet
-            std::vector<uint8_t> responseData;
-            responseData.push_back(STATUS_RESPONSE);
-            writeVarInt(responseData, static_cast<int32_t>(jsonResponse.size()));
-            responseData.insert(responseData.end(), jsonResponse.begin(), jsonResponse.end());
-
-            // Send response
-            sendUnencryptedPacket(client, responseData);
-
-            if (readPacketTimeout(client, packetData, 5000, true)) {
-                // Read Ping packet
-                index = 0;
-                packetID = parseVarInt(packetData, index);
-                if (packetID == PING_REQUEST) {
-                    // Ping packet
-                    std::vector<uint8_t> pongData;
-                    pongData.push_back(PONG_RESPONSE);
-                    pongData.insert(pongData.end(), packetData.begin() + index, packetData.end());
-                    sendUnencryptedPacket(client, pongData);
-                }
-            }
-        } else if (packetID == PING_REQUEST) {
-            // Ping packet
-            std::vector<uint8_t> pongData;
-            pongData.push_back(PONG_RESPONSE);
-            pongData.insert(pongData.end(), packetData.begin() + index, packetData.end());
-            sendUnencryptedPacket(client, pongData);
-        }
-    }
-}
-
-void startKeepAliveLoop(ClientConnection& client) {
-    // Send Keep Alive packets every 15 seconds
-    while (true) {
-        std::this_thread::sleep_for(std::chrono::seconds(15));
-        if (client.connectionClosed || !sendKeepAlivePacket(client)) {
-            break;
-        }
-    }
-}
-
-void handleKeepAliveResponse(SocketType clientSock, const std::vector<uint8_t>& packetData, size_t index) {
-    // Read the Keep Alive ID (Long)
-    if (index + 8 > packetData.size()) {
-        logMessage("Invalid Keep Alive packet received", LOG_WARNING);
-        return;
-    }
-
-    uint64_t keepAliveID = 0;
-    for (int i = 0; i < 8; ++i) {
-        keepAliveID = (keepAliveID << 8) | packetData[index + i];
-    }
-    logMessage("Received Keep Alive Response with ID: " + std::to_string(keepAliveID), LOG_DEBUG);
-
-    // TODO: verify that the keepAliveID matches the one sent
-}
-
-void handleTeleportConfirm(ClientConnection& client, const std::vector<uint8_t>& packetData, size_t index, int teleportID) {
+void handleTeleportConfirm(ClientConnection& client, int teleportID) {
     client.state = ClientState::Play;
     // For now we don't need to do anything else
 }
 
-bool handleClientInformation(Player& player, const std::vector<uint8_t> & packetData, size_t index) {
+bool handleClientInformation(Player& player, PacketReader& reader) {
     // Read Locale (String)
-    std::string locale = parseString(packetData, index);
+    std::string locale(reader.readString(16));
     player.lang = locale;
     // Read View Distance (Byte)
-    uint8_t viewDistance = packetData[index++];
+    uint8_t viewDistance = reader.readByte();
     player.viewDistance = viewDistance;
     // Read Chat Mode (VarInt)
-    int32_t chatMode = parseVarInt(packetData, index);
+    int32_t chatMode = reader.readVarInt();
     // Read Chat Colors (Boolean)
-    bool chatColors = packetData[index++] != 0;
+    bool chatColors = reader.readBool();
     // Read Displayed Skin Parts (Unsigned Byte)
-    uint8_t displayedSkinParts = packetData[index++];
+    uint8_t displayedSkinParts = reader.readByte();
     // Read Main Hand (VarInt)
-    int32_t mainHand = parseVarInt(packetData, index);
+    int32_t mainHand = reader.readVarInt();
     // Read Enable Text Filtering (Boolean)
-    bool enableTextFiltering = packetData[index++] != 0;
+    bool enableTextFiltering = reader.readBool();
     // Read Allow Server Listings (Boolean)
-    bool allowServerListings = packetData[index++] != 0;
+    bool allowServerListings = reader.readBool();
 
     return true;
 }
 
-bool handleZeroPacket(ClientConnection& client, const std::vector<uint8_t>& packetData, size_t index, const std::shared_ptr<Player>& player) {
+bool handleZeroPacket(ClientConnection& client, PacketReader& reader, const std::shared_ptr<Player>& player) {
     // Attempt to parse the teleport ID first
-    size_t unchangedIndex = index;
-    int32_t teleportID = parseVarInt(packetData, index);
+    PacketReader clientInformation = reader;
+    int32_t teleportID = reader.readVarInt();
 
     bool isTeleportConfirm = false;
     {
@@ -202,28 +149,28 @@ bool handleZeroPacket(ClientConnection& client, const std::vector<uint8_t>& pack
     }
 
     if (isTeleportConfirm && client.state == ClientState::AwaitingTeleportConfirm) {
-        handleTeleportConfirm(client, packetData, index, teleportID);
+        handleTeleportConfirm(client, teleportID);
         return false;
     }
-    return handleClientInformation(*player, packetData, unchangedIndex);
+    return handleClientInformation(*player, clientInformation);
 }
 
-void handleClientSettings(SocketType clientSock, const std::vector<uint8_t>& packetData, size_t index) {
+void handleClientSettings(SocketType clientSock, PacketReader& reader) {
 
 }
 
-void handlePlayerOnGround(SocketType clientSock, const std::vector<uint8_t>& packetData, size_t index, const std::shared_ptr<Player>& player) {
-    bool onGround = packetData[index++] != 0;
+void handlePlayerOnGround(SocketType clientSock, PacketReader& reader, const std::shared_ptr<Player>& player) {
+    bool onGround = reader.readBool();
     player->onGround = onGround;
 }
 
-void handlePlayerRotation(SocketType clientSock, const std::vector<uint8_t>& packetData, size_t index, const std::shared_ptr<Player>& player) {
+void handlePlayerRotation(SocketType clientSock, PacketReader& reader, const std::shared_ptr<Player>& player) {
     // Read Yaw (Float)
-    float yaw = parseFloat(packetData, index);
+    float yaw = reader.readFloat();
     // Read Pitch (Float)
-    float pitch = parseFloat(packetData, index);
+    float pitch = reader.readFloat();
     // Read On Ground (Boolean)
-    bool onGround = packetData[index++] != 0;
+    bool onGround = reader.readBool();
 
     // Update player state
     player->rotation.yaw = yaw;
@@ -231,17 +178,17 @@ void handlePlayerRotation(SocketType clientSock, const std::vector<uint8_t>& pac
     player->rotation.headYaw = yaw;
     player->onGround = onGround;
 
-    sendEntityRotationPacket(player);
-    sendHeadRotationPacket(player);
+    entitySync.markRotated(player);
+    entitySync.markHeadRotated(player);
 }
 
-void handlePlayerPositionAndRotationPacket(ClientConnection& client, const std::vector<uint8_t> & vector, size_t size, const std::shared_ptr<Player>& player) {
-    double x = parseDouble(vector, size);
-    double feetY = parseDouble(vector, size);
-    double z = parseDouble(vector, size);
-    float yaw = parseFloat(vector, size);
-    float pitch = parseFloat(vector, size);
-    bool onGround = vector[size++] != 0;
+void handlePlayerPositionAndRotationPacket(ClientConnection& client, PacketReader& reader, const std::shared_ptr<Player>& player) {
+    double x = reader.readDouble();
+    double feetY = reader.readDouble();
+    double z = reader.readDouble();
+    float yaw = reader.readFloat();
+    float pitch = reader.readFloat();
+    bool onGround = reader.readBool();
 
     // Calculate new chunk coordinates
     int32_t newChunkX = getChunkCoordinate(x);
@@ -261,24 +208,9 @@ void handlePlayerPositionAndRotationPacket(ClientConnection& client, const std::
         // Update chunk viewers
         updatePlayerChunkView(player, oldChunkX, oldChunkZ, newChunkX, newChunkZ);
 
-        std::vector<ChunkCoordinates> chunksToLoad = getChunksInView(newChunkX, newChunkZ, std::min(player->viewDistance, serverConfig.viewDistance));
-
-        // Remove chunks that are already loaded
-        for (auto it = chunksToLoad.begin(); it != chunksToLoad.end();) {
-            if (player->loadedChunks.contains(*it)) {
-                it = chunksToLoad.erase(it);
-            } else {
-                ++it;
-            }
-        }
-
-        for(auto chunkCoord : chunksToLoad) {
-            player->loadedChunks.insert(chunkCoord);
-            // TODO: Remove unloaded chunks
-            if (auto chunk = getOrLoadChunk(chunkCoord.chunkX, chunkCoord.chunkZ)) {
-                sendChunkDataToPlayer(client, chunk);
-            }
-        }
+        // Stream the chunks that came into view, nearest first
+        // TODO: Remove unloaded chunks
+        queueChunksInView(*player);
     }
 
     // Calculate deltas
@@ -301,12 +233,13 @@ void handlePlayerPositionAndRotationPacket(ClientConnection& client, const std::
     // Decide which packet to send based on movement magnitude
     if (std::abs(deltaX) < 7.999755859375 && std::abs(deltaY) < 7.999755859375 && std::abs(deltaZ) < 7.999755859375) {
         // Small movement: Use Relative Move
-        sendEntityLookAndRelativeMovePacket(player, deltaXFixed, deltaYFixed, deltaZFixed, yaw, pitch);
+        entitySync.markMoved(player, deltaXFixed, deltaYFixed, deltaZFixed);
+        entitySync.markRotated(player);
     } else {
         // Large movement: Use Teleport
-        sendEntityTeleportPacket(player);
+        entitySync.markTeleported(player);
     }
-    sendHeadRotationPacket(player);
+    entitySync.markHeadRotated(player);
 
     for (const auto &val: entityManager.getAllEntities() | std::views::values) {
         if (val->type == EntityType::Item) {
@@ -327,11 +260,11 @@ void handlePlayerPositionAndRotationPacket(ClientConnection& client, const std::
     }
 }
 
-void handlePlayerPosition(ClientConnection& client, const std::vector<uint8_t>& vector, size_t& index, const std::shared_ptr<Player>& player) {
-    double x = parseDouble(vector, index);
-    double feetY = parseDouble(vector, index);
-    double z = parseDouble(vector, index);
-    bool onGround = vector[index++] != 0;
+void handlePlayerPosition(ClientConnection& client, PacketReader& reader, const std::shared_ptr<Player>& player) {
+    double x = reader.readDouble();
+    double feetY = reader.readDouble();
+    double z = reader.readDouble();
+    bool onGround = reader.readBool();
 
     // Calculate new chunk coordinates
     int32_t newChunkX = getChunkCoordinate(x);
@@ -351,24 +284,9 @@ void handlePlayerPosition(ClientConnection& client, const std::vector<uint8_t>&
         // Update chunk viewers
         updatePlayerChunkView(player, oldChunkX, oldChunkZ, newChunkX, newChunkZ);
 
-        std::vector<ChunkCoordinates> chunksToLoad = getChunksInView(newChunkX, newChunkZ, std::min(player->viewDistance, serverConfig.viewDistance));
-
-        // Remove chunks that are already loaded
-        for (auto it = chunksToLoad.begin(); it != chunksToLoad.end();) {
-            if (player->loadedChunks.contains(*it)) {
-                it = chunksToLoad.erase(it);
-            } else {
-                ++it;
-            }
-        }
-
-        for(auto chunkCoord : chunksToLoad) {
-            auto chunk = getOrLoadChunk(chunkCoord.chunkX, chunkCoord.chunkZ);
-            player->loadedChunks.insert(chunkCoord);
-            if (chunk) {
-                sendChunkDataToPlayer(client, chunk);
-            }
-        }
+        // Stream the chunks that came into view, nearest first
+        // TODO: Remove unloaded chunks
+        queueChunksInView(*player);
     }
 
     // Calculate deltas
@@ -388,10 +306,10 @@ void handlePlayerPosition(ClientConnection& client, const std::vector<uint8_t>&
     // Decide which packet to send based on movement magnitude
     if (std::abs(deltaX) < 7.999755859375 && std::abs(deltaY) < 7.999755859375 && std::abs(deltaZ) < 7.999755859375) {
         // Small movement: Use Relative Move
-        sendPlayerRelativeMovePacket(player, deltaXFixed, deltaYFixed, deltaZFixed);
+        entitySync.markMoved(player, deltaXFixed, deltaYFixed, deltaZFixed);
     } else {
         // Large movement: Use Teleport
-        sendEntityTeleportPacket(player);
+        entitySync.markTeleported(player);
     }
 
     for (const auto &val: entityManager.getAllEntities() | std::views::values) {
@@ -413,10 +331,10 @@ void handlePlayerPosition(ClientConnection& client, const std::vector<uint8_t>&
     }
 }
 
-void handlePlayerCommand(SocketType socket, const std::vector<uint8_t> & packetData, size_t index, const std::shared_ptr<Player> & player) {
-    int32_t entityID = parseVarInt(packetData, index);
-    int32_t actionID = parseVarInt(packetData, index);
-    int32_t jumpBoost = parseVarInt(packetData, index);
+void handlePlayerCommand(SocketType socket, PacketReader& reader, const std::shared_ptr<Player> & player) {
+    int32_t entityID = reader.readVarInt();
+    int32_t actionID = reader.readVarInt();
+    int32_t jumpBoost = reader.readVarInt();
     std::vector<MetadataEntry> entries;
 
     switch (actionID) {
@@ -460,8 +378,8 @@ void handlePlayerCommand(SocketType socket, const std::vector<uint8_t> & packetD
     }
 }
 
-void handlePlayerSwingArm(SocketType socket, const std::vector<uint8_t> & packetData, size_t index, const std::shared_ptr<Player> & player) {
-    switch (const size_t hand = parseVarInt(packetData, index)) {
+void handlePlayerSwingArm(SocketType socket, PacketReader& reader, const std::shared_ptr<Player> & player) {
+    switch (const size_t hand = reader.readVarInt()) {
         case 0: // Main Hand
             sendEntityAnimation(player, SWING_MAIN_ARM);
             break;
@@ -491,11 +409,7 @@ void spawnBlockDrops(int32_t x, int32_t y, int32_t z, int16_t blockState) {
 
         item->setCooldown(10); // 10 ticks before item can be picked up
 
-        // Send spawn packet with velocity
-        sendBundleDelimiter();
-        sendSpawnEntityPacket(item);
-        sendEntityMetadataPacket(item->getMetadata(), item->entityID);
-        sendBundleDelimiter();
+        // The entity tracker spawns the item for nearby players at the end of the tick
     }
 }
 
@@ -523,8 +437,8 @@ void handleFinishedDigging(ClientConnection& client, const std::shared_ptr<Playe
     // Notify all players viewing this chunk about the block change
     notifyChunkUpdate(chunk, x, y, z);
 
-    // Acknowledge the block change
-    sendAcknowledgeBlockChange(client, sequence);
+    // Acknowledge the block change once the tick's block updates are out
+    acknowledgeBlockChange(client, static_cast<int32_t>(sequence));
 
     // Send world event packet to all viewers
     {
@@ -558,62 +472,68 @@ void removePlayerFromAllChunks(const std::shared_ptr<Player> & player) {
     }
 }
 
-void miningScheduler(std::unordered_map<std::string, std::shared_ptr<Player>> &players, std::atomic<bool> &running) {
-    const int tickRate = 20; // 20 ticks per second
-    while (running) {
-        auto tickStart = std::chrono::steady_clock::now();
-
-        for (auto &player: players | std::views::values) {
-            std::lock_guard<std::mutex> lock(player->miningMutex);
-            for (auto it = player->currentMining.begin(); it != player->currentMining.end(); ) {
-                MiningProgress &progress = it->second;
-                double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - progress.startTime).count();
-
-                // Calculate the current stage based on elapsed time
-                int8_t newStage = static_cast<int8_t>((elapsed / progress.totalTime) * 10);
-                newStage = std::min(newStage, static_cast<int8_t>(9)); // Stages 0-9
-
-                if (newStage > progress.currentStage) {
-                    // Send the new destroy stage
-                    Position blockPos = progress.blockPos;
-                    sendBlockDestroyStage(player, blockPos, newStage);
-                    progress.currentStage = newStage;
-                }
+static uint64_t secondsToTicks(double seconds) {
+    return static_cast<uint64_t>(std::ceil(std::max(seconds, 0.0) * serverConfig.ticksPerSecond));
+}
 
-                if (elapsed >= progress.totalTime) {
-                    // Mining complete
-                    sendBlockDestroyStage(player, progress.blockPos, 10); // Final stage or block break
+static void advanceMiningStage(const std::weak_ptr<Player>& weakPlayer, const Position& blockPos, std::chrono::steady_clock::time_point startTime);
+
+// Schedules the next destroy stage of a block being mined, or the end of the mining after stage 9.
+// The player's miningMutex must be held.
+static void scheduleMiningStage(const std::shared_ptr<Player>& player, MiningProgress& progress) {
+    // Stage n is reached after n tenths of the total time, the block breaks at "stage 10"
+    double stageTime = progress.totalTime * (progress.currentStage + 1) / 10.0;
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - progress.startTime).count();
+    std::weak_ptr<Player> weakPlayer = player;
+    Position blockPos = progress.blockPos;
+    std::chrono::steady_clock::time_point startTime = progress.startTime;
+    progress.stageTimer = timerWheel.schedule(secondsToTicks(stageTime - elapsed), [weakPlayer, blockPos, startTime]() {
+        advanceMiningStage(weakPlayer, blockPos, startTime);
+    });
+}
 
-                    // Handle block breaking logic
-                    // e.g., remove the block, drop items, etc.
-                    // You might need to call handleFinishedDigging here or similar
+// Runs on the tick loop
+static void advanceMiningStage(const std::weak_ptr<Player>& weakPlayer, const Position& blockPos, std::chrono::steady_clock::time_point startTime) {
+    std::shared_ptr<Player> player = weakPlayer.lock();
+    if (!player) {
+        return;
+    }
 
-                    it = player->currentMining.erase(it);
-                } else {
-                    ++it;
-                }
-            }
-        }
+    std::lock_guard lock(player->miningMutex);
+    auto it = player->currentMining.find(blockPos);
+    // Cancelled, or restarted just as this timer came due
+    if (it == player->currentMining.end() || it->second.startTime != startTime) {
+        return;
+    }
+    MiningProgress &progress = it->second;
 
-        // Sleep until the next tick
-        auto tickEnd = std::chrono::steady_clock::now();
-        std::chrono::duration<double> tickDuration = tickEnd - tickStart;
-        double sleepTime = (1.0 / tickRate) - tickDuration.count();
-        if (sleepTime > 0) {
-            std::this_thread::sleep_for(std::chrono::duration<double>(sleepTime));
-        }
+    if (progress.currentStage >= 9) {
+        // Mining complete
+        sendBlockDestroyStage(player, progress.blockPos, 10); // Final stage or block break
+
+        // Handle block breaking logic
+        // e.g., remove the block, drop items, etc.
+        // You might need to call handleFinishedDigging here or similar
+
+        player->currentMining.erase(it);
+        return;
     }
+
+    // Send the new destroy stage
+    progress.currentStage++;
+    sendBlockDestroyStage(player, progress.blockPos, progress.currentStage);
+    scheduleMiningStage(player, progress);
 }
 
-void handlePlayerActions(ClientConnection& client, const std::vector<uint8_t> & packetData, size_t index, const std::shared_ptr<Player> & player) {
-    auto action = static_cast<PlayerAction>(parseVarInt(packetData, index));
-    uint64_t position = parseLong(packetData, index);
+void handlePlayerActions(ClientConnection& client, PacketReader& reader, const std::shared_ptr<Player> & player) {
+    auto action = static_cast<PlayerAction>(reader.readVarInt());
+    uint64_t position = reader.readLong();
     int32_t x{};
     int32_t y{};
     int32_t z{};
     decodePosition(position, x, y, z);
-    auto face = static_cast<Face>(parseByte(packetData, index));
-    size_t sequence = parseVarInt(packetData, index);
+    auto face = static_cast<Face>(reader.readByte());
+    size_t sequence = reader.readVarInt();
 
     const auto chunk = getChunkContainingBlock(x, y, z);
     if (!chunk) {
@@ -638,15 +558,20 @@ void handlePlayerActions(ClientConnection& client, const std::vector<uint8_t> &
                 progress.blockPos = blockPos;
                 progress.sequence = sequence;
 
-                {
-                    std::lock_guard lock(player->miningMutex);
-                    player->currentMining[blockPos] = progress;
-                }
-
                 // Send initial destroy stage
                 sendBlockDestroyStage(player, blockPos, progress.currentStage);
 
-                // Note: The miningScheduler thread will handle subsequent stages
+                {
+                    std::lock_guard lock(player->miningMutex);
+                    // Restarting on the same block replaces its timer
+                    auto existing = player->currentMining.find(blockPos);
+                    if (existing != player->currentMining.end()) {
+                        timerWheel.cancel(existing->second.stageTimer);
+                    }
+                    MiningProgress& mining = player->currentMining[blockPos] = progress;
+                    // Subsequent stages are sent from the timer wheel
+                    scheduleMiningStage(player, mining);
+                }
             }
             break;
         }
@@ -658,6 +583,7 @@ void handlePlayerActions(ClientConnection& client, const std::vector<uint8_t> &
                 if (it != player->currentMining.end()) {
                     // Reset the destroy stage
                     sendBlockDestroyStage(player, blockPos, 0);
+                    timerWheel.cancel(it->second.stageTimer);
                     player->currentMining.erase(it);
                 }
             }
@@ -671,6 +597,7 @@ void handlePlayerActions(ClientConnection& client, const std::vector<uint8_t> &
                 auto it = player->currentMining.find(blockPos);
                 if (it != player->currentMining.end()) {
                     shouldHandle = true;
+                    timerWheel.cancel(it->second.stageTimer);
                     player->currentMining.erase(it);
                 }
             }
@@ -695,50 +622,15 @@ void handlePlayerActions(ClientConnection& client, const std::vector<uint8_t> &
     }
 }
 
-void handleSetCreativeModeSlot(SocketType socket, const std::vector<uint8_t> & packetData, size_t index, const std::shared_ptr<Player> & player) {
-    short slot = parseShort(packetData, index);
+void handleSetCreativeModeSlot(SocketType socket, PacketReader& reader, const std::shared_ptr<Player> & player) {
+    short slot = reader.readShort();
 
-    SlotData slotDataParsed;
-    // 2.1 Item Count (VarInt)
-    slotDataParsed.itemCount = parseVarInt(packetData, index);
-
-    // 2.2 Item ID (Optional VarInt)
-    if (slotDataParsed.itemCount > 0) {
-        slotDataParsed.itemId = parseVarInt(packetData, index);
-    } else {
+    SlotData slotDataParsed = reader.readSlot();
+    if (slotDataParsed.itemCount == 0) {
+        // Cleared slots hold air
         slotDataParsed.itemId = 0;
     }
 
-    // 2.3 Number of Components to Add (Optional VarInt)
-    if (slotDataParsed.itemCount > 0) {
-        slotDataParsed.numCompToAdd = parseVarInt(packetData, index);
-
-        // 2.4 Components to Add (Array of Components)
-        if (slotDataParsed.numCompToAdd && *slotDataParsed.numCompToAdd > 0) {
-            std::vector<Component> componentsToAdd;
-            for (size_t i = 0; i < *slotDataParsed.numCompToAdd; ++i) {
-                Component comp = parseComponent(packetData, index);
-                componentsToAdd.push_back(comp);
-            }
-            slotDataParsed.compsToAdd = componentsToAdd;
-        }
-    }
-
-    // 2.5 Number of Components to Remove (Optional VarInt)
-    if (slotDataParsed.itemCount > 0) {
-        slotDataParsed.numCompToRemove = parseVarInt(packetData, index);
-
-        // 2.6 Components to Remove (Array of Component Types)
-        if (slotDataParsed.numCompToRemove && *slotDataParsed.numCompToRemove > 0) {
-            std::vector<ComponentType> componentsToRemove;
-            for (size_t i = 0; i < *slotDataParsed.numCompToRemove; ++i) {
-                size_t compTypeVarInt = parseVarInt(packetData, index);
-                componentsToRemove.emplace_back(static_cast<ComponentType>(compTypeVarInt));
-            }
-            slotDataParsed.compsToRemove = componentsToRemove;
-        }
-    }
-
     // Reference: https://wiki.vg/images/1/13/Inventory-slots.png
     if(player->activeSlot == (slot - 36)) {
         EquipmentSlot mainHandSlot;
@@ -783,8 +675,8 @@ void handleSetCreativeModeSlot(SocketType socket, const std::vector<uint8_t> & p
     SendSetContainerSlot(*player->client, 0, 0, slot, slotDataParsed);
 }
 
-void handleSetHeldItem(SocketType socket, const std::vector<uint8_t> & packetData, size_t index, const std::shared_ptr<Player> & player) {
-    short slot = parseShort(packetData, index);
+void handleSetHeldItem(SocketType socket, PacketReader& reader, const std::shared_ptr<Player> & player) {
+    short slot = reader.readShort();
     player->activeSlot = slot;
 
     if(player->inventory->slots.contains(slot + 36)) {
@@ -880,11 +772,11 @@ bool interact(const std::shared_ptr<Player> & player, const Position & blockPos,
     return false;
 }
 
-void handleUseItemOn(ClientConnection& client, const std::vector<uint8_t> & packetData, size_t index, const std::shared_ptr<Player> & player) {
+void handleUseItemOn(ClientConnection& client, PacketReader& reader, const std::shared_ptr<Player> & player) {
     // Hand (VarInt)
-    size_t hand = parseVarInt(packetData, index);
+    size_t hand = reader.readVarInt();
     // Position (Long/Position)
-    int64_t positionL = parseLong(packetData, index);
+    int64_t positionL = reader.readLong();
     Position blockPosition{};
     Position cursorPosition{};
     int32_t x{};
@@ -893,18 +785,18 @@ void handleUseItemOn(ClientConnection& client, const std::vector<uint8_t> & pack
     decodePosition(positionL, x, y, z);
     blockPosition = {static_cast<double>(x), static_cast<double>(y), static_cast<double>(z)};
     // Face (VarInt)
-    Face face = static_cast<Face>(parseVarInt(packetData, index));
+    Face face = static_cast<Face>(reader.readVarInt());
     // Cursor Position x (Float)
-    float cursorX = parseFloat(packetData, index);
+    float cursorX = reader.readFloat();
     // Cursor Position y (Float)
-    float cursorY = parseFloat(packetData, index);
+    float cursorY = reader.readFloat();
     // Cursor Position z (Float)
-    float cursorZ = parseFloat(packetData, index);
+    float cursorZ = reader.readFloat();
     cursorPosition = {cursorX, cursorY, cursorZ};
     // Inside Block (Boolean)
-    bool insideBlock = packetData[index++] != 0;
+    bool insideBlock = reader.readBool();
     // Sequence (VarInt)
-    int32_t sequence = parseVarInt(packetData, index);
+    int32_t sequence = reader.readVarInt();
 
     // 2. Determine the Block to Place
     int selectedSlot = player->activeSlot + 36;
@@ -967,8 +859,8 @@ void handleUseItemOn(ClientConnection& client, const std::vector<uint8_t> & pack
     // 7. Notify Relevant Clients About the Block Change
     notifyChunkUpdate(chunk, static_cast<int32_t>(targetPosition.x), static_cast<int32_t>(targetPosition.y), static_cast<int32_t>(targetPosition.z));
 
-    // Acknowledge the block change
-    sendAcknowledgeBlockChange(client, sequence);
+    // Acknowledge the block change once the tick's block updates are out
+    acknowledgeBlockChange(client, static_cast<int32_t>(sequence));
 
     // 8. Update the Player's Inventory
     // In Creative Mode, items are not consumed. If in Survival, decrease item count
@@ -1028,25 +920,22 @@ bool verifySessionKeySignature(const std::shared_ptr<Player> & player, long expi
     return false; // Verification failed with all keys
 }
 
-void handlePlayerSession(ClientConnection & client, const std::vector<uint8_t> & packetData, size_t index, const std::shared_ptr<Player> & player) {
+void handlePlayerSession(ClientConnection & client, PacketReader& reader, const std::shared_ptr<Player> & player) {
     // Read Session ID (UUID)
-    player->sessionId = parseBytes(packetData, index, 16);
+    std::array<uint8_t, 16> sessionId = reader.readUUID();
+    player->sessionId.assign(sessionId.begin(), sessionId.end());
 
     // Read Public Key
     // Expire at (Long)
-    player->sessionKey.expiresAt = parseLong(packetData, index);
+    player->sessionKey.expiresAt = reader.readLong();
 
-    // Length of Public Key (VarInt)
-    int32_t publicKeyLength = parseVarInt(packetData, index);
+    // Public Key (Prefixed Array of Bytes)
+    std::span<const uint8_t> publicKey = reader.readByteArray(512);
+    player->sessionKey.pubKey.assign(publicKey.begin(), publicKey.end());
 
-    // Public Key (Array of Bytes)
-    player->sessionKey.pubKey = parseBytes(packetData, index, publicKeyLength);
-
-    // Length of Key Signature (VarInt)
-    int32_t keySignatureLength = parseVarInt(packetData, index);
-
-    // Key Signature (Array of Bytes)
-    player->sessionKey.keySig = parseBytes(packetData, index, keySignatureLength);
+    // Key Signature (Prefixed Array of Bytes)
+    std::span<const uint8_t> keySignature = reader.readByteArray(4096);
+    player->sessionKey.keySig.assign(keySignature.begin(), keySignature.end());
 
     if (serverConfig.enableSecureChat) {
         // Parse the public key and store it
@@ -1056,8 +945,8 @@ void handlePlayerSession(ClientConnection & client, const std::vector<uint8_t> &
             return;
         }
 
-        // Fetch Mojang's public keys
-        std::vector<std::string> mojangPublicKeyPEMs = fetchMojangPublicKeys();
+        // Mojang's public keys, fetched at startup
+        std::vector<std::string> mojangPublicKeyPEMs = cachedMojangPublicKeys();
         if (mojangPublicKeyPEMs.empty()) {
             // Handle error
             disconnectClient(player, "Unable to fetch Mojang public keys.", true);
@@ -1169,27 +1058,28 @@ bool verifyChatSignature(const std::shared_ptr<Player>& player, const std::strin
     return result;
 }
 
-void handleChatMessage(const ClientConnection & client, const std::vector<uint8_t> & packetData, size_t index, const std::shared_ptr<Player> & player, const RegistryManager& registryManager) {
+void handleChatMessage(const ClientConnection & client, PacketReader& reader, const std::shared_ptr<Player> & player, const RegistryManager& registryManager) {
     // Message (String)
-    std::string message = parseString(packetData, index);
+    std::string message(reader.readString(256));
 
     // Timestamp (Long)
-    int64_t timestamp = parseLong(packetData, index);
+    int64_t timestamp = reader.readLong();
 
     // Salt (Long)
-    int64_t salt = parseLong(packetData, index);
+    int64_t salt = reader.readLong();
 
     // Has Signature (Boolean)
-    bool hasSignature = packetData[index++] != 0;
+    bool hasSignature = reader.readBool();
 
     std::vector<uint8_t> signature;
 
     if (hasSignature) {
-        signature = parseBytes(packetData, index, 256);
+        std::span<const uint8_t> signatureBytes = reader.readBytes(256);
+        signature.assign(signatureBytes.begin(), signatureBytes.end());
     }
 
     // Message Count (VarInt)
-    int32_t messageCount = parseVarInt(packetData, index);
+    int32_t messageCount = reader.readVarInt();
 
     // Acknowledged (Fixed Bit Set) // TODO: Implement
 
@@ -1233,29 +1123,25 @@ void handleConsoleCommand(const std::string & command) {
     bool success = parser.parseAndExecuteConsole(command, consoleOutput);
 }
 
-void handleChatCommand(ClientConnection & client, const std::vector<uint8_t> & packetData, size_t index, const std::shared_ptr<Player> & player) {
-    std::string command = parseString(packetData, index);
+void handleChatCommand(ClientConnection & client, PacketReader& reader, const std::shared_ptr<Player> & player) {
+    std::string command(reader.readString(256));
     logMessage(player->name + " issued command: " + command, LOG_RAW);
     handleCommand(client, player, command);
 }
 
-void handlePluginMessage(const ClientConnection & client, const std::vector<uint8_t> & packetData, size_t index, Player& player) {
-    std::string channel = parseString(packetData, index);
+void handlePluginMessage(const ClientConnection & client, PacketReader& reader, Player& player) {
+    std::string_view channel = reader.readString();
 
     if (channel == "minecraft:brand") {
         // Brand Plugin Message
-        std::string brand = parseString(packetData, index);
-        player.brand = brand;
+        player.brand = reader.readString();
     }
 }
 
-void handleResourcePackResponse(const ClientConnection & client, const std::vector<uint8_t> & packetData, size_t index, const std::shared_ptr<Player> & player) {
-    // Resource Pack UUID (Bytes)
-    std::vector<uint8_t> resourcePackUUID = parseBytes(packetData, index, 16);
-    std::array<uint8_t, 16> resourcePackUUIDArray{};
-    std::ranges::copy(resourcePackUUID, resourcePackUUIDArray.begin());
-    std::string resourcePackUUIDStr = uuidToString(resourcePackUUIDArray);
-    switch (size_t result = parseVarInt(packetData, index)) {
+void handleResourcePackResponse(const ClientConnection & client, PacketReader& reader, const std::shared_ptr<Player> & player) {
+    // Resource Pack UUID (UUID)
+    std::string resourcePackUUIDStr = uuidToString(reader.readUUID());
+    switch (size_t result = reader.readVarInt()) {
         case SUCCESSFULLY_DOWNLOADED:
             logMessage(player->name + " successfully downloaded resource pack with UUID: " + resourcePackUUIDStr, LOG_DEBUG);
             break;
@@ -1286,9 +1172,9 @@ void handleResourcePackResponse(const ClientConnection & client, const std::vect
     }
 }
 
-void handleCommandSuggestionsRequest(ClientConnection & client, const std::vector<uint8_t> & vector, size_t size, const std::shared_ptr<Player> & shared) {
-    int32_t transactionID = parseVarInt(vector, size);
-    std::string command = parseString(vector, size);
+void handleCommandSuggestionsRequest(ClientConnection & client, PacketReader& reader, const std::shared_ptr<Player> & shared) {
+    int32_t transactionID = reader.readVarInt();
+    std::string command(reader.readString());
     if (command[0] == '/') {
         command = command.substr(1);
     }
@@ -1310,32 +1196,34 @@ void handleCommandSuggestionsRequest(ClientConnection & client, const std::vecto
     }
 }
 
-void handleKeepAlive(const ClientConnection & client, const std::vector<uint8_t> & packet, size_t index, const std::shared_ptr<Player> & player) {
-    int64_t keepAliveID = parseLong(packet, index);
+void handleKeepAlive(ClientConnection & client, PacketReader& reader, const std::shared_ptr<Player> & player) {
+    int64_t keepAliveID = reader.readLong();
     if (keepAliveID != client.keepAliveID) {
         logMessage("Keep Alive ID mismatch for player: " + player->name, LOG_WARNING);
+        return;
     }
+    client.keepAlivePending = false;
 }
 
-void handleClickContainer(const ClientConnection & client, const std::vector<uint8_t> & packet, size_t index, const std::shared_ptr<Player> & player) {
-    uint8_t windowID = parseByte(packet, index);
-    int32_t stateID = parseVarInt(packet, index);
-    int16_t slot = parseShort(packet, index);
-    int8_t button = parseByte(packet, index);
-    int32_t mode = parseVarInt(packet, index);
-    int32_t arrayLength = parseVarInt(packet, index);
+void handleClickContainer(const ClientConnection & client, PacketReader& reader, const std::shared_ptr<Player> & player) {
+    uint8_t windowID = reader.readByte();
+    int32_t stateID = reader.readVarInt();
+    int16_t slot = reader.readShort();
+    int8_t button = static_cast<int8_t>(reader.readByte());
+    int32_t mode = reader.readVarInt();
+    int32_t arrayLength = reader.readVarInt();
     std::vector<std::pair<int16_t, SlotData>> changedSlotsFromClient;
     for (int i = 0; i < arrayLength; i++) {
-        int16_t slotIndex = parseShort(packet, index);
-        SlotData slotData = parseSlotData(packet, index);
+        int16_t slotIndex = reader.readShort();
+        SlotData slotData = reader.readSlot();
         changedSlotsFromClient.emplace_back(slotIndex, slotData);
     }
-    SlotData carriedItem = parseSlotData(packet, index);
+    SlotData carriedItem = reader.readSlot();
     player->currentInventory->HandleInventoryClick(windowID, stateID, slot, button, mode, changedSlotsFromClient, carriedItem);
 }
 
-void handleCloseContainer(const ClientConnection & client, const std::vector<uint8_t> & packet, size_t index, const std::shared_ptr<Player> & player) {
-    uint8_t windowID = parseByte(packet, index);
+void handleCloseContainer(const ClientConnection & client, PacketReader& reader, const std::shared_ptr<Player> & player) {
+    uint8_t windowID = reader.readByte();
     if (windowID != 0 && windowID == player->windowID) {
         // check if shared ptr inherits from specific class
         if (std::shared_ptr<ExternalInventory> inventory = std::dynamic_pointer_cast<ExternalInventory>(
@@ -1347,77 +1235,84 @@ void handleCloseContainer(const ClientConnection & client, const std::vector<uin
     }
 }
 
-void handleClientPacket(ClientConnection& client, const std::vector<uint8_t>& packetData, const std::shared_ptr<Player>& player, const RegistryManager& registryManager) {
-    size_t index = 0;
+void handleClientPacket(ClientConnection& client, PacketReader& reader, const std::shared_ptr<Player>& player, const RegistryManager& registryManager) {
+    if (packetCaptureActive()) {
+        PacketReader whole = reader;
+        capturePacket(*player, whole.readRemaining());
+    }
 
     // Handle packets based on their IDs
-    switch (int32_t packetID = parseVarInt(packetData, index)) {
+    switch (int32_t packetID = reader.readVarInt()) {
         case ZERO_PACKET: // Client Info / Teleport Confirm
-            handleZeroPacket(client, packetData, index, player);
+            handleZeroPacket(client, reader, player);
             break;
         case LOGIN_PLUGIN_RESPONSE: // Serverbound Plugin Message
         case PLUGIN_MESSAGE_PLAY:
-            handlePluginMessage(client, packetData, index, *player);
+            handlePluginMessage(client, reader, *player);
             break;
         case CHAT_COMMAND: // Chat Command
-            handleChatCommand(client, packetData, index, player);
+            handleChatCommand(client, reader, player);
             break;
         case CHAT_MESSAGE: // Chat Message
-            handleChatMessage(client, packetData, index, player, registryManager);
+            handleChatMessage(client, reader, player, registryManager);
             break;
         case PLAYER_SESSION: // Player Session
-            handlePlayerSession(client, packetData, index, player);
+            handlePlayerSession(client, reader, player);
             break;
         case COMMAND_SUGGESTIONS_REQUEST: // Command Suggestions Request
-            handleCommandSuggestionsRequest(client, packetData, index, player);
+            handleCommandSuggestionsRequest(client, reader, player);
             break;
         case CLICK_CONTAINER: // Click container slot
-            handleClickContainer(client, packetData, index, player);
+            handleClickContainer(client, reader, player);
             break;
         case CLOSE_CONTAINER: // Close container
-            handleCloseContainer(client, packetData, index, player);
+            handleCloseContainer(client, reader, player);
             break;
         case SERVERBOUND_KEEP_ALIVE: // Keep Alive
-            handleKeepAlive(client, packetData, index, player);
+            handleKeepAlive(client, reader, player);
             break;
         case PLAYER_POSITION: // Player Position
             if (client.state != ClientState::AwaitingTeleportConfirm) {
-                handlePlayerPosition(client, packetData, index, player);
+                handlePlayerPosition(client, reader, player);
             }
             break;
         case PLAYER_POSITION_AND_ROTATION: // Player Position and Rotation
             if (client.state != ClientState::AwaitingTeleportConfirm) {
-                handlePlayerPositionAndRotationPacket(client, packetData, index, player);
+                handlePlayerPositionAndRotationPacket(client, reader, player);
             }
             break;
         case Player_ROTATION: // Player Rotation
             if (client.state != ClientState::AwaitingTeleportConfirm) {
-                handlePlayerRotation(client.socket, packetData, index, player);
+                handlePlayerRotation(client.socket, reader, player);
             }
             break;
         case PLAYER_ON_GROUND: // Player On Ground
-            handlePlayerOnGround(client.socket, packetData, index, player);
+            handlePlayerOnGround(client.socket, reader, player);
             break;
         case PLAYER_ACTION: // Player actions
-            handlePlayerActions(client, packetData, index, player);
+            handlePlayerActions(client, reader, player);
             break;
         case PLAYER_COMMAND: // Player command
-            handlePlayerCommand(client.socket, packetData, index, player);
+            handlePlayerCommand(client.socket, reader, player);
             break;
         case RESOURCE_PACK_RESPONSE_PLAY: // Resource Pack Response
-            handleResourcePackResponse(client, packetData, index, player);
+            handleResourcePackResponse(client, reader, player);
             break;
         case HELD_ITEM: // Set Held Item
-            handleSetHeldItem(client.socket, packetData, index, player);
+            handleSetHeldItem(client.socket, reader, player);
             break;
         case CREATIVE_MODE_SLOT: // Set Creative Mode Slot
-            handleSetCreativeModeSlot(client.socket, packetData, index, player);
+            handleSetCreativeModeSlot(client.socket, reader, player);
             break;
         case SWING_ARM: // Swing arm
-            handlePlayerSwingArm(client.socket, packetData, index, player);
+            handlePlayerSwingArm(client.socket, reader, player);
             break;
         case USE_ITEM_ON: // Use Item On
-            handleUseItemOn(client, packetData, index, player);
+            handleUseItemOn(client, reader, player);
+            break;
+        case CHUNK_BATCH_RECEIVED: // Chunk Batch Received
+            // Chunks per tick (Float)
+            handleChunkBatchReceived(*player, reader.readFloat());
             break;
         default: // Unknown packet ID
             std::stringstream stringstream;
@@ -1428,7 +1323,9 @@ void handleClientPacket(ClientConnection& client, const std::vector<uint8_t>& pa
     }
 }
 
-void handlePlayState(ClientConnection& client, const std::shared_ptr<Player>& newPlayer, const RegistryManager& registryManager) {
+void enterPlayState(ClientConnection& client) {
+    const std::shared_ptr<Player>& newPlayer = client.player;
+
     // Send Join Game packet
     sendJoinGamePacket(client, newPlayer->entityID);
 
@@ -1464,43 +1361,33 @@ void handlePlayState(ClientConnection& client, const std::shared_ptr<Player>& ne
 
     // Send Player Info Update to all existing clients about the new player
     std::vector<std::shared_ptr<Player>> newPlayerInfo = {newPlayer};
-    {
-        std::lock_guard lock(connectedClientsMutex);
-        for (auto& [uuid, existingClient] : connectedClients) {
-            if (uuid != newPlayer->uuidString) {
-                sendPlayerInfoUpdate(*existingClient, newPlayerInfo, 0x09); // 0x01: Add Player, 0x08: Update Listed
-            }
-        }
-    }
+    broadcastPlayerInfoUpdate(newPlayerInfo, 0x09, newPlayer->uuidString); // 0x01: Add Player, 0x08: Update Listed
 
     // Send Player Info Update to the new player about themselves
     sendPlayerInfoUpdate(client, newPlayerInfo, 0x09); // 0x01: Add Player, 0x08: Update Listed
 
-    // Send Spawn Entity packets
-    // Send to the new client about existing players
-    for (const auto &entity: existingEntities | std::views::values) {
-        if (entity->uuidString != newPlayer->uuidString && entity->type == EntityType::Player) {
-            sendSpawnEntityPacket(client, entity);
-        }
-    }
-
-    // Send to existing clients about the new player
-    {
-        std::lock_guard lock(connectedClientsMutex);
-        for (auto& [uuid, existingClient] : connectedClients) {
-            if (uuid != newPlayer->uuidString) {
-                sendSpawnEntityPacket(*existingClient, newPlayer);
-            }
-        }
-    }
+    // Players (and every other entity) are spawned for each other by the entity tracker once they are in range
     {
         std::lock_guard lock(connectedClientsMutex);
         connectedClients[newPlayer->uuidString] = &client;
     }
+    serverStatus.invalidate();
 
-
-    // Start Keep Alive loop in a separate thread
-    std::thread keepAliveLoop(startKeepAliveLoop, std::ref(client));
+    // Keep Alive every 15 seconds, and drop the player if the previous one went unanswered
+    std::weak_ptr<ClientConnection> weakConnection = client.shared_from_this();
+    client.keepAliveTimer = timerWheel.scheduleRepeating(KEEP_ALIVE_INTERVAL_SECONDS * serverConfig.ticksPerSecond, [weakConnection]() {
+        std::shared_ptr<ClientConnection> connection = weakConnection.lock();
+        if (!connection || connection->connectionClosed || !connection->player) {
+            return false;
+        }
+        if (connection->keepAlivePending.exchange(true)) {
+            logMessage("Player " + connection->player->name + " did not respond to Keep Alive in time", LOG_WARNING);
+            disconnectClient(connection->player, "Timed out", true);
+            return false;
+        }
+        sendKeepAlivePacket(*connection);
+        return true;
+    });
 
     // Send Game Event: Start waiting for level chunks
     // According to the protocol, the value depends on the event
@@ -1511,587 +1398,633 @@ void handlePlayState(ClientConnection& client, const std::shared_ptr<Player>& ne
     // Send Set Center Chunk packet with initial chunk coordinates
     sendSetCenterChunkPacket(client, newPlayer->currentChunkX, newPlayer->currentChunkZ);
 
-    // Send Chunk Data Packets
-    // Determine which chunks to send based on view distance
-    int viewDistance = serverConfig.viewDistance; // TODO: Send to player
+    // Initialize the world border
+    worldBorder.initialize(serverConfig.worldBorder);
+    sendInitializeWorldBorder(client, worldBorder);
+
+    // Send current chunk to the player
     int centerChunkX = newPlayer->currentChunkX;
     int centerChunkZ = newPlayer->currentChunkZ;
+    sendCurrentChunkToPlayer(client, centerChunkX, centerChunkZ);
+    {
+        std::lock_guard lock(newPlayer->chunkQueue.mutex);
+        newPlayer->loadedChunks.insert({centerChunkX, centerChunkZ});
+    }
 
+    updatePlayerChunkView(newPlayer, -1, -1, centerChunkX, centerChunkZ);
 
-    // TODO: Use getChunksInView
-    // Load and send chunks within view distance
-    auto sendChunks = [&](int centerX, int centerZ, const std::shared_ptr<Player>& player) {
-        // Measure time
-        auto startTime = std::chrono::steady_clock::now();
-
-        // Define the chunks to load and already loaded
-        std::vector<ChunkCoordinates> chunksToLoad;
-        std::vector<ChunkCoordinates> chunksAlreadyLoaded; {
-            int chunkCount = 0;
-            std::lock_guard lock(chunkMapMutex);
-            for (int dx = -viewDistance; dx <= viewDistance; ++dx) {
-                for (int dz = -viewDistance; dz <= viewDistance; ++dz) {
-                    // Skip the current chunk if needed
-                    chunkCount++;
-                    if (dx == 0 && dz == 0) continue;
-
-                    int chunkX = centerX + dx;
-                    int chunkZ = centerZ + dz;
-                    ChunkCoordinates coords{chunkX, chunkZ};
-                    auto it = globalChunkMap.find(coords);
-                    if (it != globalChunkMap.end()) {
-                        chunksAlreadyLoaded.emplace_back(coords);
-                    } else {
-                        chunksToLoad.emplace_back(coords);
-                    }
-                }
-            }
-        }
-
-        // Vector to hold futures for loaded chunks
-        std::vector<std::future<std::shared_ptr<Chunk>>> loadFutures;
-        loadFutures.reserve(chunksToLoad.size());
-
-        // Enqueue load/generate tasks
-        for (const auto& coords : chunksToLoad) {
-            loadFutures.emplace_back(
-                threadPool.enqueue([coords]() -> std::shared_ptr<Chunk> {
-                    // Attempt to load the chunk from disk
-                    auto loadedChunk = loadChunkFromDisk(coords.chunkX, coords.chunkZ);
-                    if (!loadedChunk) {
-                        // Generate the chunk if loading failed
-                        if (serverConfig.worldType == "flat") {
-                            FlatWorldSettings settings = flatWorldPresets[serverConfig.flatWorldPreset];
-                            int highestY;
-                            loadedChunk = generateFlatChunk(settings, coords.chunkX, coords.chunkZ, highestY);
-                        }
-                    }
-                    return loadedChunk;
-                })
-            );
-        }
+    // The tick loop streams the rest in batches, as fast as the client asks for them
+    queueChunksInView(*newPlayer);
 
-        // Vector to hold chunks to send (already loaded and newly loaded)
-        std::vector<std::shared_ptr<Chunk>> chunksToSend;
-        chunksToSend.reserve(chunksAlreadyLoaded.size() + chunksToLoad.size());
+    // Send Resource Packs
+    sendResourcePacks(client);
+}
 
-        // Collect already loaded chunks
-        {
-            std::lock_guard lock(chunkMapMutex);
-            for (const auto& coords : chunksAlreadyLoaded) {
-                auto it = globalChunkMap.find(coords);
-                if (it != globalChunkMap.end()) {
-                    chunksToSend.emplace_back(it->second);
-                }
+bool handleConfigurationPacket(ClientConnection& client, PacketReader& reader) {
+    switch (int32_t packetID = reader.readVarInt()) {
+        case CLIENT_INFORMATION: // Client Information
+            if (!handleClientInformation(*client.player, reader)) {
+                return false;
             }
+            sendServerPluginMessages(client);
+            sendKnownPacksPacket(client);
+            return true;
+        case LOGIN_PLUGIN_RESPONSE: // Serverbound Plugin Message
+            handlePluginMessage(client, reader, *client.player);
+            return true;
+        case SERVERBOUND_KNOWN_PACKS: // Known Packs
+            // Send Registry Data packet
+            sendRegistryDataPacket(client, *client.registryManager);
+
+            // Update tags
+            sendUpdateTagsPacket(client);
+
+            // Send server links
+            sendServerLinksPacket(client);
+
+            // Send Finish Configuration packet
+            sendFinishConfigurationPacket(client);
+            return true;
+        case ACKNOWLEDGE_FINISH_CONFIGURATION: // Acknowledge Finish Configuration
+            sendTranslatedChatMessage("multiplayer.player.joined", false, "yellow", nullptr, true, client.player->name);
+
+            // Now in Play state
+            client.state = ClientState::Play;
+            enterPlayState(client);
+            return true;
+        default: {
+            std::stringstream stringstream;
+            stringstream << "Ignoring configuration packet ID: 0x" << std::hex << packetID << std::dec;
+            logMessage(stringstream.str(), LOG_DEBUG);
+            return true;
         }
+    }
+}
 
-        // Collect loaded/generated chunks and update globalChunkMap
-        for (size_t i = 0; i < loadFutures.size(); ++i) {
-            if (std::shared_ptr<Chunk> chunk = loadFutures[i].get()) {
-                {
-                    std::lock_guard lock(chunkMapMutex);
-                    globalChunkMap[chunksToLoad[i]] = chunk;
-                }
-                chunksToSend.emplace_back(chunk);
-            }
+// Runs once the session server has answered, on the auth pool, or on the thread pool in offline mode
+// where auth is null. The skin lookup may still block, though it is usually cached.
+bool completeLogin(ClientConnection& client, const AuthResult* auth) {
+    std::string playerName = client.playerName;
+    std::string playerUUID = client.playerUUID;
+    std::array<uint8_t, 16> uuidBytes = client.uuidBytes;
+
+    if (playerUUID.empty()) {
+        playerUUID = fetchPlayerUUID(playerName);
+        if (playerUUID.empty()) {
+            logMessage("Failed to fetch player UUID for: " + playerName, LOG_ERROR);
+            return false;
         }
+        uuidBytes = stringUUIDToBytes(playerUUID);
+    }
 
-        // Vector to hold futures for sending chunks
-        std::vector<std::future<void>> sendFutures;
-        sendFutures.reserve(chunksToSend.size());
-
-        // Enqueue send tasks
-        for (const auto& chunk : chunksToSend) {
-            sendFutures.emplace_back(
-                threadPool.enqueue([chunk, &client]() -> void {
-                    sendChunkDataToPlayer(client, chunk);
-                })
-            );
+    // ************ Step 3: Online Mode Authentication ************
+    std::pair<std::string, std::string> texturesPair;
+    if (auth) {
+        if (!auth->success) {
+            sendDisconnectionPacket(client, "Authentication with Mojang failed. Disconnecting.");
+            return false;
         }
 
-        for (const auto& chunk : chunksToSend) {
-            player->loadedChunks.insert({chunk->chunkX, chunk->chunkZ});
+        // Verify that the authenticatedName matches the provided playerName
+        if (auth->name != playerName) {
+            logMessage("Player name mismatch: " + auth->name + " != " + playerName, LOG_ERROR);
+            sendDisconnectionPacket(client, "Player name mismatch. Disconnecting.");
+            return false;
         }
 
-        // Wait for all sends to complete
-        for (auto& future : sendFutures) {
-            future.get();
+        playerUUID = auth->uuid;
+        texturesPair = auth->textures;
+        logMessage("Player authenticated: " + auth->name + " (" + auth->uuid + ")", LOG_DEBUG);
+    } else {
+        // Offline Mode: Use the client-provided UUID
+        logMessage("Offline Mode: Using client-provided UUID: " + playerUUID, LOG_DEBUG);
+    }
+
+
+    if (serverConfig.enableCompression) {
+        sendSetCompressionPacket(client, serverConfig.compressionThreshold);
+        client.compressionEnabled = true;
+    }
+
+    // Create a new Player instance
+    std::shared_ptr<Player> newPlayer = EntityFactory::createPlayer(uuidBytes, playerName);
+
+    // Assign a unique Entity ID
+    newPlayer->uuidString = playerUUID;
+    newPlayer->properties = {}; // Populate as needed
+    newPlayer->gameMode = CREATIVE;
+    newPlayer->listed = true;
+    newPlayer->ping = -1; // Unknown initially
+    newPlayer->setClient(&client);
+    if (texturesPair.first.empty() || texturesPair.second.empty()) {
+        texturesPair = fetchPlayerSkin(newPlayer->uuidString);
+        if (!texturesPair.first.empty() && !texturesPair.second.empty()) {
+            newPlayer->properties["textures"] = { texturesPair.first, texturesPair.second };
+        } else {
+            // Assign a default skin if fetching fails
+            std::string defaultSkin = "eyJ0aW1lc3RhbXAiOjE1OTA0ODEyMDAwMDAsInByb2ZpbGVJZCI6InV1aWQiLCJwcm9maWxlTmFtZSI6InBsYXllck5hbWUiLCJ0ZXh0dXJlcyI6eyJTS0lOIjp7InVybCI6Imh0dHA6Ly90ZXh0dXJlcy5taW5lY3JhZnQubmV0L3RleHR1cmUvczg2YzIyYjYyMmY2Y2E3ZTJmZjhkNTYyN2FkNDMxMDgyMjYyYzE5ZTM5MjMxYjI1YjczNGNiZDI0N2EwMjA4ZCJ9fX0=";
+            newPlayer->properties["textures"] = { defaultSkin, "" };
         }
+    } else {
+        newPlayer->properties["textures"] = { texturesPair.first, texturesPair.second };
+    }
 
-        auto chunkCreationTime = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::steady_clock::now() - startTime
-        ).count();
+    // Add the new player to the global player list
+    {
+        std::lock_guard lock(playersMutex);
+        globalPlayers[playerUUID] = newPlayer;
+        globalPlayersName[playerName] = newPlayer;
+    }
 
-        logMessage("Loaded and Sent " + std::to_string(chunksToSend.size()) + " chunks in " + std::to_string(chunkCreationTime) + " ms", LOG_DEBUG);
+    // Increase player count
+    ++playerCount;
+    serverStatus.invalidate();
 
-    };
+    // The connection owns the player from now on
+    client.player = newPlayer;
 
-    // Initialize the world border
-    worldBorder.initialize(serverConfig.worldBorder);
-    sendInitializeWorldBorder(client, worldBorder);
+    // Send Login Success packet
+    PacketWriter writer(LOGIN_SUCCESS);
+    std::vector<uint8_t>& responseData = writer.buffer();
 
-    // Send current chunk to the player
-    sendCurrentChunkToPlayer(client, centerChunkX, centerChunkZ);
+    // Append UUID (16 bytes)
+    responseData.insert(responseData.end(), uuidBytes.begin(), uuidBytes.end());
 
-    updatePlayerChunkView(newPlayer, -1, -1, centerChunkX, centerChunkZ);
+    // Append Username (String)
+    writeString(responseData, newPlayer->name);
 
-    // Asynchronously send chunks to avoid blocking
-    std::thread(sendChunks, newPlayer->currentChunkX, newPlayer->currentChunkZ, newPlayer).detach();
+    // Number Of Properties (VarInt)
+    writeVarInt(responseData, 0); // For now no properties
 
-    // Send Resource Packs
-    sendResourcePacks(client);
+    // Strict Error Handling (Boolean)
+    responseData.push_back(0x00); // TODO: Only in versions before 1.21.2 and 1.20.5+
 
-    // Receive and handle client packets
-    try {
-        while (true) {
-            std::vector<uint8_t> packetData;
-            if (!readPacket(client, packetData)) {
-                disconnectClient(newPlayer, "Player disconnected", false);
-                break;
-            }
+    // Build and send the packet
+    sendPacket(client, writer);
 
-            // Process incoming packets (e.g., Keep Alive Response)
-            handleClientPacket(client, packetData, newPlayer, registryManager);
+    // The socket may have been closed while we were waiting on Mojang
+    if (client.connectionClosed) {
+        handleConnectionClosed(client);
+    }
 
-            std::this_thread::sleep_for(std::chrono::nanoseconds(100)); // Avoid high CPU usage
-        }
+    return true;
+}
+
+static void runCompleteLogin(const std::shared_ptr<ClientConnection>& connection, const AuthResult* auth) {
+    bool success = false;
+    try {
+        success = completeLogin(*connection, auth);
     } catch (const std::exception& e) {
-        disconnectClient(newPlayer, "Player disconnected", false);
-        logMessage("Client disconnected with error: " + std::string(e.what()), LOG_ERROR);
+        logMessage("Login failed with error: " + std::string(e.what()), LOG_ERROR);
+    }
+    if (!success) {
+        connection->connectionClosed = true;
+        shutdownSocket(connection->socket);
     }
-
-    // Clean up
-    keepAliveLoop.join();
 }
 
-bool waitForAcknowledgeFinishConfiguration(const ClientConnection& client) {
-    std::vector<uint8_t> packetData;
-    if (!readPacket(client, packetData)) {
-        return false;
+void finishLogin(ClientConnection& client) {
+    std::shared_ptr<ClientConnection> connection = client.shared_from_this();
+    if (!serverConfig.onlineMode) {
+        // Offline Mode: Nothing to wait for
+        threadPool.enqueue([connection]() {
+            runCompleteLogin(connection, nullptr);
+        });
+        return;
     }
 
-    size_t index = 0;
-    int32_t packetID = parseVarInt(packetData, index);
-    if (packetID != ACKNOWLEDGE_FINISH_CONFIGURATION) {
-        // Expected Acknowledge Finish Configuration packet
-        std::stringstream stringstream;
-        stringstream << "Expected Acknowledge Finish Configuration packet. Instead received: 0x" << std::hex << packetID << std::dec;
-        std::string formattedMessage = stringstream.str();
-        logMessage(formattedMessage, LOG_ERROR);
+    // Step 3.3: Authenticate with Mojang, completeLogin picks up once it answers.
+    // The server hash was computed on the crypto pool along with the shared secret.
+    authenticatePlayerAsync(client.playerName, client.serverHash, getClientIPAddress(client), [connection](const AuthResult& auth) {
+        runCompleteLogin(connection, &auth);
+    });
+}
+
+bool handleLoginStart(ClientConnection& client, PacketReader& reader) {
+    if (!client.playerName.empty()) {
+        logMessage("Received a second Login Start packet", LOG_ERROR);
         return false;
     }
 
-    // No fields to parse
+    std::string playerName(reader.readString(16));
+    // Set UUID for the new player
+    std::array<uint8_t, 16> uuidBytes = reader.readUUID();
+    std::string playerUUID = bytesToUUIDString(uuidBytes);
+    // Remove '-' characters from UUID string
+    std::erase(playerUUID, '-');
+    uuidBytes = stringUUIDToBytes(playerUUID);
 
-    return true;
-}
+    client.playerName = playerName;
+    client.playerUUID = playerUUID;
+    client.uuidBytes = uuidBytes;
+
+    if (!serverConfig.enableEncryption) {
+        finishLogin(client);
+        return true;
+    }
 
-bool waitForClientKnownPacks(const ClientConnection& client) {
-    std::vector<uint8_t> packetData;
-    if (!readPacket(client, packetData)) {
+    // ************ Encryption Start ************
+    // Step 1: Generate a random verify token (16 bytes recommended)
+    if (RAND_bytes(client.verifyToken.data(), client.verifyToken.size()) != 1) {
+        logMessage("Failed to generate verify token", LOG_ERROR);
         return false;
     }
 
-    size_t index = 0;
-    int32_t packetID = parseVarInt(packetData, index);
-    if (packetID != SERVERBOUND_KNOWN_PACKS) {
-        // Expected Known Packs packet
+    // Step 2: Get server's public key in DER format
+    const std::vector<uint8_t>& serverPublicKeyDER = serverKeyPair->getPublicKeyDER();
+
+    // Step 3: Construct Encryption Request packet
+    std::vector<uint8_t> encryptionRequestPacket;
+
+    // Packet ID for Encryption Request
+    writeVarInt(encryptionRequestPacket, 0x01);
+
+    // Server ID (empty string for modern versions)
+    writeString(encryptionRequestPacket, serverConfig.serverId);
+
+    // Public Key Length and Public Key
+    writeVarInt(encryptionRequestPacket, static_cast<int32_t>(serverPublicKeyDER.size()));
+    encryptionRequestPacket.insert(encryptionRequestPacket.end(), serverPublicKeyDER.begin(), serverPublicKeyDER.end());
+
+    // Verify Token Length and Verify Token
+    writeVarInt(encryptionRequestPacket, client.verifyToken.size());
+    encryptionRequestPacket.insert(encryptionRequestPacket.end(), client.verifyToken.begin(), client.verifyToken.end());
+
+    // Should authenticate (boolean)
+    writeByte(encryptionRequestPacket, serverConfig.onlineMode);
+
+    // Send Encryption Request packet
+    if (!sendUnencryptedPacket(client, encryptionRequestPacket)) {
+        logMessage("Failed to send Encryption Request packet", LOG_ERROR);
         return false;
     }
-    size_t packCount = parseVarInt(packetData, index);
 
+    // The Encryption Response continues the login
     return true;
 }
 
-bool waitForClientPluginMessage(const ClientConnection & client, Player& player) {
-    std::vector<uint8_t> packetData;
-    if (!readPacketTimeout(client, packetData, 2, false)) {
+// Runs on the crypto pool: RSA decryption is too slow to do on a network thread during a login flood
+bool setupEncryption(ClientConnection& client, const std::vector<uint8_t>& encryptedSharedSecret, const std::vector<uint8_t>& encryptedVerifyToken) {
+    // Step 5: Decrypt Shared Secret and Verify Token using server's private key
+    std::vector<uint8_t> decryptedSharedSecret = serverKeyPair->decrypt(encryptedSharedSecret);
+    std::vector<uint8_t> decryptedVerifyToken = serverKeyPair->decrypt(encryptedVerifyToken);
+
+    // Step 6: Verify that the decrypted verify token matches the original
+    if (decryptedVerifyToken.size() != client.verifyToken.size() ||
+        std::memcmp(decryptedVerifyToken.data(), client.verifyToken.data(), client.verifyToken.size()) != 0) {
+        logMessage("Verify token mismatch", LOG_ERROR);
         return false;
     }
 
-    size_t index = 0;
-    int32_t packetID = parseVarInt(packetData, index);
-    if (packetID != LOGIN_PLUGIN_RESPONSE) {
-        // Expected Plugin Message packet
+    // Step 7: Store the shared secret
+    if (decryptedSharedSecret.size() < 16) { // AES-128 requires at least 16 bytes
+        logMessage("Invalid shared secret size", LOG_ERROR);
         return false;
     }
+    std::copy_n(decryptedSharedSecret.begin(), 16, client.sharedSecret.begin());
 
-    handlePluginMessage(client, packetData, index, player);
-
-    return true;
-}
+    // Step 8: Initialize AES/CFB8 encryption and decryption contexts
+    client.encryptCtx = EVP_CIPHER_CTX_new();
+    client.decryptCtx = EVP_CIPHER_CTX_new();
+    if (!client.encryptCtx || !client.decryptCtx) {
+        logMessage("Failed to create AES cipher contexts", LOG_ERROR);
+        sendDisconnectionPacket(client, "Failed to create AES cipher contexts");
+        return false;
+    }
 
-bool waitforClientInfo(const ClientConnection & client, Player& player) {
-    std::vector<uint8_t> packetData;
-    if (!readPacket(client, packetData)) {
+    // Initialize encryption context (AES-128-CFB8)
+    if (EVP_EncryptInit_ex(client.encryptCtx, EVP_aes_128_cfb8(), nullptr, client.sharedSecret.data(), client.sharedSecret.data()) != 1) {
+        logMessage("Failed to initialize AES encryption context", LOG_ERROR);
+        sendDisconnectionPacket(client, "Failed to initialize AES encryption context");
         return false;
     }
 
-    size_t index = 0;
-    int32_t packetID = parseVarInt(packetData, index);
-    if (packetID != CLIENT_INFORMATION) {
-        // Expected Client Info packet
+    // Initialize decryption context (AES-128-CFB8)
+    if (EVP_DecryptInit_ex(client.decryptCtx, EVP_aes_128_cfb8(), nullptr, client.sharedSecret.data(), client.sharedSecret.data()) != 1) {
+        logMessage("Failed to initialize AES decryption context", LOG_ERROR);
+        sendDisconnectionPacket(client, "Failed to initialize AES decryption context");
         return false;
     }
 
-    return handleClientInformation(player, packetData, index);
+    // ************ Encryption Setup Complete ************
+    if (serverConfig.onlineMode) {
+        client.serverHash = computeServerHash(serverConfig.serverId, client.sharedSecret, serverKeyPair->getPublicKeyDER());
+    }
+    return true;
 }
 
-bool handleConfigurationState(ClientConnection& client, RegistryManager& registryManager, Player& player) {
+// Logins waiting for or in RSA decryption, beyond which new ones are refused
+constexpr int MAX_PENDING_CRYPTO_JOBS = 256;
+static std::atomic<int> pendingCryptoJobs(0);
 
-    waitForClientPluginMessage(client, player);
+static thread_pool& cryptoPool() {
+    static thread_pool pool(serverConfig.cryptoThreads);
+    return pool;
+}
 
-    if (!waitforClientInfo(client, player)) {
-        // Handle error or disconnection
+bool handleEncryptionResponse(ClientConnection& client, PacketReader& reader) {
+    if (client.playerName.empty() || client.decryptCtx) {
+        logMessage("Unexpected Encryption Response packet", LOG_ERROR);
         return false;
     }
 
-    sendServerPluginMessages(client);
+    // Parse Encryption Response
+    // Encrypted Shared Secret
+    std::span<const uint8_t> sharedSecretBytes = reader.readByteArray(512);
+    std::vector<uint8_t> encryptedSharedSecret(sharedSecretBytes.begin(), sharedSecretBytes.end());
 
-    sendKnownPacksPacket(client);
+    // Encrypted Verify Token
+    std::span<const uint8_t> verifyTokenBytes = reader.readByteArray(512);
+    std::vector<uint8_t> encryptedVerifyToken(verifyTokenBytes.begin(), verifyTokenBytes.end());
 
-    if (!waitForClientKnownPacks(client)) {
-        // Handle error or disconnection
+    // Refuse logins rather than let the backlog grow without bound
+    if (pendingCryptoJobs.load() >= MAX_PENDING_CRYPTO_JOBS) {
+        logMessage("Too many logins waiting on the crypto pool, refusing " + client.playerName, LOG_WARNING);
+        sendDisconnectionPacket(client, "The server is busy, please try again.");
         return false;
     }
 
-    // Send Registry Data packet
-    sendRegistryDataPacket(client, registryManager);
-
-    // Update tags
-    sendUpdateTagsPacket(client);
-
-    // Send server links
-    sendServerLinksPacket(client);
-
-    // Send Finish Configuration packet
-    sendFinishConfigurationPacket(client);
-
-    // Wait for Acknowledge Finish Configuration from the client
-    if (!waitForAcknowledgeFinishConfiguration(client)) {
-        logMessage("Failed to receive Acknowledge Finish Configuration packet", LOG_ERROR);
+    client.cryptoPending = true;
+    ++pendingCryptoJobs;
+    std::shared_ptr<ClientConnection> connection = client.shared_from_this();
+    try {
+        cryptoPool().enqueue([connection, encryptedSharedSecret = std::move(encryptedSharedSecret), encryptedVerifyToken = std::move(encryptedVerifyToken)]() {
+            bool success = false;
+            try {
+                success = setupEncryption(*connection, encryptedSharedSecret, encryptedVerifyToken);
+            } catch (const std::exception& e) {
+                logMessage("Encryption setup failed with error: " + std::string(e.what()), LOG_ERROR);
+            }
+            --pendingCryptoJobs;
+            if (!success) {
+                connection->connectionClosed = true;
+                shutdownSocket(connection->socket);
+                return;
+            }
+            // Publishes the cipher contexts to the network thread
+            connection->cryptoPending.store(false, std::memory_order_release);
+            if (!connection->connectionClosed) {
+                finishLogin(*connection);
+            }
+        });
+    } catch (const std::exception&) {
+        // Shutting down
+        --pendingCryptoJobs;
         return false;
     }
-
     return true;
 }
 
-void handleLoginRequest(ClientConnection& client, RegistryManager& registryManager) {
-    // Read Login Start packet
-    std::vector<uint8_t> packetData;
-    if (!readUnencryptedPacket(client, packetData)) {
-        return;
-    }
-
-    size_t index = 0;
-    int32_t packetID = parseVarInt(packetData, index);
-    if (packetID != 0x00) {
-        return;
+bool handleLoginPacket(ClientConnection& client, PacketReader& reader) {
+    switch (int32_t packetID = reader.readVarInt()) {
+        case LOGIN_START: // Login Start
+            return handleLoginStart(client, reader);
+        case ENCRYPTION_RESPONSE: // Encryption Response
+            return handleEncryptionResponse(client, reader);
+        case LOGIN_PLUGIN_RESPONSE: // Login Plugin Response
+            return true;
+        case LOGIN_ACKNOWLEDGE: // Login Acknowledged
+            if (!client.player) {
+                logMessage("Received Login Acknowledged before Login Success", LOG_ERROR);
+                return false;
+            }
+            // Now in Configuration state
+            client.state = ClientState::Configuration;
+            return true;
+        default:
+            logMessage("Unexpected login packet ID: " + std::to_string(packetID), LOG_ERROR);
+            return false;
     }
+}
 
-    std::string playerName = parseString(packetData, index);
-    // Set UUID for the new player
-    std::vector<uint8_t> uuidBytesVec = parseBytes(packetData, index, 16);
-    // Convert to std::array
-    std::array<uint8_t, 16> uuidBytes = { };
-    std::ranges::copy(uuidBytesVec, uuidBytes.begin());
-    std::string playerUUID = bytesToUUIDString(uuidBytes);
-    // Remove '-' characters from UUID string
-    std::erase(playerUUID, '-');
-    uuidBytes = stringUUIDToBytes(playerUUID);
+bool handleStatusPacket(ClientConnection& client, PacketReader& reader) {
+    int32_t packetID = reader.readVarInt();
 
-    if (playerUUID.empty()) {
-        playerUUID = fetchPlayerUUID(playerName);
-        if (playerUUID.empty()) {
-            logMessage("Failed to fetch player UUID for: " + playerName, LOG_ERROR);
-            return;
-        }
-        uuidBytes = stringUUIDToBytes(playerUUID);
+    if (packetID == STATUS_REQUEST) {
+        // The response is serialized once per change of the player list, MOTD or icon
+        return sendPacket(client, serverStatus.current()->statusResponse);
     }
 
-     // ************ Encryption Start ************
-    if (serverConfig.enableEncryption) {
-        // Step 1: Generate a random verify token (16 bytes recommended)
-        std::array<uint8_t, 16> verifyToken{};
-        if (RAND_bytes(verifyToken.data(), verifyToken.size()) != 1) {
-            logMessage("Failed to generate verify token", LOG_ERROR);
-            return;
-        }
-
-        // Step 2: Get server's public key in DER format
-        std::vector<uint8_t> serverPublicKeyDER = registryManager.getRSAKeyPair().getPublicKeyDER();
-
-        // Step 3: Construct Encryption Request packet
-        std::vector<uint8_t> encryptionRequestPacket;
+    if (packetID == PING_REQUEST) {
+        // Ping packet
+        std::vector<uint8_t> pongData;
+        pongData.push_back(PONG_RESPONSE);
+        std::span<const uint8_t> payload = reader.readBytes(8);
+        pongData.insert(pongData.end(), payload.begin(), payload.end());
+        sendUnencryptedPacket(client, pongData);
+    }
 
-        // Packet ID for Encryption Request
-        writeVarInt(encryptionRequestPacket, 0x01);
+    // The status exchange ends with the pong
+    return false;
+}
 
-        // Server ID (empty string for modern versions)
-        writeString(encryptionRequestPacket, serverConfig.serverId);
+bool handleHandshake(ClientConnection& client, PacketReader& reader) {
+    int32_t packetID = reader.readVarInt();
+    if (packetID != HANDSHAKE) {
+        logMessage("Invalid Handshake packet ID: " + std::to_string(packetID), LOG_ERROR);
+        return false;
+    }
 
-        // Public Key Length and Public Key
-        writeVarInt(encryptionRequestPacket, static_cast<int32_t>(serverPublicKeyDER.size()));
-        encryptionRequestPacket.insert(encryptionRequestPacket.end(), serverPublicKeyDER.begin(), serverPublicKeyDER.end());
+    // Handshake packet
+    int32_t protocolVersion = reader.readVarInt();
+    std::string_view serverAddress = reader.readString(255);
+    reader.readShort(); // Server Port (Unsigned Short)
+    int32_t nextState = reader.readVarInt();
 
-        // Verify Token Length and Verify Token
-        writeVarInt(encryptionRequestPacket, verifyToken.size());
-        encryptionRequestPacket.insert(encryptionRequestPacket.end(), verifyToken.begin(), verifyToken.end());
+    if (nextState == 1) {
+        // Status Request
+        client.state = ClientState::Status;
+        return true;
+    }
+    if (nextState == 2) {
+        // Login Request
+        client.registryManager = std::make_shared<RegistryManager>();
+        client.state = ClientState::Login;
+        return true;
+    }
+    return false;
+}
 
-        // Should authenticate (boolean)
-        writeByte(encryptionRequestPacket, serverConfig.onlineMode);
+bool handleClientData(ClientConnection& client) {
+    // Only used for packets that arrive compressed, the rest are read where they were received
+    std::vector<uint8_t> decompressed;
 
-        // Send Encryption Request packet
-        if (!sendUnencryptedPacket(client, encryptionRequestPacket)) {
-            logMessage("Failed to send Encryption Request packet", LOG_ERROR);
-            return;
+    while (!client.connectionClosed) {
+        // Anything after the Encryption Response is encrypted with a key that is still being decrypted.
+        // The client waits for Login Success before it sends more, which brings us back here.
+        if (client.cryptoPending.load(std::memory_order_acquire)) {
+            return true;
         }
 
-        // Step 4: Receive Encryption Response packet
-        std::vector<uint8_t> encryptionResponseData;
-        if (!readUnencryptedPacket(client, encryptionResponseData)) {
-            logMessage("Failed to read Encryption Response packet", LOG_ERROR);
-            return;
+        std::span<const uint8_t> packet;
+        PacketReadResult result = extractPacket(client, decompressed, packet);
+        if (result == PacketReadResult::Incomplete) {
+            return true;
         }
-
-        size_t respIndex = 0;
-        int32_t respPacketID = parseVarInt(encryptionResponseData, respIndex);
-        if (respPacketID != 0x01) {
-            logMessage("Invalid Encryption Response packet ID: " + std::to_string(respPacketID) + " (expected 0x01)", LOG_ERROR);
-            return;
+        if (result == PacketReadResult::Error) {
+            return false;
         }
 
-        // Parse Encryption Response
-        // Encrypted Shared Secret
-        int32_t encryptedSharedSecretLength = parseVarInt(encryptionResponseData, respIndex);
-        std::vector<uint8_t> encryptedSharedSecret = parseBytes(encryptionResponseData, respIndex, encryptedSharedSecretLength);
-
-        // Encrypted Verify Token
-        int32_t encryptedVerifyTokenLength = parseVarInt(encryptionResponseData, respIndex);
-        std::vector<uint8_t> encryptedVerifyToken = parseBytes(encryptionResponseData, respIndex, encryptedVerifyTokenLength);
-
-        // Step 5: Decrypt Shared Secret and Verify Token using server's private key
-        std::vector<uint8_t> decryptedSharedSecret = registryManager.getRSAKeyPair().decrypt(encryptedSharedSecret);
-        std::vector<uint8_t> decryptedVerifyToken = registryManager.getRSAKeyPair().decrypt(encryptedVerifyToken);
-
-        // Step 6: Verify that the decrypted verify token matches the original
-        if (decryptedVerifyToken.size() != verifyToken.size() ||
-            std::memcmp(decryptedVerifyToken.data(), verifyToken.data(), verifyToken.size()) != 0) {
-            logMessage("Verify token mismatch", LOG_ERROR);
-            return;
+        PacketReader reader(packet);
+        bool keepOpen = true;
+        try {
+            switch (client.state) {
+                case ClientState::Handshake:
+                    keepOpen = handleHandshake(client, reader);
+                    break;
+                case ClientState::Status:
+                    keepOpen = handleStatusPacket(client, reader);
+                    break;
+                case ClientState::Login:
+                    keepOpen = handleLoginPacket(client, reader);
+                    break;
+                case ClientState::Configuration:
+                    keepOpen = handleConfigurationPacket(client, reader);
+                    break;
+                case ClientState::Play:
+                case ClientState::AwaitingTeleportConfirm:
+                    // Game state is only changed on the tick thread, which picks these up at the start of its next tick
+                    if (client.ingest.size() >= MAX_INGEST_PACKETS) {
+                        logMessage("Player " + client.playerName + " is sending packets faster than they can be handled", LOG_WARNING);
+                        return false;
+                    }
+                    client.ingest.push(reader.readVarInt(), packet);
+                    break;
             }
-
-        // Step 7: Store the shared secret
-        if (decryptedSharedSecret.size() < 16) { // AES-128 requires at least 16 bytes
-            logMessage("Invalid shared secret size", LOG_ERROR);
-            return;
-        }
-        std::copy_n(decryptedSharedSecret.begin(), 16, client.sharedSecret.begin());
-
-        // Step 8: Initialize AES/CFB8 encryption and decryption contexts
-        client.encryptCtx = EVP_CIPHER_CTX_new();
-        client.decryptCtx = EVP_CIPHER_CTX_new();
-        if (!client.encryptCtx || !client.decryptCtx) {
-            logMessage("Failed to create AES cipher contexts", LOG_ERROR);
-            sendDisconnectionPacket(client, "Failed to create AES cipher contexts");
-            return;
+        } catch (const PacketReadError& e) {
+            std::string sender = client.playerName.empty() ? "a client" : client.playerName;
+            logMessage("Malformed packet from " + sender + ": " + e.what(), LOG_ERROR);
+            return false;
         }
 
-        // Initialize encryption context (AES-128-CFB8)
-        if (EVP_EncryptInit_ex(client.encryptCtx, EVP_aes_128_cfb8(), nullptr, client.sharedSecret.data(), client.sharedSecret.data()) != 1) {
-            logMessage("Failed to initialize AES encryption context", LOG_ERROR);
-            sendDisconnectionPacket(client, "Failed to initialize AES encryption context");
-            return;
-        }
-
-        // Initialize decryption context (AES-128-CFB8)
-        if (EVP_DecryptInit_ex(client.decryptCtx, EVP_aes_128_cfb8(), nullptr, client.sharedSecret.data(), client.sharedSecret.data()) != 1) {
-            logMessage("Failed to initialize AES decryption context", LOG_ERROR);
-            sendDisconnectionPacket(client, "Failed to initialize AES decryption context");
-            return;
+        if (!keepOpen) {
+            return false;
         }
     }
 
-    // ************ Encryption Setup Complete ************
-
-    // ************ Step 3: Online Mode Authentication ************
-    std::pair<std::string, std::string> texturesPair;
-    if (serverConfig.onlineMode) {
-        // Step 3.1: Compute Server Hash
-        std::string serverId = serverConfig.serverId; // Ensure you have initialized server_id
-        std::string serverHash = computeServerHash(serverId, client.sharedSecret, registryManager.getRSAKeyPair().getPublicKeyDER());
-
-        // Step 3.2: Get Client's IP Address
-        std::string clientIP = getClientIPAddress(client);
-
-        // Step 3.3: Authenticate with Mojang
-        std::string authenticatedUUID;
-        std::string authenticatedName;
-        bool authSuccess = authenticatePlayer(playerName, serverHash, clientIP, authenticatedUUID, authenticatedName, texturesPair);
-
-        if (!authSuccess) {
-            sendDisconnectionPacket(client, "Authentication with Mojang failed. Disconnecting.");
-            return;
-        }
+    return false;
+}
 
-        // Verify that the authenticatedName matches the provided playerName
-        if (authenticatedName != playerName) {
-            logMessage("Player name mismatch: " + authenticatedName + " != " + playerName, LOG_ERROR);
-            sendDisconnectionPacket(client, "Player name mismatch. Disconnecting.");
-            return;
+// Drops movement packets that a later one in the same run of movement packets fully replaces
+static void coalesceMovement(std::vector<std::unique_ptr<IngestPacket>>& packets) {
+    bool laterPosition = false;
+    bool laterRotation = false;
+    bool laterMovement = false;
+    for (auto it = packets.rbegin(); it != packets.rend(); ++it) {
+        int32_t packetID = (*it)->packetID;
+        bool hasPosition = packetID == PLAYER_POSITION || packetID == PLAYER_POSITION_AND_ROTATION;
+        bool hasRotation = packetID == Player_ROTATION || packetID == PLAYER_POSITION_AND_ROTATION;
+        if (!hasPosition && !hasRotation && packetID != PLAYER_ON_GROUND) {
+            // Anything else may depend on where the player was when they sent it
+            laterPosition = false;
+            laterRotation = false;
+            laterMovement = false;
+            continue;
         }
-
-        playerUUID = authenticatedUUID;
-        logMessage("Player authenticated: " + authenticatedName + " (" + authenticatedUUID + ")", LOG_DEBUG);
-    } else {
-        // Offline Mode: Use the client-provided UUID
-        logMessage("Offline Mode: Using client-provided UUID: " + playerUUID, LOG_DEBUG);
-    }
-
-
-    if (serverConfig.enableCompression) {
-        sendSetCompressionPacket(client, serverConfig.compressionThreshold);
-        client.compressionEnabled = true;
-    }
-
-    // Create a new Player instance
-    std::shared_ptr<Player> newPlayer = EntityFactory::createPlayer(uuidBytes, playerName);
-
-    // Assign a unique Entity ID
-    newPlayer->uuidString = playerUUID;
-    newPlayer->properties = {}; // Populate as needed
-    newPlayer->gameMode = CREATIVE;
-    newPlayer->listed = true;
-    newPlayer->ping = -1; // Unknown initially
-    newPlayer->setClient(&client);
-    if (texturesPair.first.empty() || texturesPair.second.empty()) {
-        texturesPair = fetchPlayerSkin(newPlayer->uuidString);
-        if (!texturesPair.first.empty() && !texturesPair.second.empty()) {
-            newPlayer->properties["textures"] = { texturesPair.first, texturesPair.second };
-        } else {
-            // Assign a default skin if fetching fails
-            std::string defaultSkin = "eyJ0aW1lc3RhbXAiOjE1OTA0ODEyMDAwMDAsInByb2ZpbGVJZCI6InV1aWQiLCJwcm9maWxlTmFtZSI6InBsYXllck5hbWUiLCJ0ZXh0dXJlcyI6eyJTS0lOIjp7InVybCI6Imh0dHA6Ly90ZXh0dXJlcy5taW5lY3JhZnQubmV0L3RleHR1cmUvczg2YzIyYjYyMmY2Y2E3ZTJmZjhkNTYyN2FkNDMxMDgyMjYyYzE5ZTM5MjMxYjI1YjczNGNiZDI0N2EwMjA4ZCJ9fX0=";
-            newPlayer->properties["textures"] = { defaultSkin, "" };
+        // Every movement packet carries the on ground flag
+        if (laterMovement && (!hasPosition || laterPosition) && (!hasRotation || laterRotation)) {
+            it->reset();
+            continue;
         }
-    } else {
-        newPlayer->properties["textures"] = { texturesPair.first, texturesPair.second };
+        laterMovement = true;
+        laterPosition |= hasPosition;
+        laterRotation |= hasRotation;
     }
+}
 
-    // Add the new player to the global player list
+// Runs on the tick thread at the start of each tick
+void processIngestedPackets() {
+    std::vector<std::shared_ptr<ClientConnection>> clients;
     {
-        std::lock_guard lock(playersMutex);
-        globalPlayers[playerUUID] = newPlayer;
-        globalPlayersName[playerName] = newPlayer;
+        std::lock_guard lock(connectedClientsMutex);
+        clients.reserve(connectedClients.size());
+        for (ClientConnection* client : connectedClients | std::views::values) {
+            if (std::shared_ptr<ClientConnection> connection = client->weak_from_this().lock()) {
+                clients.push_back(std::move(connection));
+            }
+        }
     }
 
-    // Increase player count
-    ++playerCount;
-
-    // Send Login Success packet
-    std::vector<uint8_t> responseData;
-    responseData.push_back(LOGIN_SUCCESS);
-
-    // Append UUID (16 bytes)
-    responseData.insert(responseData.end(), uuidBytes.begin(), uuidBytes.end());
-
-    // Append Username (String)
-    writeString(responseData, newPlayer->name);
-
-    // Number Of Properties (VarInt)
-    writeVarInt(responseData, 0); // For now no properties
-
-    // Strict Error Handling (Boolean)
-    responseData.push_back(0x00); // TODO: Only in versions before 1.21.2 and 1.20.5+
-
-    // Build and send the packet
-    sendPacket(client, responseData);
+    std::vector<std::unique_ptr<IngestPacket>> packets;
+    for (const std::shared_ptr<ClientConnection>& client : clients) {
+        packets.clear();
+        while (packets.size() < MAX_INGEST_PACKETS) {
+            std::unique_ptr<IngestPacket> packet = client->ingest.pop();
+            if (!packet) {
+                break;
+            }
+            packets.push_back(std::move(packet));
+        }
+        coalesceMovement(packets);
 
-    // ************ Wait for Login Acknowledged Packet ************
-    std::vector<uint8_t> ackPacket;
-    if (!readPacket(client, ackPacket)) {
-        logMessage("Failed to read Login Acknowledged packet", LOG_ERROR);
-        return;
+        for (const std::unique_ptr<IngestPacket>& packet : packets) {
+            if (client->connectionClosed) {
+                break;
+            }
+            if (!packet) {
+                continue; // Coalesced
+            }
+            PacketReader reader(packet->data);
+            try {
+                handleClientPacket(*client, reader, client->player, *client->registryManager);
+            } catch (const PacketReadError& e) {
+                logMessage("Malformed packet from " + client->playerName + ": " + e.what(), LOG_ERROR);
+                // The network thread cleans up once it sees the socket shut down
+                client->connectionClosed = true;
+                shutdownSocket(client->socket);
+            } catch (const std::exception& e) {
+                // Don't let one player's packet take the tick thread down
+                logMessage("Failed to handle packet from " + client->playerName + ": " + e.what(), LOG_ERROR);
+                client->connectionClosed = true;
+                shutdownSocket(client->socket);
+            }
+        }
     }
+}
 
-    size_t ackIndex = 0;
-    int32_t ackPacketID = parseVarInt(ackPacket, ackIndex);
-    if (ackPacketID != LOGIN_ACKNOWLEDGE) {
-        logMessage("Expected Login Acknowledged packet (ID 0x03), but received packet ID: " + ackPacketID, LOG_ERROR);
+void handleConnectionClosed(ClientConnection& client) {
+    client.connectionClosed = true;
+    if (!client.player) {
         return;
     }
 
-    // Now in Configuration state
-    client.state = ClientState::Configuration;
-    if(!handleConfigurationState(client, registryManager, *newPlayer)) {
-        return;
+    if (client.state == ClientState::Play || client.state == ClientState::AwaitingTeleportConfirm) {
+        disconnectClient(client.player, "Player disconnected", false);
+    } else if (!client.disconnected.exchange(true)) {
+        // Logged in but never reached the world
+        std::lock_guard lock(playersMutex);
+        globalPlayersName.erase(client.player->name);
+        globalPlayers.erase(client.player->uuidString);
+        --playerCount;
+        serverStatus.invalidate();
     }
-
-    sendTranslatedChatMessage("multiplayer.player.joined", false, "yellow", nullptr, true, newPlayer->name);
-
-    // Now in Play state
-    client.state = ClientState::Play;
-    handlePlayState(client, newPlayer, registryManager);
 }
 
+// Blocking fallback for platforms without the epoll reactor
 void handleClient(SocketType clientSocket) {
-    ClientConnection client;
-    client.socket = clientSocket;
-    client.state = ClientState::Handshake;
+    std::shared_ptr<ClientConnection> client = std::make_shared<ClientConnection>();
+    client->socket = clientSocket;
+    client->state = ClientState::Handshake;
 
     // Set a timeout for the socket
 #ifdef _WIN32
-    DWORD timeout = 5000; // 5 seconds
+    DWORD timeout = 30000; // 30 seconds
     setsockopt(clientSocket, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char *>(&timeout), sizeof(timeout));
 #else
     struct timeval tv;
-    tv.tv_sec = 5;
+    tv.tv_sec = 30;
     tv.tv_usec = 0;
     setsockopt(clientSocket, SOL_SOCKET, SO_RCVTIMEO, (const char*)&tv, sizeof(tv));
 #endif
 
     try {
-        // Read initial packet (Handshake)
-        std::vector<uint8_t> packetData;
-        if (!readUnencryptedPacket(client, packetData)) {
-            // Close socket and return
-            return;
-        }
-
-        size_t index = 0;
-        int32_t packetID = parseVarInt(packetData, index);
-
-        if (packetID == HANDSHAKE) {
-            // Handshake packet
-            int32_t protocolVersion = parseVarInt(packetData, index);
-            std::string serverAddress = parseString(packetData, index);
-            uint16_t serverPort = (packetData[index] << 8) | packetData[index + 1];
-            index += 2;
-            int32_t nextState = parseVarInt(packetData, index);
-
-            if (nextState == 1) {
-                // Status Request
-                handleStatusRequest(client);
-            } else if (nextState == 2) {
-                RegistryManager registryManager;
-                // Login Request
-                handleLoginRequest(client, registryManager);
-            }
-        } else {
-            logMessage("Invalid Handshake packet ID: " + packetID, LOG_ERROR);
-            return;
+        while (receiveIntoBuffer(*client) > 0 && handleClientData(*client)) {
+            flushPackets(*client);
         }
     } catch (const std::exception& e) {
         logMessage("Client disconnected with error: " + std::string(e.what()), LOG_ERROR);
-        sendDisconnectionPacket(client, "Disconnected with error");
     }
 
-    // Close socket
-#ifdef _WIN32
-    closesocket(clientSocket);
-#else
-    close(clientSocket);
-#endif
+    handleConnectionClosed(*client);
+    shutdownSocket(clientSocket);
 }
-
-
@@ -2,15 +2,27 @@
 #define CLIENT_H
 
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
 #include <unordered_set>
 #include <openssl/types.h>
 
+#include "inbound_buffer.h"
+#include "ingest_queue.h"
 #include "network.h"
+#include "outbound_lanes.h"
+#include "outbound_queue.h"
+#include "utils/timer_wheel.h"
 
 struct Player;
+struct PendingFrame;
+class PacketReader;
+class RegistryManager;
 
 enum class ClientState {
     Handshake,
@@ -21,29 +33,64 @@ enum class ClientState {
     AwaitingTeleportConfirm,
 };
 
-struct ClientConnection {
-    SocketType socket;
-    ClientState state;
+struct ClientConnection : std::enable_shared_from_this<ClientConnection> {
+    SocketType socket = INVALID_SOCKET;
+    ClientState state = ClientState::Handshake;
 
-    EVP_CIPHER_CTX* encryptCtx;
-    EVP_CIPHER_CTX* decryptCtx;
+    EVP_CIPHER_CTX* encryptCtx = nullptr;
+    EVP_CIPHER_CTX* decryptCtx = nullptr;
     // Shared secret
     std::array<uint8_t, 16> sharedSecret;
 
     bool compressionEnabled = false;
     std::mutex sendMutex;
+    OutboundQueue outbound; // Guarded by sendMutex
+    OutboundLanes lanes;    // Guarded by sendMutex
+    // Frames queued behind a packet that is still being compressed. Guarded by sendMutex.
+    std::deque<std::shared_ptr<PendingFrame>> pendingFrames;
+    // Hands a flush to the I/O thread that owns the socket, set by NetworkReactor
+    std::function<void()> flushHandler;
 
     // For teleport confirmation tracking
     std::mutex mutex;
     std::unordered_set<int32_t> pendingTeleportIDs;
-    bool connectionClosed = false;
-    int64_t keepAliveID = 0;
+    std::atomic<bool> connectionClosed = false;
+    std::atomic<bool> disconnected = false;
+    // Kicked: what was queued before the kick is still written, then the I/O thread shuts the socket down
+    std::atomic<bool> closing = false;
+    std::chrono::steady_clock::time_point closeDeadline; // Set before closing
+    std::atomic<int64_t> keepAliveID = 0;
+    std::atomic<bool> keepAlivePending = false; // Sent a Keep Alive that has not been answered yet
+    TimerId keepAliveTimer = 0;
+
+    // Inbound bytes that have not formed a complete packet yet
+    InboundBuffer inbound;
+    // Play packets waiting for the tick thread
+    IngestQueue ingest;
+    std::chrono::steady_clock::time_point lastReceived = std::chrono::steady_clock::now();
+
+    // Login / Configuration context
+    std::string playerName;
+    std::string playerUUID;
+    std::array<uint8_t, 16> uuidBytes{};
+    std::array<uint8_t, 16> verifyToken{};
+    std::string serverHash; // Session server hash, computed with the shared secret
+    // Set while the crypto pool decrypts the Encryption Response, nothing is read until it is done
+    std::atomic<bool> cryptoPending = false;
+    std::shared_ptr<RegistryManager> registryManager;
+    std::shared_ptr<Player> player;
+
+    ~ClientConnection();
 };
 
 void disconnectClient(const std::shared_ptr<Player>& player, const std::string& reason, bool disconnectPacket);
+bool handleClientData(ClientConnection& client);
+// Handles one Play packet (Packet ID + Data) on the tick thread
+void handleClientPacket(ClientConnection& client, PacketReader& reader, const std::shared_ptr<Player>& player, const RegistryManager& registryManager);
+void processIngestedPackets();
+void handleConnectionClosed(ClientConnection& client);
 void handleClient(SocketType clientSock);
 void handleConsoleCommand(const std::string & command);
-void miningScheduler(std::unordered_map<std::string, std::shared_ptr<Player>> &players, std::atomic<bool> &running);
 
 
 #endif // CLIENT_H
@@ -6,6 +6,7 @@
 #include "registries/dimension_type.h"
 #include "network.h"
 #include "packet_ids.h"
+#include "shared_frame.h"
 #include "registries/painting_variant.h"
 #include "entities/player.h"
 #include "registries/registry_manager.h"
@@ -16,23 +17,31 @@
 #include "utils/translation.h"
 #include "world/boss_bar.h"
 
-void sendRemoveEntityPacket(const int32_t& entityID) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(REMOVE_ENTITIES);
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+
+constexpr const char* REGISTRY_DATA_FILE = "../resources/registry_data.json";
+
+void sendRemoveEntityPacket(ClientConnection& client, const std::vector<int32_t>& entityIDs) {
+    PacketWriter writer(REMOVE_ENTITIES);
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     // Number of Entities (VarInt)
-    writeVarInt(packetData, 1);
+    writeVarInt(packetData, static_cast<int32_t>(entityIDs.size()));
 
     // Entity IDs (VarInt)
-    writeVarInt(packetData, entityID);
+    for (const int32_t entityID : entityIDs) {
+        writeVarInt(packetData, entityID);
+    }
 
-    // Build and send the packet to all clients
-    broadcastToOthers(packetData);
+    // Build and send the packet
+    sendPacket(client, writer);
 }
 
 void sendPlayerInfoRemove(const std::shared_ptr<Player>& player) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(PLAYER_INFO_REMOVE);
+    PacketWriter writer(PLAYER_INFO_REMOVE);
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     // Number Of Players (VarInt)
     writeVarInt(packetData, 1); // Removing one player
@@ -41,24 +50,42 @@ void sendPlayerInfoRemove(const std::shared_ptr<Player>& player) {
     packetData.insert(packetData.end(), player->uuid.begin(), player->uuid.end());
 
     // Send to all connected clients
-    std::lock_guard lock(connectedClientsMutex);
-    for (auto &existingClient: connectedClients | std::views::values) {
-        sendPacket(*existingClient, packetData);
-    }
+    broadcastToOthers(writer);
 }
 
-void sendRegistryDataPacket(ClientConnection& client, RegistryManager& registryManager) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(REGISTRY_DATA);
+static const std::vector<ChatType>& chatTypes() {
+    static const std::vector<ChatType> types = {
+        {
+            "minecraft:chat",
+            "chat.type.text",
+            {"sender", "content"} // senderName, message
+        },
+        {
+            "minecraft:system",
+            "chat.type.system",
+            {"content"} // message
+        },
+        {
+            "minecraft:announcement",
+            "chat.type.announcement",
+            {"sender"} // announcement message
+        }
+    };
+    return types;
+}
+
+static bool buildRegistryData(std::vector<std::shared_ptr<const SharedFrame>>& frames) {
+    PacketWriter writer(REGISTRY_DATA);
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     // --- Registry 1: dimension_type ---
     writeString(packetData, "minecraft:dimension_type"); // Registry Identifier
 
     // 5. Data (NBT)
     std::vector<DimensionType> dimensions;
-    if (!loadDimensionTypesFromCompoundFile("../resources/registry_data.json", dimensions)) {
+    if (!loadDimensionTypesFromCompoundFile(REGISTRY_DATA_FILE, dimensions)) {
         logMessage("Failed to load dimension data.", LOG_ERROR);
-        return;
+        return false;
     }
 
     // Number of entries in dimension_type
@@ -80,19 +107,18 @@ void sendRegistryDataPacket(ClientConnection& client, RegistryManager& registryM
         packetData.insert(packetData.end(), nbtDimenionTypeData.begin(), nbtDimenionTypeData.end());
     }
 
-    // Build and send the packet
-    sendPacket(client, packetData);
+    // Build the packet
+    frames.push_back(std::make_shared<const SharedFrame>(writer.payload()));
 
     // --- Registry 2: biome ---
-    packetData.clear();
-    packetData.push_back(REGISTRY_DATA);
+    writer.reset(REGISTRY_DATA);
     writeString(packetData, "minecraft:worldgen/biome"); // Registry Identifier
 
     // Load biomes
     std::vector<BiomeRegistryEntry> biomeEntries;
-    if (!loadBiomesFromCompoundFile("../resources/registry_data.json", biomeEntries)) {
+    if (!loadBiomesFromCompoundFile(REGISTRY_DATA_FILE, biomeEntries)) {
         logMessage("Failed to load biomes from registry_data.json.", LOG_ERROR);
-        return;
+        return false;
     }
 
     // Number of entries in biome
@@ -128,19 +154,18 @@ void sendRegistryDataPacket(ClientConnection& client, RegistryManager& registryM
         }
     }
 
-    // Build and send the packet
-    sendPacket(client, packetData);
+    // Build the packet
+    frames.push_back(std::make_shared<const SharedFrame>(writer.payload()));
 
     // --- Registry 3: painting_variant ---
-    packetData.clear();
-    packetData.push_back(REGISTRY_DATA);
+    writer.reset(REGISTRY_DATA);
     writeString(packetData, "minecraft:painting_variant"); // Registry Identifier
 
     // Load painting variants
     std::vector<PaintingVariant> paintingVariants;
-    if (!loadPaintingVariantsFromCompoundFile("../resources/registry_data.json", paintingVariants)) {
+    if (!loadPaintingVariantsFromCompoundFile(REGISTRY_DATA_FILE, paintingVariants)) {
         logMessage("Failed to load painting variants from registry_data.json.", LOG_ERROR);
-        return;
+        return false;
     }
 
     // Number of entries in painting_variant
@@ -162,19 +187,18 @@ void sendRegistryDataPacket(ClientConnection& client, RegistryManager& registryM
         packetData.insert(packetData.end(), nbtPaintingVariantData.begin(), nbtPaintingVariantData.end());
     }
 
-    // Build and send the packet
-    sendPacket(client, packetData);
+    // Build the packet
+    frames.push_back(std::make_shared<const SharedFrame>(writer.payload()));
 
     // --- Registry 4: wolf_variant ---
-    packetData.clear();
-    packetData.push_back(REGISTRY_DATA);
+    writer.reset(REGISTRY_DATA);
     writeString(packetData, "minecraft:wolf_variant"); // Registry Identifier
 
     // Load wolf variants
     std::vector<WolfVariant> wolfVariants;
-    if (!loadWolfVariantsFromCompoundFile("../resources/registry_data.json", wolfVariants)) {
+    if (!loadWolfVariantsFromCompoundFile(REGISTRY_DATA_FILE, wolfVariants)) {
         logMessage("Failed to load wolf variants from registry_data.json.", LOG_ERROR);
-        return;
+        return false;
     }
 
     // Number of entries in wolf_variant
@@ -196,19 +220,18 @@ void sendRegistryDataPacket(ClientConnection& client, RegistryManager& registryM
         packetData.insert(packetData.end(), nbtWolfVariantData.begin(), nbtWolfVariantData.end());
     }
 
-    // Build and send the packet
-    sendPacket(client, packetData);
+    // Build the packet
+    frames.push_back(std::make_shared<const SharedFrame>(writer.payload()));
 
     // --- Registry 5: damage_type ---
-    packetData.clear();
-    packetData.push_back(REGISTRY_DATA);
+    writer.reset(REGISTRY_DATA);
     writeString(packetData, "minecraft:damage_type"); // Registry Identifier
 
     // Load damage types
     std::vector<DamageType> damageTypes;
-    if (!loadDamageTypesFromCompoundFile("../resources/registry_data.json", damageTypes)) {
+    if (!loadDamageTypesFromCompoundFile(REGISTRY_DATA_FILE, damageTypes)) {
         logMessage("Failed to load damage types from registry_data.json.", LOG_ERROR);
-        return;
+        return false;
     }
 
     // Number of entries in damage_type
@@ -230,37 +253,18 @@ void sendRegistryDataPacket(ClientConnection& client, RegistryManager& registryM
         packetData.insert(packetData.end(), nbtDamageTypeData.begin(), nbtDamageTypeData.end());
     }
 
-    // Build and send the packet
-    sendPacket(client, packetData);
+    // Build the packet
+    frames.push_back(std::make_shared<const SharedFrame>(writer.payload()));
 
     // --- Registry 6: chat_type ---
-    packetData.clear();
-    packetData.push_back(REGISTRY_DATA);
+    writer.reset(REGISTRY_DATA);
     writeString(packetData, "minecraft:chat_type"); // Registry Identifier
 
-    std::vector<ChatType> chatTypes = {
-        {
-            "minecraft:chat",
-            "chat.type.text",
-            {"sender", "content"} // senderName, message
-        },
-        {
-            "minecraft:system",
-            "chat.type.system",
-            {"content"} // message
-        },
-        {
-            "minecraft:announcement",
-            "chat.type.announcement",
-            {"sender"} // announcement message
-        }
-    };
-
     // Number of entries in chat_types
-    writeVarInt(packetData, static_cast<int32_t>(chatTypes.size()));
+    writeVarInt(packetData, static_cast<int32_t>(chatTypes().size()));
 
     // 3. Entries (Array of Entry IDs)
-    for (const auto& chatType : chatTypes) {
+    for (const auto& chatType : chatTypes()) {
         // a. Entry Identifier (String)
         writeString(packetData, chatType.identifier);
 
@@ -273,17 +277,16 @@ void sendRegistryDataPacket(ClientConnection& client, RegistryManager& registryM
 
         // Append the NBT data
         packetData.insert(packetData.end(), nbtChatTypeData.begin(), nbtChatTypeData.end());
-
-        registryManager.addRegistryEntry("minecraft:chat_type", chatType.identifier);
     }
 
-    // Build and send the packet
-    sendPacket(client, packetData);
+    // Build the packet
+    frames.push_back(std::make_shared<const SharedFrame>(writer.payload()));
+    return true;
 }
 
 void sendWorldEventPacket(ClientConnection& client, const int& worldEvent, const Position& position, const int& data) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(WORLD_EVENT);
+    PacketWriter writer(WORLD_EVENT);
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     // World Event (Int)
     writeInt(packetData, worldEvent);
@@ -302,12 +305,12 @@ void sendWorldEventPacket(ClientConnection& client, const int& worldEvent, const
     }
 
     // Build and send the packet
-    sendPacket(client, packetData);
+    sendPacket(client, writer);
 }
 
-bool sendUpdateTagsPacket(ClientConnection& client) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(UPDATE_TAGS);
+static std::shared_ptr<const SharedFrame> buildUpdateTags() {
+    PacketWriter writer(UPDATE_TAGS);
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     // Number of Tags to update
     // In this case, only updating "minecraft:worldgen/biome"
@@ -317,9 +320,9 @@ bool sendUpdateTagsPacket(ClientConnection& client) {
     writeString(packetData, "minecraft:worldgen/biome"); // Registry Identifier
 
     std::vector<BiomeRegistryEntry> biomeEntries;
-    if (!loadBiomesFromCompoundFile("../resources/registry_data.json", biomeEntries)) {
+    if (!loadBiomesFromCompoundFile(REGISTRY_DATA_FILE, biomeEntries)) {
         logMessage("Failed to load biomes from registry_data.json.", LOG_ERROR);
-        return false;
+        return nullptr;
     }
 
     // Number of entries in biome
@@ -350,15 +353,12 @@ bool sendUpdateTagsPacket(ClientConnection& client) {
         }
     }
 
-    // Build and send the packet
-    sendPacket(client, packetData);
-
-    return true;
+    return std::make_shared<const SharedFrame>(writer.payload());
 }
 
 void sendJoinGamePacket(ClientConnection& client, int32_t entityID) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(LOGIN);
+    PacketWriter writer(LOGIN);
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     // 1. Entity ID (Int)
     writeInt(packetData, entityID);
@@ -423,12 +423,12 @@ void sendJoinGamePacket(ClientConnection& client, int32_t entityID) {
     //packetData.push_back(0x00); // 0 (unused, required in 1.21.3)
 
     // Build and send the packet
-    sendPacket(client, packetData);
+    sendPacket(client, writer);
 }
 
 void sendSynchronizePlayerPositionPacket(ClientConnection& client, const std::shared_ptr<Player> &player) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(SYNCHRONIZE_PLAYER_POSITION);
+    PacketWriter writer(SYNCHRONIZE_PLAYER_POSITION);
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     if(player->newSpawn) {
         // If the player's position is not set, use the spawn position
@@ -469,183 +469,15 @@ void sendSynchronizePlayerPositionPacket(ClientConnection& client, const std::sh
     }
 
     // Build and send the packet
-    sendPacket(client, packetData);
+    sendPacket(client, writer);
 
     // Update client state to AwaitingTeleportConfirm
     client.state = ClientState::AwaitingTeleportConfirm;
 }
 
-void sendEntityRelativeMovePacket(const std::shared_ptr<Entity>& entity, short deltaX, short deltaY, short deltaZ) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(UPDATE_ENTITY_POSITION);
-
-    // Entity ID (VarInt)
-    writeVarInt(packetData, entity->entityID);
-
-    writeShort(packetData, deltaX);
-    writeShort(packetData, deltaY);
-    writeShort(packetData, deltaZ);
-
-    // On Ground (Boolean)
-    packetData.push_back(entity->onGround ? 0x01 : 0x00);
-
-    // Broadcast to all other clients
-    broadcastToOthers(packetData);
-}
-
-void sendPlayerRelativeMovePacket(const std::shared_ptr<Player>& player, short deltaX, short deltaY, short deltaZ) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(UPDATE_ENTITY_POSITION);
-
-    // Entity ID (VarInt)
-    writeVarInt(packetData, player->entityID);
-
-    writeShort(packetData, deltaX);
-    writeShort(packetData, deltaY);
-    writeShort(packetData, deltaZ);
-
-    // On Ground (Boolean)
-    packetData.push_back(player->onGround ? 0x01 : 0x00);
-
-    // Broadcast to all other clients
-    broadcastToOthers(packetData, player->uuidString);
-}
-
-void sendEntityLookAndRelativeMovePacket(const std::shared_ptr<Player>& player, short deltaX, short deltaY, short deltaZ, float yaw, float pitch) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(UPDATE_ENTITY_POSITION_AND_ROTATION);
-
-    // Entity ID (VarInt)
-    writeVarInt(packetData, player->entityID);
-
-    writeShort(packetData, deltaX);
-    writeShort(packetData, deltaY);
-    writeShort(packetData, deltaZ);
-
-    // Yaw, Pitch (Byte)
-    auto yawByte = static_cast<uint8_t>(yaw / (360.0f / 256.0f));
-    auto pitchByte = static_cast<uint8_t>(pitch / (360.0f / 256.0f));
-
-    packetData.push_back(yawByte);
-    packetData.push_back(pitchByte);
-
-    // On Ground (Boolean)
-    packetData.push_back(player->onGround ? 0x01 : 0x00);
-
-    // Broadcast to all other clients
-    broadcastToOthers(packetData, player->uuidString);
-}
-
-void sendEntityRotationPacket(const std::shared_ptr<Player>& player) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(UPDATE_ENTITY_ROTATION);
-
-    // Entity ID (VarInt)
-    writeVarInt(packetData, player->entityID);
-
-    // Yaw, Pitch (Byte)
-    auto yawByte = static_cast<uint8_t>(player->rotation.yaw / (360.0f / 256.0f));
-    auto pitchByte = static_cast<uint8_t>(player->rotation.pitch / (360.0f / 256.0f));
-
-    packetData.push_back(yawByte);
-    packetData.push_back(pitchByte);
-
-    // On Ground (Boolean)
-    packetData.push_back(player->onGround ? 0x01 : 0x00);
-
-    // Broadcast to all other clients
-    broadcastToOthers(packetData, player->uuidString);
-}
-
-void sendHeadRotationPacket(const std::shared_ptr<Player>& player) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(SET_HEAD_ROTATION);
-
-    // Entity ID (VarInt)
-    writeVarInt(packetData, player->entityID);
-
-    // Head Yaw (Byte)
-    auto headYawByte = static_cast<uint8_t>(player->rotation.headYaw / (360.0f / 256.0f));
-    packetData.push_back(headYawByte);
-
-    // Broadcast to all other clients
-    broadcastToOthers(packetData, player->uuidString);
-}
-
-void sendEntityTeleportPacket(const std::shared_ptr<Player>& player) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(TELEPORT_ENTITY);
-
-    // Entity ID (VarInt)
-    writeVarInt(packetData, player->entityID);
-
-    // X, Y, Z (Double)
-    writeDouble(packetData, player->position.x);
-    writeDouble(packetData, player->position.y);
-    writeDouble(packetData, player->position.z);
-
-    // Yaw, Pitch (Byte)
-    auto yawByte = static_cast<uint8_t>(player->rotation.yaw / (360.0f / 256.0f));
-    auto pitchByte = static_cast<uint8_t>(player->rotation.pitch / (360.0f / 256.0f));
-
-    packetData.push_back(yawByte);
-    packetData.push_back(pitchByte);
-
-    // On Ground (Boolean)
-    packetData.push_back(player->onGround ? 0x01 : 0x00);
-
-    // Broadcast to all other clients
-    broadcastToOthers(packetData, player->uuidString);
-}
-
-void sendSpawnEntityPacket(const std::shared_ptr<Entity>& entity) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(SPAWN_ENTITY);
-
-    // Entity ID (VarInt)
-    writeVarInt(packetData, entity->entityID);
-
-    // Entity UUID (UUID - 16 bytes)
-    packetData.insert(packetData.end(), entity->uuid.begin(), entity->uuid.end());
-
-    // Type (VarInt) - Entity type ID from minecraft:entity_type registry
-    writeVarInt(packetData, static_cast<int32_t>(entity->type));
-
-    // X, Y, Z (Double)
-    writeDouble(packetData, entity->getPositionX());
-    writeDouble(packetData, entity->getPositionY());
-    writeDouble(packetData, entity->getPositionZ());
-
-    // Pitch, Yaw, Head Yaw (Angles as bytes)
-    auto pitch = static_cast<uint8_t>(entity->rotation.pitch / (360.0f / 256.0f));
-    auto yaw = static_cast<uint8_t>(entity->rotation.yaw / (360.0f / 256.0f));
-    auto headYaw = static_cast<uint8_t>(entity->rotation.headYaw / (360.0f / 256.0f));
-
-    packetData.push_back(pitch);
-    packetData.push_back(yaw);
-    packetData.push_back(headYaw);
-
-    // Data - Additional data depending on entity type
-    std::vector<uint8_t> additionalData;
-    entity->serializeAdditionalData(additionalData);
-    writeVarInt(packetData, static_cast<int32_t>(additionalData.size()));
-    packetData.insert(packetData.end(), additionalData.begin(), additionalData.end());
-
-    // Velocity (Fixed-point, scaled by 8000)
-    auto fixedMotionX = static_cast<int16_t>(entity->getMotionX() * 8000);
-    auto fixedMotionY = static_cast<int16_t>(entity->getMotionY() * 8000);
-    auto fixedMotionZ = static_cast<int16_t>(entity->getMotionZ() * 8000);
-    writeShort(packetData, fixedMotionX);
-    writeShort(packetData, fixedMotionY);
-    writeShort(packetData, fixedMotionZ);
-
-    // Build and send the packet with length prefix
-    broadcastToOthers(packetData);
-}
-
 void sendSpawnEntityPacket(ClientConnection& client, const std::shared_ptr<Entity>& entity) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(SPAWN_ENTITY);
+    PacketWriter writer(SPAWN_ENTITY);
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     // Entity ID (VarInt)
     writeVarInt(packetData, entity->entityID);
@@ -676,18 +508,18 @@ void sendSpawnEntityPacket(ClientConnection& client, const std::shared_ptr<Entit
     writeVarInt(packetData, static_cast<int32_t>(additionalData.size()));
     packetData.insert(packetData.end(), additionalData.begin(), additionalData.end());
 
-    // Velocity X, Y, Z (Short) - set to 0 for now
-    writeShort(packetData, 0); // Velocity X
-    writeShort(packetData, 0); // Velocity Y
-    writeShort(packetData, 0); // Velocity Z
+    // Velocity (Fixed-point, scaled by 8000)
+    writeShort(packetData, static_cast<int16_t>(entity->getMotionX() * 8000));
+    writeShort(packetData, static_cast<int16_t>(entity->getMotionY() * 8000));
+    writeShort(packetData, static_cast<int16_t>(entity->getMotionZ() * 8000));
 
     // Build and send the packet with length prefix
-    sendPacket(client, packetData);
+    sendPacket(client, writer);
 }
 
 void sendEntityEventPacket(ClientConnection& client, int32_t entityID, uint8_t entityStatus) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(ENTITY_EVENT);
+    PacketWriter writer(ENTITY_EVENT);
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     // Entity ID (VarInt)
     writeInt(packetData, entityID);
@@ -696,12 +528,12 @@ void sendEntityEventPacket(ClientConnection& client, int32_t entityID, uint8_t e
     writeByte(packetData, entityStatus);
 
     // Build and send the packet
-    sendPacket(client, packetData);
+    sendPacket(client, writer);
 }
 
-void sendPlayerInfoUpdate(ClientConnection& targetClient, const std::vector<std::shared_ptr<Player>>& playersToUpdate, uint8_t actions) {
-    std::vector<uint8_t> packetData = { };
-    packetData.push_back(PLAYER_INFO_UPDATE);
+// Returns false, after disconnecting the player, if one of the players has an invalid chat session
+static bool writePlayerInfoUpdate(PacketWriter& writer, const std::vector<std::shared_ptr<Player>>& playersToUpdate, uint8_t actions) {
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     // Actions Byte
     packetData.push_back(actions);
@@ -742,19 +574,19 @@ void sendPlayerInfoUpdate(ClientConnection& targetClient, const std::vector<std:
                 if (player->sessionId.size() != 16) {
                     logMessage("Invalid Session ID size for player: " + player->name, LOG_ERROR);
                     disconnectClient(player, "Invalid Session ID size", true);
-                    return;
+                    return false;
                 }
 
                 if (player->sessionKey.pubKey.size() > 512) {
                     logMessage("Public Key size exceeds 512 bytes for player: " + player->name, LOG_ERROR);
                     disconnectClient(player, "Public Key size exceeds 512 bytes", true);
-                    return;
+                    return false;
                 }
 
                 if (player->sessionKey.keySig.size() > 4096) {
                     logMessage("Public Key Signature size exceeds 4096 bytes for player: " + player->name, LOG_ERROR);
                     disconnectClient(player, "Public Key Signature size exceeds 4096 bytes", true);
-                    return;
+                    return false;
                 }
                 // Chat Session ID (UUID)
                 writeBytes(packetData, player->sessionId);
@@ -803,13 +635,32 @@ void sendPlayerInfoUpdate(ClientConnection& targetClient, const std::vector<std:
         }
     }
 
+    return true;
+}
+
+void sendPlayerInfoUpdate(ClientConnection& targetClient, const std::vector<std::shared_ptr<Player>>& playersToUpdate, uint8_t actions) {
+    PacketWriter writer(PLAYER_INFO_UPDATE);
+    if (!writePlayerInfoUpdate(writer, playersToUpdate, actions)) {
+        return;
+    }
+
     // Send the packet to the target client
-    sendPacket(targetClient, packetData);
+    sendPacket(targetClient, writer);
+}
+
+void broadcastPlayerInfoUpdate(const std::vector<std::shared_ptr<Player>>& playersToUpdate, uint8_t actions, const std::string& excludeUUID) {
+    PacketWriter writer(PLAYER_INFO_UPDATE);
+    if (!writePlayerInfoUpdate(writer, playersToUpdate, actions)) {
+        return;
+    }
+
+    // Serialized once for every client
+    broadcastToOthers(writer, excludeUUID);
 }
 
 void sendGameEventPacket(ClientConnection& targetClient, GameEvent event, float value) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(GAME_EVENT);
+    PacketWriter writer(GAME_EVENT);
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     // Event (Unsigned Byte)
     packetData.push_back(static_cast<uint8_t>(event));
@@ -818,12 +669,12 @@ void sendGameEventPacket(ClientConnection& targetClient, GameEvent event, float
     writeFloat(packetData, value);
 
     // Send the packet
-    sendPacket(targetClient, packetData);
+    sendPacket(targetClient, writer);
 }
 
 void sendGameEvent(GameEvent event, float value) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(GAME_EVENT);
+    PacketWriter writer(GAME_EVENT);
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     // Event (Unsigned Byte)
     packetData.push_back(static_cast<uint8_t>(event));
@@ -832,7 +683,7 @@ void sendGameEvent(GameEvent event, float value) {
     writeFloat(packetData, value);
 
     // Broadcast to all clients
-    broadcastToOthers(packetData);
+    broadcastToOthers(writer);
 }
 
 void sendChangeGamemode(ClientConnection& client, const std::shared_ptr<Player>& player, Gamemode gameMode) {
@@ -841,8 +692,8 @@ void sendChangeGamemode(ClientConnection& client, const std::shared_ptr<Player>&
     }
 
 void sendRemoveEntitiesPacket(const std::vector<int32_t>& entityIDs) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(REMOVE_ENTITIES);
+    PacketWriter writer(REMOVE_ENTITIES);
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     // Number of Entities (VarInt)
     writeVarInt(packetData, static_cast<int32_t>(entityIDs.size()));
@@ -853,37 +704,36 @@ void sendRemoveEntitiesPacket(const std::vector<int32_t>& entityIDs) {
     }
 
     // Build and send the packet to all clients
-    broadcastToOthers(packetData);
+    broadcastToOthers(writer);
 }
 
 void sendTranslatedChatMessage(const std::string& key, const bool actionBar, const std::string& color, const std::vector<std::shared_ptr<Player>>* players, bool log, const std::vector<std::string>* args) {
-    std::vector<uint8_t> packetData = { };
+    PacketWriter writer;
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     if (players == nullptr) {
         for (const auto &player: globalPlayers | std::views::values) {
-            packetData.clear();
-            packetData.push_back(SYSTEM_CHAT_MESSAGE);
+            writer.reset(SYSTEM_CHAT_MESSAGE);
 
             nbt::tag_compound textCompound = createTextComponent(getTranslation(key, player->lang, *args), color);
             std::vector<uint8_t> textData = serializeNBT(textCompound, true);
             packetData.insert(packetData.end(), textData.begin(), textData.end());
 
             writeByte(packetData, actionBar);
-            sendPacket(*player->client, packetData);
+            sendPacket(*player->client, writer);
         }
     }
     else {
         for (const auto& player : *players) {
             if (player->client != nullptr) {
-                packetData.clear();
-                packetData.push_back(SYSTEM_CHAT_MESSAGE);
+                writer.reset(SYSTEM_CHAT_MESSAGE);
 
                 nbt::tag_compound textCompound = createTextComponent(getTranslation(key, player->lang, *args), color);
                 std::vector<uint8_t> textData = serializeNBT(textCompound, true);
                 packetData.insert(packetData.end(), textData.begin(), textData.end());
 
                 writeByte(packetData, actionBar);
-                sendPacket(*player->client, packetData);
+                sendPacket(*player->client, writer);
             }
         }
     }
@@ -893,8 +743,8 @@ void sendTranslatedChatMessage(const std::string& key, const bool actionBar, con
 }
 
 void sendChatMessage(const std::string& message, const bool actionBar, const std::string& color, const std::vector<std::shared_ptr<Player>>* players, bool log) {
-    std::vector<uint8_t> packetData = { };
-    packetData.push_back(SYSTEM_CHAT_MESSAGE);
+    PacketWriter writer(SYSTEM_CHAT_MESSAGE);
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     nbt::tag_compound textCompound = createTextComponent(message, color);
     std::vector<uint8_t> textData = serializeNBT(textCompound, true);
@@ -903,12 +753,13 @@ void sendChatMessage(const std::string& message, const bool actionBar, const std
     writeByte(packetData, actionBar);
 
     if (players == nullptr) {
-        broadcastToOthers(packetData, "");
+        broadcastToOthers(writer, "");
     }
     else {
+        auto frame = std::make_shared<const SharedFrame>(writer.payload());
         for (const auto& player : *players) {
             if (player->client != nullptr) {
-                sendPacket(*player->client, packetData);
+                sendPacket(*player->client, frame);
             }
         }
     }
@@ -925,8 +776,8 @@ void sendChatMessage(const std::string& message, const bool actionBar, const std
 }
 
 void sendSetCenterChunkPacket(ClientConnection& targetClient, int32_t chunkX, int32_t chunkZ) {
-    std::vector<uint8_t> packetData = { };
-    packetData.push_back(SET_CENTER_CHUNK);
+    PacketWriter writer(SET_CENTER_CHUNK);
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     // Serialize Chunk X (VarInt)
     writeVarInt(packetData, chunkX);
@@ -935,13 +786,13 @@ void sendSetCenterChunkPacket(ClientConnection& targetClient, int32_t chunkX, in
     writeVarInt(packetData, chunkZ);
 
     // Send the packet to the target client
-   sendPacket(targetClient, packetData);
+   sendPacket(targetClient, writer);
 }
 
 void sendResourcePacks(ClientConnection& client) {
     for (const auto& pack : serverConfig.resourcePacks) {
-        std::vector<uint8_t> packetData;
-        writeVarInt(packetData, ADD_RESOURCE_PACK_PLAY);
+        PacketWriter writer(ADD_RESOURCE_PACK_PLAY);
+        std::vector<uint8_t>& packetData = writer.buffer();
 
         // Resource Pack Push Fields
         std::array<uint8_t, 16> uuid = stringUUIDToBytes(pack.uuid);
@@ -962,13 +813,13 @@ void sendResourcePacks(ClientConnection& client) {
         }
 
         // Send the packet
-        sendPacket(client, packetData);
+        sendPacket(client, writer);
     }
 }
 
 void sendRemoveResourcePacks(ClientConnection& client, const std::vector<std::string>& uuidsToRemove) {
-    std::vector<uint8_t> packetData;
-    writeVarInt(packetData, REMOVE_RESOURCE_PACK_CONFIG);
+    PacketWriter writer(REMOVE_RESOURCE_PACK_CONFIG);
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     if (uuidsToRemove.empty()) {
         // Remove all resource packs
@@ -982,12 +833,12 @@ void sendRemoveResourcePacks(ClientConnection& client, const std::vector<std::st
     }
 
     // Send the packet
-    sendPacket(client, packetData);
+    sendPacket(client, writer);
 }
 
 bool sendKeepAlivePacket(ClientConnection& client) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(KEEP_ALIVE_PLAY);
+    PacketWriter writer(KEEP_ALIVE_PLAY);
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     // Keep Alive ID (Long)
     int64_t keepAliveID = std::chrono::system_clock::now().time_since_epoch().count();
@@ -995,14 +846,38 @@ bool sendKeepAlivePacket(ClientConnection& client) {
     client.keepAliveID = keepAliveID;
 
     // Build and send the packet
-    return sendPacket(client, packetData);
+    return sendPacket(client, writer);
 }
 
 void sendEntityMetadataPacket(const std::vector<MetadataEntry>& metadataEntries, int32_t entityID) {
-    std::vector<uint8_t> packetData = { };
+    PacketWriter writer(SET_ENTITY_METADATA);
+    std::vector<uint8_t>& packetData = writer.buffer();
 
-    // Packet ID for Entity Metadata
-    packetData.push_back(SET_ENTITY_METADATA);
+    // Entity ID (VarInt)
+    writeVarInt(packetData, entityID);
+
+    // Add each Metadata Entry
+    for (const auto& entry : metadataEntries) {
+        // Index (Unsigned Byte)
+        packetData.push_back(entry.index);
+
+        // Type (VarInt Enum)
+        writeVarInt(packetData, static_cast<int32_t>(entry.type));
+
+        // Value (Varies based on type)
+        packetData.insert(packetData.end(), entry.value.begin(), entry.value.end());
+    }
+
+    // Terminating Entry (0xFF)
+    packetData.push_back(0xFF);
+
+    // Send to the players that can see the entity
+    entityTracker.sendToViewers(entityID, writer);
+}
+
+void sendEntityMetadataPacket(ClientConnection& client, const std::vector<MetadataEntry>& metadataEntries, int32_t entityID) {
+    PacketWriter writer(SET_ENTITY_METADATA);
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     // Entity ID (VarInt)
     writeVarInt(packetData, entityID);
@@ -1022,15 +897,12 @@ void sendEntityMetadataPacket(const std::vector<MetadataEntry>& metadataEntries,
     // Terminating Entry (0xFF)
     packetData.push_back(0xFF);
 
-    // Broadcast the packet to all other clients
-    broadcastToOthers(packetData);
+    sendPacket(client, writer);
 }
 
 void sendEntityMetadataPacket(const std::shared_ptr<Player>& player, const std::vector<MetadataEntry>& metadataEntries, int32_t entityID) {
-    std::vector<uint8_t> packetData = { };
-
-    // Packet ID for Entity Metadata
-    packetData.push_back(SET_ENTITY_METADATA);
+    PacketWriter writer(SET_ENTITY_METADATA);
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     // Entity ID (VarInt)
     writeVarInt(packetData, entityID);
@@ -1050,13 +922,13 @@ void sendEntityMetadataPacket(const std::shared_ptr<Player>& player, const std::
     // Terminating Entry (0xFF)
     packetData.push_back(0xFF);
 
-    // Broadcast the packet to all other clients except the initiating player
-    broadcastToOthers(packetData, player->uuidString);
+    // Send to the players that can see the entity, which never includes the player itself
+    entityTracker.sendToViewers(entityID, writer);
 }
 
 void sendEntityAnimation(const std::shared_ptr<Player> & player, EntityAnimation animation) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(ENTITY_ANIMATION);
+    PacketWriter writer(ENTITY_ANIMATION);
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     // Entity ID (VarInt)
     writeVarInt(packetData, player->entityID);
@@ -1064,24 +936,24 @@ void sendEntityAnimation(const std::shared_ptr<Player> & player, EntityAnimation
     // Animation ID (Unsigned Byte)
     packetData.push_back(static_cast<uint8_t>(animation));
 
-    // Broadcast to all other clients
-    broadcastToOthers(packetData, player->uuidString);
+    // Send to the players that can see this one
+    entityTracker.sendToViewers(player->entityID, writer);
 }
 
 void sendAcknowledgeBlockChange(ClientConnection& client, size_t sequenceID) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(ACKNOWLEDGE_BLOCK_CHANGE);
+    PacketWriter writer(ACKNOWLEDGE_BLOCK_CHANGE);
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     // Sequence ID (VarInt)
     writeVarInt(packetData, static_cast<int32_t>(sequenceID));
 
     // Send the packet
-    sendPacket(client, packetData);
+    sendPacket(client, writer);
 }
 
 void sendEquipmentPacket(const std::shared_ptr<Player> & player, int32_t entityID, const EquipmentSlot& slot) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(SET_EQUIPMENT);
+    PacketWriter writer(SET_EQUIPMENT);
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     // Entity ID (VarInt)
     writeVarInt(packetData, entityID);
@@ -1093,12 +965,12 @@ void sendEquipmentPacket(const std::shared_ptr<Player> & player, int32_t entityI
     writeSlotSimple(packetData, slot.slotData);
 
     // Broadcast to all other clients
-    broadcastToOthers(packetData, player->uuidString);
+    broadcastToOthers(writer, player->uuidString);
 }
 
 void broadcastPlayerChatMessage(const std::shared_ptr<Player>& sender, const std::string& message, long timestamp, long salt, const std::vector<uint8_t>* signature, const RegistryManager& registryManager, const std::string& chatTypeIdentifier, const std::string& targetName) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(PLAYER_CHAT_MESSAGE);
+    PacketWriter writer(PLAYER_CHAT_MESSAGE);
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     // Sender UUID
     packetData.insert(packetData.end(), sender->uuid.begin(), sender->uuid.end());
@@ -1159,18 +1031,13 @@ void broadcastPlayerChatMessage(const std::shared_ptr<Player>& sender, const std
     }
 
     // Broadcast to all players
-    {
-        std::lock_guard lock(connectedClientsMutex);
-        for (auto &client: connectedClients | std::views::values) {
-            sendPacket(*client, packetData);
-        }
-    }
+    broadcastToOthers(writer);
     logMessage("<" + sender->name + "> " + message, LOG_RAW);
 }
 
-void sendCommandsPacket(ClientConnection& client) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(COMMANDS);
+static std::shared_ptr<const SharedFrame> buildCommands() {
+    PacketWriter writer(COMMANDS);
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     // Write the Count (number of nodes)
     writeVarInt(packetData, static_cast<int32_t>(commandGraphNumOfNodes));
@@ -1181,22 +1048,22 @@ void sendCommandsPacket(ClientConnection& client) {
     // Write the Root index
     writeVarInt(packetData, serializedCommandGraph.second);
 
-    sendPacket(client, packetData);
+    return std::make_shared<const SharedFrame>(writer.payload());
 }
 
 void sendFinishConfigurationPacket(ClientConnection& client) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(FINISH_CONFIGURATION);
+    PacketWriter writer(FINISH_CONFIGURATION);
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     // No fields in this packet
 
     // Build and send the packet
-    sendPacket(client, packetData);
+    sendPacket(client, writer);
 }
 
 void sendKnownPacksPacket(ClientConnection& client) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(CLIENTBOUND_KNOWN_PACKS);
+    PacketWriter writer(CLIENTBOUND_KNOWN_PACKS);
+    std::vector<uint8_t>& packetData = writer.buffer();
     // For now, only minecraft:core version 1.21
     writeVarInt(packetData, 1); // Number of packs
 
@@ -1204,20 +1071,20 @@ void sendKnownPacksPacket(ClientConnection& client) {
     writeString(packetData, "core"); // Pack ID
     writeString(packetData, "1.21"); // Pack Version
 
-    sendPacket(client, packetData);
+    sendPacket(client, writer);
 }
 
 void sendSetCompressionPacket(ClientConnection& client, int32_t threshold) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(SET_COMPRESSION);
+    PacketWriter writer(SET_COMPRESSION);
+    std::vector<uint8_t>& packetData = writer.buffer();
     writeVarInt(packetData, threshold); // Compression threshold
 
-    sendPacket(client, packetData);
+    sendPacket(client, writer);
 }
 
 void sendDisconnectionPacket(ClientConnection& client, const std::string& reason) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(DISCONNECT);
+    PacketWriter writer(DISCONNECT);
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     // Serialize the reason as a JSON text component
     nlohmann::json textComponent = {
@@ -1226,12 +1093,12 @@ void sendDisconnectionPacket(ClientConnection& client, const std::string& reason
     std::string reasonStr = textComponent.dump();
     writeString(packetData, reasonStr);
 
-    sendPacket(client, packetData);
+    sendPacket(client, writer);
 }
 
 void sendServerLinksPacket(ClientConnection & client) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(SERVER_LINKS);
+    PacketWriter writer(SERVER_LINKS);
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     writeVarInt(packetData, static_cast<int32_t>(serverConfig.serverLinks.size()));
     for (const auto& link : serverConfig.serverLinks) {
@@ -1242,12 +1109,12 @@ void sendServerLinksPacket(ClientConnection & client) {
         writeString(packetData, link.url);
     }
 
-    sendPacket(client, packetData);
+    sendPacket(client, writer);
 }
 
 void sendServerPluginMessages(ClientConnection & client) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(CLIENTBOUND_PLUGIN_MESSAGE_CONFIG);
+    PacketWriter writer(CLIENTBOUND_PLUGIN_MESSAGE_CONFIG);
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     std::string channel = "minecraft:brand";
     writeString(packetData, channel);
@@ -1255,12 +1122,12 @@ void sendServerPluginMessages(ClientConnection & client) {
     std::string brand = "MCpp";
     writeString(packetData, brand);
 
-    sendPacket(client, packetData);
+    sendPacket(client, writer);
 }
 
 void sendReInitializeWorldBorder(double x, double z, double size, int64_t speed, int32_t warningBlocks, int32_t warningTime) {
-    std::vector<uint8_t> packet;
-    writeVarInt(packet, INITIALIZE_WORLD_BORDER);
+    PacketWriter writer(INITIALIZE_WORLD_BORDER);
+    std::vector<uint8_t>& packet = writer.buffer();
     double oldDiameter = worldBorder.size;
     worldBorder.updateCenter(x, z);
     worldBorder.updateSize(size);
@@ -1293,12 +1160,12 @@ void sendReInitializeWorldBorder(double x, double z, double size, int64_t speed,
     writeVarInt(packet, warningTime);
 
     // Send the packet
-    broadcastToOthers(packet);
+    broadcastToOthers(writer);
 }
 
 void sendInitializeWorldBorder(ClientConnection& client, const WorldBorder& border) {
-    std::vector<uint8_t> packet;
-    writeVarInt(packet, INITIALIZE_WORLD_BORDER);
+    PacketWriter writer(INITIALIZE_WORLD_BORDER);
+    std::vector<uint8_t>& packet = writer.buffer();
 
     // Bound To: X (Double) - Center X
     writeDouble(packet, border.centerX);
@@ -1325,12 +1192,12 @@ void sendInitializeWorldBorder(ClientConnection& client, const WorldBorder& bord
     writeVarInt(packet, border.warningTime);
 
     // Send the packet
-    sendPacket(client, packet);
+    sendPacket(client, writer);
 }
 
 void sendTimeUpdatePacket(ClientConnection& client) {
-    std::vector<uint8_t> packet;
-    writeVarInt(packet, UPDATE_TIME);
+    PacketWriter writer(UPDATE_TIME);
+    std::vector<uint8_t>& packet = writer.buffer();
 
     // World Age (Long) - Not changed by server commands
     int64_t currentWorldAge = worldTime.getWorldAge();
@@ -1341,12 +1208,25 @@ void sendTimeUpdatePacket(ClientConnection& client) {
     writeLong(packet, currentTimeOfDay);
 
     // Send the packet
-    sendPacket(client, packet);
+    sendPacket(client, writer);
+}
+
+void broadcastTimeUpdatePacket() {
+    PacketWriter writer(UPDATE_TIME);
+    std::vector<uint8_t>& packet = writer.buffer();
+
+    // World Age (Long)
+    writeLong(packet, worldTime.getWorldAge());
+
+    // Time of Day (Long)
+    writeLong(packet, worldTime.getTimeOfDay());
+
+    broadcastToOthers(writer);
 }
 
 void sendSetBorderCenter(double x, double z) {
-    std::vector<uint8_t> packet;
-    writeByte(packet, SET_BORDER_CENTER);
+    PacketWriter writer(SET_BORDER_CENTER);
+    std::vector<uint8_t>& packet = writer.buffer();
     worldBorder.updateCenter(x, z);
 
     // Center X (Double)
@@ -1356,12 +1236,12 @@ void sendSetBorderCenter(double x, double z) {
     writeDouble(packet, worldBorder.centerZ);
 
     // Send the packet to all clients
-    broadcastToOthers(packet);
+    broadcastToOthers(writer);
 }
 
 void sendSetBorderLerpSize(double newDiameter, int64_t speed) {
-    std::vector<uint8_t> packet;
-    writeByte(packet, SET_BORDER_LERP_SIZE);
+    PacketWriter writer(SET_BORDER_LERP_SIZE);
+    std::vector<uint8_t>& packet = writer.buffer();
     double oldDiameter = worldBorder.size;
     worldBorder.updateSize(newDiameter);
 
@@ -1375,48 +1255,48 @@ void sendSetBorderLerpSize(double newDiameter, int64_t speed) {
     writeVarLong(packet, speed);
 
     // Send the packet to all clients
-    broadcastToOthers(packet);
+    broadcastToOthers(writer);
 }
 
 void sendSetBorderSize(double newDiameter) {
-    std::vector<uint8_t> packet;
-    writeByte(packet, SET_BORDER_SIZE);
+    PacketWriter writer(SET_BORDER_SIZE);
+    std::vector<uint8_t>& packet = writer.buffer();
     worldBorder.updateSize(newDiameter);
 
     // New Diameter (Double)
     writeDouble(packet, worldBorder.size);
 
     // Send the packet to all clients
-    broadcastToOthers(packet);
+    broadcastToOthers(writer);
 }
 
 void sendSetBorderWarningDelay(int32_t warningTime) {
-    std::vector<uint8_t> packet;
-    writeByte(packet, SET_BORDER_WARNING_DELAY);
+    PacketWriter writer(SET_BORDER_WARNING_DELAY);
+    std::vector<uint8_t>& packet = writer.buffer();
     worldBorder.updateWarningTime(warningTime);
 
     // Warning Time (VarInt)
     writeVarInt(packet, worldBorder.warningTime);
 
     // Send the packet to all clients
-    broadcastToOthers(packet);
+    broadcastToOthers(writer);
 }
 
 void sendSetBorderWarningDistance(int32_t warningBlocks) {
-    std::vector<uint8_t> packet;
-    writeByte(packet, SET_BORDER_WARNING_DISTANCE);
+    PacketWriter writer(SET_BORDER_WARNING_DISTANCE);
+    std::vector<uint8_t>& packet = writer.buffer();
     worldBorder.updateWarningDistance(warningBlocks);
 
     // Warning Blocks (VarInt)
     writeVarInt(packet, worldBorder.warningBlocks);
 
     // Send the packet to all clients
-    broadcastToOthers(packet);
+    broadcastToOthers(writer);
 }
 
 void sendBossbar(Bossbar& bossbar, int32_t action) {
-    std::vector<uint8_t> packet;
-    writeByte(packet, BOSS_BAR);
+    PacketWriter writer(BOSS_BAR);
+    std::vector<uint8_t>& packet = writer.buffer();
     std::array<uint8_t, 16> uuid = bossbar.getUUID();
     std::vector<uint8_t> uuidBytes;
     uuidBytes.insert(uuidBytes.end(), uuid.begin(), uuid.end());
@@ -1469,16 +1349,17 @@ void sendBossbar(Bossbar& bossbar, int32_t action) {
             return;
         }
     }
+    auto frame = std::make_shared<const SharedFrame>(writer.payload());
     for (const auto player : bossbar.getPlayers()) {
         if (player->client != nullptr) {
-            sendPacket(*player->client, packet);
+            sendPacket(*player->client, frame);
         }
     }
 }
 
 void sendCommandSuggestionsResponse(ClientConnection& client, int32_t transactionID, const std::vector<std::string>& suggestions, int32_t start) {
-    std::vector<uint8_t> packet;
-    writeVarInt(packet, COMMAND_SUGGESTIONS_RESPONSE);
+    PacketWriter writer(COMMAND_SUGGESTIONS_RESPONSE);
+    std::vector<uint8_t>& packet = writer.buffer();
     writeVarInt(packet, transactionID);
     writeVarInt(packet, start);
     writeVarInt(packet, 0);
@@ -1487,44 +1368,24 @@ void sendCommandSuggestionsResponse(ClientConnection& client, int32_t transactio
         writeString(packet, suggestion);
         writeByte(packet, 0x00); // No text component
     }
-    sendPacket(client, packet);
+    sendPacket(client, writer);
 }
 
 void sendBundleDelimiter() {
-    std::vector<uint8_t> packet;
-    writeVarInt(packet, BUNDLE_DELIMITER);
-    broadcastToOthers(packet);
+    PacketWriter writer(BUNDLE_DELIMITER);
+    std::vector<uint8_t>& packet = writer.buffer();
+    broadcastToOthers(writer);
 }
 
 void sendBundleDelimiter(ClientConnection& client) {
-    std::vector<uint8_t> packet;
-    writeVarInt(packet, BUNDLE_DELIMITER);
-    sendPacket(client, packet);
-}
-
-void sendEntityVelocity(const std::shared_ptr<Entity>& entity) {
-    std::vector<uint8_t> packet;
-    writeVarInt(packet, SET_ENTITY_VELOCITY);
-
-    // Entity ID (VarInt)
-    writeVarInt(packet, entity->entityID);
-
-    // Velocity X (Short)
-    writeShort(packet, static_cast<int16_t>(entity->getMotionX() * 8000));
-
-    // Velocity Y (Short)
-    writeShort(packet, static_cast<int16_t>(entity->getMotionY() * 8000));
-
-    // Velocity Z (Short)
-    writeShort(packet, static_cast<int16_t>(entity->getMotionZ() * 8000));
-
-    // Broadcast to all clients
-    broadcastToOthers(packet);
+    PacketWriter writer(BUNDLE_DELIMITER);
+    std::vector<uint8_t>& packet = writer.buffer();
+    sendPacket(client, writer);
 }
 
 void sendPickUpItem(const std::shared_ptr<Entity>& collectedEntity, const std::shared_ptr<Entity>& collectorEntity, int8_t count) {
-    std::vector<uint8_t> packet;
-    writeByte(packet, PICK_UP_ITEM);
+    PacketWriter writer(PICK_UP_ITEM);
+    std::vector<uint8_t>& packet = writer.buffer();
 
     // Collected Entity ID (VarInt)
     writeVarInt(packet, collectedEntity->entityID);
@@ -1536,12 +1397,12 @@ void sendPickUpItem(const std::shared_ptr<Entity>& collectedEntity, const std::s
     writeVarInt(packet, count);
 
     // Broadcast to all clients
-    broadcastToOthers(packet);
+    broadcastToOthers(writer);
 }
 
 void SendSetContainerSlot(ClientConnection& client, const int8_t windowID, const int32_t stateID, const uint16_t slotID, const SlotData& slot) {
-    std::vector<uint8_t> packet;
-    writeByte(packet, SET_CONTAINER_SLOT);
+    PacketWriter writer(SET_CONTAINER_SLOT);
+    std::vector<uint8_t>& packet = writer.buffer();
 
     // Window ID (Byte)
     writeByte(packet, windowID);
@@ -1555,12 +1416,12 @@ void SendSetContainerSlot(ClientConnection& client, const int8_t windowID, const
     // Slot (Slot)
     writeSlotSimple(packet, slot);
 
-    sendPacket(client, packet);
+    sendPacket(client, writer);
 }
 
-void sendUpdateRecipes(ClientConnection& client) {
-    std::vector<uint8_t> packet;
-    writeByte(packet, UPDATE_RECIPES);
+static std::shared_ptr<const SharedFrame> buildUpdateRecipes() {
+    PacketWriter writer(UPDATE_RECIPES);
+    std::vector<uint8_t>& packet = writer.buffer();
 
     /*
     writeVarInt(packet, static_cast<int32_t>(craftingRecipes.size()));
@@ -1572,12 +1433,12 @@ void sendUpdateRecipes(ClientConnection& client) {
     writeVarInt(packet, 1);
     writeBytes(packet, craftingRecipes.find(36)->second.serialize(36));
 
-    sendPacket(client, packet);
+    return std::make_shared<const SharedFrame>(writer.payload());
 }
 
 void sendContainerContent(ClientConnection& client, uint8_t windowID, int32_t stateID, Inventory& inventory) {
-    std::vector<uint8_t> packet;
-    writeByte(packet, SET_CONTAINER_CONTENT);
+    PacketWriter writer(SET_CONTAINER_CONTENT);
+    std::vector<uint8_t>& packet = writer.buffer();
 
     writeUByte(packet, windowID);
     writeVarInt(packet, stateID);
@@ -1594,24 +1455,24 @@ void sendContainerContent(ClientConnection& client, uint8_t windowID, int32_t st
     }
     writeSlotSimple(packet, inventory.carriedItem);
 
-    sendPacket(client, packet);
+    sendPacket(client, writer);
 }
 
 void sendOpenScreen(ClientConnection& client, const uint8_t windowID, const uint8_t windowType, const std::string& title) {
-    std::vector<uint8_t> packet;
-    writeByte(packet, OPEN_SCREEN);
+    PacketWriter writer(OPEN_SCREEN);
+    std::vector<uint8_t>& packet = writer.buffer();
 
     writeVarInt(packet, windowID);
     writeVarInt(packet, windowType);
     nbt::tag_compound titleTag = createTextComponent(title);
     writeBytes(packet, serializeNBT(titleTag, true));
 
-    sendPacket(client, packet);
+    sendPacket(client, writer);
 }
 
 void sendBlockDestroyStage(const std::shared_ptr<Player>& player, const Position &blockPos, const int8_t stage) {
-    std::vector<uint8_t> packet;
-    writeByte(packet, BLOCK_DESTROY_STAGE);
+    PacketWriter writer(BLOCK_DESTROY_STAGE);
+    std::vector<uint8_t>& packet = writer.buffer();
 
     // Entity ID (VarInt)
     writeVarInt(packet, player->entityID);
@@ -1623,12 +1484,12 @@ void sendBlockDestroyStage(const std::shared_ptr<Player>& player, const Position
     writeByte(packet, stage);
 
     // Broadcast to all clients // TODO: Only broadcast to clients that have the chunk loaded
-    broadcastToOthers(packet, player->uuidString);
+    broadcastToOthers(writer, player->uuidString);
 }
 
 void sendUpdateAttributes(ClientConnection& client, const int32_t entityID, const std::vector<Attribute>& attributes) {
-    std::vector<uint8_t> packet;
-    writeByte(packet, UPDATE_ATTRIBUTES);
+    PacketWriter writer(UPDATE_ATTRIBUTES);
+    std::vector<uint8_t>& packet = writer.buffer();
 
     // Entity ID (VarInt)
     writeVarInt(packet, entityID);
@@ -1659,12 +1520,12 @@ void sendUpdateAttributes(ClientConnection& client, const int32_t entityID, cons
         */
     }
 
-    sendPacket(client, packet);
+    sendPacket(client, writer);
 }
 
 void sendPlayerAbilities(ClientConnection& client, const uint8_t flags, const float flyingSpeed, const float fovModifier) {
-    std::vector<uint8_t> packet;
-    writeByte(packet, PLAYER_ABILITIES);
+    PacketWriter writer(PLAYER_ABILITIES);
+    std::vector<uint8_t>& packet = writer.buffer();
 
     // Flags (Unsigned Byte)
     writeByte(packet, flags);
@@ -1675,5 +1536,86 @@ void sendPlayerAbilities(ClientConnection& client, const uint8_t flags, const fl
     // Walking Speed (Float)
     writeFloat(packet, fovModifier);
 
-    sendPacket(client, packet);
-}
\ No newline at end of file
+    sendPacket(client, writer);
+}
+
+// Configuration-phase and join packets that are the same for every player, framed and compressed once.
+// Replaced as a whole when registry_data.json changes or rebuildConfigurationFrames is called.
+struct ConfigurationFrames {
+    std::vector<std::shared_ptr<const SharedFrame>> registryData; // One per registry
+    std::shared_ptr<const SharedFrame> updateTags;
+    std::shared_ptr<const SharedFrame> updateRecipes;
+    std::shared_ptr<const SharedFrame> commands;
+    std::filesystem::file_time_type registryWriteTime;
+};
+
+static std::atomic<std::shared_ptr<const ConfigurationFrames>> configurationFrames;
+static std::mutex configurationFramesMutex;
+
+static std::filesystem::file_time_type registryWriteTime() {
+    std::error_code error;
+    auto writeTime = std::filesystem::last_write_time(REGISTRY_DATA_FILE, error);
+    return error ? std::filesystem::file_time_type{} : writeTime;
+}
+
+static std::shared_ptr<const ConfigurationFrames> buildConfigurationFrames() {
+    auto frames = std::make_shared<ConfigurationFrames>();
+    // Taken before reading, so a change made while building triggers another rebuild
+    frames->registryWriteTime = registryWriteTime();
+    if (!buildRegistryData(frames->registryData)) {
+        logMessage("Registry data is incomplete, joining players will be missing registries.", LOG_ERROR);
+    }
+    frames->updateTags = buildUpdateTags();
+    frames->updateRecipes = buildUpdateRecipes();
+    frames->commands = buildCommands();
+    return frames;
+}
+
+void rebuildConfigurationFrames() {
+    std::lock_guard lock(configurationFramesMutex);
+    configurationFrames.store(buildConfigurationFrames(), std::memory_order_release);
+}
+
+static std::shared_ptr<const ConfigurationFrames> currentConfigurationFrames() {
+    std::shared_ptr<const ConfigurationFrames> frames = configurationFrames.load(std::memory_order_acquire);
+    std::filesystem::file_time_type writeTime = registryWriteTime();
+    if (frames && frames->registryWriteTime == writeTime) {
+        return frames;
+    }
+
+    std::lock_guard lock(configurationFramesMutex);
+    frames = configurationFrames.load(std::memory_order_acquire);
+    if (!frames || frames->registryWriteTime != writeTime) {
+        frames = buildConfigurationFrames();
+        configurationFrames.store(frames, std::memory_order_release);
+    }
+    return frames;
+}
+
+void sendRegistryDataPacket(ClientConnection& client, RegistryManager& registryManager) {
+    std::shared_ptr<const ConfigurationFrames> frames = currentConfigurationFrames();
+    for (const std::shared_ptr<const SharedFrame>& frame : frames->registryData) {
+        sendPacket(client, frame);
+    }
+
+    // Chat types are looked up by their ID in this client's registry
+    for (const ChatType& chatType : chatTypes()) {
+        registryManager.addRegistryEntry("minecraft:chat_type", chatType.identifier);
+    }
+}
+
+bool sendUpdateTagsPacket(ClientConnection& client) {
+    std::shared_ptr<const ConfigurationFrames> frames = currentConfigurationFrames();
+    if (!frames->updateTags) {
+        return false;
+    }
+    return sendPacket(client, frames->updateTags);
+}
+
+void sendCommandsPacket(ClientConnection& client) {
+    sendPacket(client, currentConfigurationFrames()->commands);
+}
+
+void sendUpdateRecipes(ClientConnection& client) {
+    sendPacket(client, currentConfigurationFrames()->updateRecipes);
+}
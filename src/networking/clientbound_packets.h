@@ -6,6 +6,7 @@
 
 #include "network.h"
 #include "packet_ids.h"
+#include "packet_writer.h"
 #include "core/server.h"
 #include "entities/player.h"
 #include "enums/enums.h"
@@ -21,23 +22,20 @@ enum class GameEvent : uint8_t;
 class Entity;
 struct Position;
 
-void sendRemoveEntityPacket(const int32_t& entityID);
+void sendRemoveEntityPacket(ClientConnection& client, const std::vector<int32_t>& entityIDs);
 void sendPlayerInfoRemove(const std::shared_ptr<Player>& player);
+// Builds the frames sent to every joining player up front, instead of on the first join.
+// Call again when the recipes or command graph change.
+void rebuildConfigurationFrames();
 void sendRegistryDataPacket(ClientConnection& client, RegistryManager& registryManager);
 void sendWorldEventPacket(ClientConnection& client, const int& worldEvent, const Position& position, const int& data);
 bool sendUpdateTagsPacket(ClientConnection& client);
 void sendJoinGamePacket(ClientConnection& client, int32_t entityID);
 void sendSynchronizePlayerPositionPacket(ClientConnection& client, const std::shared_ptr<Player> &player);
-void sendEntityRelativeMovePacket(const std::shared_ptr<Entity>& entity, short deltaX, short deltaY, short deltaZ);
-void sendPlayerRelativeMovePacket(const std::shared_ptr<Player>& player, short deltaX, short deltaY, short deltaZ);
-void sendEntityLookAndRelativeMovePacket(const std::shared_ptr<Player>& player, short deltaX, short deltaY, short deltaZ, float yaw, float pitch);
-void sendEntityRotationPacket(const std::shared_ptr<Player>& player);
-void sendHeadRotationPacket(const std::shared_ptr<Player>& player);
-void sendEntityTeleportPacket(const std::shared_ptr<Player>& player);
-void sendSpawnEntityPacket(const std::shared_ptr<Entity>& entity);
 void sendSpawnEntityPacket(ClientConnection& client, const std::shared_ptr<Entity>& entity);
 void sendEntityEventPacket(ClientConnection& client, int32_t entityID, uint8_t entityStatus);
 void sendPlayerInfoUpdate(ClientConnection& targetClient, const std::vector<std::shared_ptr<Player>>& playersToUpdate, uint8_t actions);
+void broadcastPlayerInfoUpdate(const std::vector<std::shared_ptr<Player>>& playersToUpdate, uint8_t actions, const std::string& excludeUUID = "");
 void sendGameEventPacket(ClientConnection& targetClient, GameEvent event, float value);
 void sendGameEvent(GameEvent event, float value);
 void sendChangeGamemode(ClientConnection& client, const std::shared_ptr<Player>& player, Gamemode gameMode);
@@ -53,6 +51,7 @@ void sendResourcePacks(ClientConnection& client);
 void sendRemoveResourcePacks(ClientConnection& client, const std::vector<std::string>& uuidsToRemove = {});
 bool sendKeepAlivePacket(ClientConnection& client);
 void sendEntityMetadataPacket(const std::vector<MetadataEntry>& metadataEntries, int32_t entityID);
+void sendEntityMetadataPacket(ClientConnection& client, const std::vector<MetadataEntry>& metadataEntries, int32_t entityID);
 void sendEntityMetadataPacket(const std::shared_ptr<Player>& player, const std::vector<MetadataEntry>& metadataEntries, int32_t entityID);
 void sendEntityAnimation(const std::shared_ptr<Player> & player, EntityAnimation animation);
 void sendAcknowledgeBlockChange(ClientConnection& client, size_t sequenceID);
@@ -67,6 +66,7 @@ void sendServerPluginMessages(ClientConnection & client);
 void sendReInitializeWorldBorder(double x, double z, double size, int64_t speed, int32_t warningBlocks, int32_t warningTime);
 void sendInitializeWorldBorder(ClientConnection& client, const WorldBorder& border);
 void sendTimeUpdatePacket(ClientConnection& client);
+void broadcastTimeUpdatePacket();
 void sendSetBorderCenter(double x, double z);
 void sendSetBorderLerpSize(double newDiameter, int64_t speed);
 void sendSetBorderSize(double newDiameter);
@@ -76,7 +76,6 @@ void sendBossbar(Bossbar& bossbar, int32_t action);
 void sendCommandSuggestionsResponse(ClientConnection& client, int32_t transactionID, const std::vector<std::string>& suggestions, int32_t start);
 void sendBundleDelimiter(ClientConnection& client);
 void sendBundleDelimiter();
-void sendEntityVelocity(const std::shared_ptr<Entity>& entity);
 void sendPickUpItem(const std::shared_ptr<Entity>& collectedEntity, const std::shared_ptr<Entity>& collectorEntity, int8_t count);
 void SendSetContainerSlot(ClientConnection& client, int8_t windowID, int32_t stateID, uint16_t slotID, const SlotData& slot);
 void sendUpdateRecipes(ClientConnection& client);
@@ -88,33 +87,32 @@ void sendPlayerAbilities(ClientConnection& client, uint8_t flags, float flyingSp
 
 template<typename... Args>
 void sendTranslatedChatMessage(const std::string& key, const bool actionBar = false, const std::string& color = "white", const std::vector<std::shared_ptr<Player>>* players = nullptr, bool log = true, Args&&... args) {
-    std::vector<uint8_t> packetData = { };
+    PacketWriter writer;
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     if (players == nullptr) {
         for (const auto &player: globalPlayers | std::views::values) {
-            packetData.clear();
-            packetData.push_back(SYSTEM_CHAT_MESSAGE);
+            writer.reset(SYSTEM_CHAT_MESSAGE);
 
             nbt::tag_compound textCompound = createTextComponent(getTranslation(key, player->lang, std::forward<Args>(args)...), color);
             std::vector<uint8_t> textData = serializeNBT(textCompound, true);
             packetData.insert(packetData.end(), textData.begin(), textData.end());
 
             writeByte(packetData, actionBar);
-            sendPacket(*player->client, packetData);
+            sendPacket(*player->client, writer);
         }
     }
     else {
         for (const auto& player : *players) {
             if (player->client != nullptr) {
-                packetData.clear();
-                packetData.push_back(SYSTEM_CHAT_MESSAGE);
+                writer.reset(SYSTEM_CHAT_MESSAGE);
 
                 nbt::tag_compound textCompound = createTextComponent(getTranslation(key, player->lang, std::forward<Args>(args)...), color);
                 std::vector<uint8_t> textData = serializeNBT(textCompound, true);
                 packetData.insert(packetData.end(), textData.begin(), textData.end());
 
                 writeByte(packetData, actionBar);
-                sendPacket(*player->client, packetData);
+                sendPacket(*player->client, writer);
             }
         }
     }
@@ -0,0 +1,121 @@
+#include "compression_policy.h"
+
+#include <array>
+#include <atomic>
+#include <sstream>
+
+#include "packet_stats.h"
+#include "core/config.h"
+#include "core/utils.h"
+
+constexpr size_t MAX_PACKET_ID = 256;
+constexpr uint64_t MIN_SAMPLES = 32;     // Packets to measure before a type can be disabled
+constexpr uint64_t PROBE_INTERVAL = 256; // A disabled type is still compressed this often to notice changes
+constexpr double RATIO_SMOOTHING = 0.05;
+
+struct PacketTypeState {
+    std::atomic<uint64_t> packets{0};
+    std::atomic<uint64_t> skipped{0};
+    std::atomic<uint64_t> rawBytes{0};
+    std::atomic<uint64_t> compressedBytes{0};
+    std::atomic<double> ratio{1.0};
+    std::atomic<bool> disabled{false};
+};
+
+static std::array<PacketTypeState, MAX_PACKET_ID> packetTypes;
+
+static int32_t peekPacketID(std::span<const uint8_t> payload) {
+    int32_t value = 0;
+    for (size_t i = 0; i < payload.size() && i < 5; i++) {
+        value |= (payload[i] & 0x7F) << (7 * i);
+        if ((payload[i] & 0x80) == 0) {
+            return value;
+        }
+    }
+    return -1;
+}
+
+static int levelFor(int32_t packetID) {
+    const auto& policy = serverConfig.compressionPolicy;
+    auto it = policy.packetLevels.find(packetID);
+    return it != policy.packetLevels.end() ? it->second : policy.defaultLevel;
+}
+
+static void record(PacketTypeState& state, int32_t packetID, size_t rawSize, size_t compressedSize) {
+    uint64_t samples = state.packets.fetch_add(1, std::memory_order_relaxed) + 1;
+    state.rawBytes.fetch_add(rawSize, std::memory_order_relaxed);
+    state.compressedBytes.fetch_add(compressedSize, std::memory_order_relaxed);
+
+    // Exponential moving average, so a type that changes shape is re-evaluated. Races only lose a sample.
+    double sample = static_cast<double>(compressedSize) / static_cast<double>(rawSize);
+    double ratio = samples == 1 ? sample : state.ratio.load(std::memory_order_relaxed) * (1.0 - RATIO_SMOOTHING) + sample * RATIO_SMOOTHING;
+    state.ratio.store(ratio, std::memory_order_relaxed);
+
+    if (samples < MIN_SAMPLES) {
+        return;
+    }
+    bool disable = ratio > serverConfig.compressionPolicy.maxRatio;
+    if (state.disabled.exchange(disable, std::memory_order_relaxed) != disable) {
+        std::stringstream stringstream;
+        stringstream << "Compression " << (disable ? "disabled" : "re-enabled") << " for packet ID 0x" << std::hex << packetID
+                     << std::dec << " (ratio " << ratio << ")";
+        logMessage(stringstream.str(), LOG_DEBUG);
+    }
+}
+
+bool compressPacket(std::span<const uint8_t> payload, std::vector<uint8_t>& out, size_t offset) {
+    if (payload.size() < static_cast<size_t>(serverConfig.compressionThreshold)) {
+        return false;
+    }
+
+    int32_t packetID = peekPacketID(payload);
+    int level = levelFor(packetID);
+    PacketTypeState* state = packetID >= 0 && packetID < static_cast<int32_t>(MAX_PACKET_ID) ? &packetTypes[packetID] : nullptr;
+
+    if (level == 0) {
+        if (state) state->skipped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (state && state->disabled.load(std::memory_order_relaxed)) {
+        uint64_t skipped = state->skipped.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (skipped % PROBE_INTERVAL != 0) {
+            return false;
+        }
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    try {
+        compressData(payload, out, offset, level);
+    } catch (const std::exception& e) {
+        logMessage("Compression failed: " + std::string(e.what()), LOG_ERROR);
+        return false;
+    }
+
+    recordCompression(packetID, out.size() - offset, nanosSince(started));
+    if (state) {
+        record(*state, packetID, payload.size(), out.size() - offset);
+    }
+    return true;
+}
+
+std::vector<PacketCompressionStats> getCompressionStats() {
+    std::vector<PacketCompressionStats> stats;
+    for (size_t id = 0; id < MAX_PACKET_ID; id++) {
+        const PacketTypeState& state = packetTypes[id];
+        uint64_t packets = state.packets.load(std::memory_order_relaxed);
+        uint64_t skipped = state.skipped.load(std::memory_order_relaxed);
+        if (packets == 0 && skipped == 0) {
+            continue;
+        }
+        stats.push_back({
+            static_cast<int32_t>(id),
+            packets,
+            skipped,
+            state.rawBytes.load(std::memory_order_relaxed),
+            state.compressedBytes.load(std::memory_order_relaxed),
+            state.ratio.load(std::memory_order_relaxed),
+            state.disabled.load(std::memory_order_relaxed)
+        });
+    }
+    return stats;
+}
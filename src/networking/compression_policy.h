@@ -0,0 +1,26 @@
+#ifndef COMPRESSION_POLICY_H
+#define COMPRESSION_POLICY_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+struct PacketCompressionStats {
+    int32_t packetID;
+    uint64_t packets;         // Payloads that were deflated
+    uint64_t skipped;         // Payloads over the threshold that were sent uncompressed
+    uint64_t rawBytes;
+    uint64_t compressedBytes;
+    double ratio;             // Running compressed/raw ratio
+    bool disabled;            // Compression stopped because the type doesn't shrink
+};
+
+// Deflates a packet payload (Packet ID + Data) into out, starting at offset, if it reaches
+// the compression threshold and its packet type is worth compressing. The level comes from
+// serverConfig.compressionPolicy. Returns false if the payload should be sent uncompressed.
+bool compressPacket(std::span<const uint8_t> payload, std::vector<uint8_t>& out, size_t offset);
+
+// Snapshot of every packet type that has reached the compression threshold
+std::vector<PacketCompressionStats> getCompressionStats();
+
+#endif //COMPRESSION_POLICY_H
@@ -0,0 +1,181 @@
+#include "entity_sync.h"
+
+#include "client.h"
+#include "network.h"
+#include "packet_ids.h"
+#include "packet_writer.h"
+#include "shared_frame.h"
+#include "core/server.h"
+#include "entities/entity.h"
+#include "entities/player.h"
+
+// The client rejects bundles with more packets than this
+constexpr size_t MAX_BUNDLE_PACKETS = 4096;
+
+static uint8_t angleToByte(float angle) {
+    return static_cast<uint8_t>(angle / (360.0f / 256.0f));
+}
+
+static bool fitsShort(int32_t value) {
+    return value >= INT16_MIN && value <= INT16_MAX;
+}
+
+EntitySync::DirtyEntity& EntitySync::mark(const std::shared_ptr<Entity>& entity) {
+    DirtyEntity& state = dirty[entity->entityID];
+    state.entity = entity;
+    return state;
+}
+
+void EntitySync::markMoved(const std::shared_ptr<Entity>& entity, short deltaX, short deltaY, short deltaZ) {
+    std::lock_guard lock(mutex);
+    DirtyEntity& state = mark(entity);
+    state.moved = true;
+    state.deltaX += deltaX;
+    state.deltaY += deltaY;
+    state.deltaZ += deltaZ;
+    if (!fitsShort(state.deltaX) || !fitsShort(state.deltaY) || !fitsShort(state.deltaZ)) {
+        state.teleported = true;
+    }
+}
+
+void EntitySync::markTeleported(const std::shared_ptr<Entity>& entity) {
+    std::lock_guard lock(mutex);
+    mark(entity).teleported = true;
+}
+
+void EntitySync::markRotated(const std::shared_ptr<Entity>& entity) {
+    std::lock_guard lock(mutex);
+    mark(entity).rotated = true;
+}
+
+void EntitySync::markHeadRotated(const std::shared_ptr<Entity>& entity) {
+    std::lock_guard lock(mutex);
+    mark(entity).headRotated = true;
+}
+
+void EntitySync::markVelocityChanged(const std::shared_ptr<Entity>& entity) {
+    std::array<int16_t, 3> velocity = {
+        static_cast<int16_t>(entity->getMotionX() * 8000),
+        static_cast<int16_t>(entity->getMotionY() * 8000),
+        static_cast<int16_t>(entity->getMotionZ() * 8000)
+    };
+    std::lock_guard lock(mutex);
+    auto [sent, first] = sentVelocities.try_emplace(entity->entityID, velocity);
+    if (!first && sent->second == velocity) {
+        return;
+    }
+    sent->second = velocity;
+    DirtyEntity& state = mark(entity);
+    state.velocityChanged = true;
+    state.velocity = velocity;
+}
+
+void EntitySync::forget(int32_t entityID) {
+    std::lock_guard lock(mutex);
+    dirty.erase(entityID);
+    sentVelocities.erase(entityID);
+}
+
+// Builds the packets for one entity's changes this tick
+void EntitySync::buildUpdates(const DirtyEntity& state, std::vector<std::shared_ptr<const SharedFrame>>& frames) {
+    const Entity& entity = *state.entity;
+    PacketWriter writer;
+    // Moves that added up to nothing are left out
+    bool moved = state.moved && (state.deltaX != 0 || state.deltaY != 0 || state.deltaZ != 0);
+
+    if (state.teleported) {
+        // Absolute position and rotation
+        writer.reset(TELEPORT_ENTITY);
+        std::vector<uint8_t>& packetData = writer.buffer();
+        writeVarInt(packetData, entity.entityID);
+        writeDouble(packetData, entity.position.x);
+        writeDouble(packetData, entity.position.y);
+        writeDouble(packetData, entity.position.z);
+        packetData.push_back(angleToByte(entity.rotation.yaw));
+        packetData.push_back(angleToByte(entity.rotation.pitch));
+        packetData.push_back(entity.onGround ? 0x01 : 0x00);
+        frames.push_back(std::make_shared<const SharedFrame>(writer.payload()));
+    } else if (moved || state.rotated) {
+        // Relative move and/or look in a single packet
+        writer.reset(moved ? (state.rotated ? UPDATE_ENTITY_POSITION_AND_ROTATION : UPDATE_ENTITY_POSITION) : UPDATE_ENTITY_ROTATION);
+        std::vector<uint8_t>& packetData = writer.buffer();
+        writeVarInt(packetData, entity.entityID);
+        if (moved) {
+            writeShort(packetData, static_cast<int16_t>(state.deltaX));
+            writeShort(packetData, static_cast<int16_t>(state.deltaY));
+            writeShort(packetData, static_cast<int16_t>(state.deltaZ));
+        }
+        if (state.rotated) {
+            packetData.push_back(angleToByte(entity.rotation.yaw));
+            packetData.push_back(angleToByte(entity.rotation.pitch));
+        }
+        packetData.push_back(entity.onGround ? 0x01 : 0x00);
+        frames.push_back(std::make_shared<const SharedFrame>(writer.payload()));
+    }
+
+    if (state.headRotated) {
+        writer.reset(SET_HEAD_ROTATION);
+        std::vector<uint8_t>& packetData = writer.buffer();
+        writeVarInt(packetData, entity.entityID);
+        packetData.push_back(angleToByte(entity.rotation.headYaw));
+        frames.push_back(std::make_shared<const SharedFrame>(writer.payload()));
+    }
+
+    if (state.velocityChanged) {
+        writer.reset(SET_ENTITY_VELOCITY);
+        std::vector<uint8_t>& packetData = writer.buffer();
+        writeVarInt(packetData, entity.entityID);
+        writeShort(packetData, state.velocity[0]);
+        writeShort(packetData, state.velocity[1]);
+        writeShort(packetData, state.velocity[2]);
+        frames.push_back(std::make_shared<const SharedFrame>(writer.payload()));
+    }
+}
+
+void EntitySync::flush() {
+    std::unordered_map<int32_t, DirtyEntity> changes;
+    {
+        std::lock_guard lock(mutex);
+        changes.swap(dirty);
+    }
+    if (changes.empty()) {
+        return;
+    }
+
+    // Frame every update once and collect them per client, for the players that can see the entity
+    std::unordered_map<std::shared_ptr<ClientConnection>, std::vector<std::shared_ptr<const SharedFrame>>> bundles;
+    std::vector<std::shared_ptr<const SharedFrame>> frames;
+    for (const auto& [entityID, state] : changes) {
+        frames.clear();
+        buildUpdates(state, frames);
+        entityTracker.forEachViewer(entityID, [&](const std::shared_ptr<Player>& viewer) {
+            if (!viewer->client) {
+                return;
+            }
+            if (auto client = viewer->client->weak_from_this().lock()) {
+                auto& bundle = bundles[client];
+                bundle.insert(bundle.end(), frames.begin(), frames.end());
+            }
+        });
+    }
+
+    PacketWriter writer(BUNDLE_DELIMITER);
+    auto delimiter = std::make_shared<const SharedFrame>(writer.payload());
+
+    for (const auto& [client, bundle] : bundles) {
+        // A lone update does not need a bundle, larger sets are split to stay within the client's limit
+        if (bundle.size() == 1) {
+            sendPacket(*client, bundle.front());
+            continue;
+        }
+        sendPacket(*client, delimiter);
+        for (size_t i = 0; i < bundle.size(); i++) {
+            if (i > 0 && i % MAX_BUNDLE_PACKETS == 0) {
+                sendPacket(*client, delimiter);
+                sendPacket(*client, delimiter);
+            }
+            sendPacket(*client, bundle[i]);
+        }
+        sendPacket(*client, delimiter);
+    }
+}
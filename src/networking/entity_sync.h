@@ -0,0 +1,57 @@
+#ifndef ENTITY_SYNC_H
+#define ENTITY_SYNC_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class Entity;
+class SharedFrame;
+
+// Collects entity state changes during a tick and sends them at the end of it.
+// Everything marked for an entity is folded into the fewest packets that describe it
+// (a single relative move, move and look, or teleport, plus head yaw and velocity),
+// and each client that can see the entity (see EntityTracker) receives all of its updates
+// for the tick in one bundle.
+class EntitySync {
+public:
+    // Relative move in 1/4096 blocks. Moves add up over the tick, a teleport is sent once they no longer fit.
+    void markMoved(const std::shared_ptr<Entity>& entity, short deltaX, short deltaY, short deltaZ);
+    void markTeleported(const std::shared_ptr<Entity>& entity);
+    void markRotated(const std::shared_ptr<Entity>& entity);
+    void markHeadRotated(const std::shared_ptr<Entity>& entity);
+    // Only marks the entity if its velocity differs from the last one sent for it
+    void markVelocityChanged(const std::shared_ptr<Entity>& entity);
+
+    // Drops pending updates for an entity that has been removed
+    void forget(int32_t entityID);
+
+    // Sends everything marked since the last call. Called by the tick loop.
+    void flush();
+
+private:
+    struct DirtyEntity {
+        std::shared_ptr<Entity> entity;
+        int32_t deltaX = 0;
+        int32_t deltaY = 0;
+        int32_t deltaZ = 0;
+        bool moved = false;
+        bool teleported = false;
+        bool rotated = false;
+        bool headRotated = false;
+        bool velocityChanged = false;
+        std::array<int16_t, 3> velocity{}; // In 1/8000 blocks per tick, as sent
+    };
+
+    DirtyEntity& mark(const std::shared_ptr<Entity>& entity);
+    static void buildUpdates(const DirtyEntity& state, std::vector<std::shared_ptr<const SharedFrame>>& frames);
+
+    std::mutex mutex;
+    std::unordered_map<int32_t, DirtyEntity> dirty;
+    std::unordered_map<int32_t, std::array<int16_t, 3>> sentVelocities; // Last velocity sent per entity
+};
+
+#endif //ENTITY_SYNC_H
@@ -0,0 +1,151 @@
+#include "entity_tracker.h"
+
+#include <algorithm>
+#include <ranges>
+
+#include "client.h"
+#include "clientbound_packets.h"
+#include "network.h"
+#include "packet_writer.h"
+#include "shared_frame.h"
+#include "core/server.h"
+#include "core/utils.h"
+#include "entities/entity.h"
+#include "entities/item_entity.h"
+#include "entities/player.h"
+#include "world/chunk.h"
+
+int trackingRange(EntityType type) {
+    switch (type) {
+        case EntityType::Player:
+            return 32;
+        case EntityType::Item:
+            return 6;
+        default:
+            return 5;
+    }
+}
+
+// What a viewer has to be told after an update
+struct ViewerChanges {
+    std::vector<std::shared_ptr<Entity>> spawned;
+    std::vector<int32_t> destroyed;
+};
+
+static void sendViewerChanges(ClientConnection& client, const ViewerChanges& changes) {
+    // Spawns go out together with the entity's metadata, everything in one bundle
+    size_t packets = changes.destroyed.empty() ? 0 : 1;
+    for (const auto& entity : changes.spawned) {
+        packets += entity->type == EntityType::Item ? 2 : 1;
+    }
+    bool bundled = packets > 1;
+    if (bundled) {
+        sendBundleDelimiter(client);
+    }
+    if (!changes.destroyed.empty()) {
+        sendRemoveEntityPacket(client, changes.destroyed);
+    }
+    for (const auto& entity : changes.spawned) {
+        sendSpawnEntityPacket(client, entity);
+        if (entity->type == EntityType::Item) {
+            sendEntityMetadataPacket(client, std::static_pointer_cast<Item>(entity)->getMetadata(), entity->entityID);
+        }
+    }
+    if (bundled) {
+        sendBundleDelimiter(client);
+    }
+}
+
+void EntityTracker::update() {
+    std::unordered_map<int32_t, std::shared_ptr<Entity>> entities = entityManager.getAllEntities();
+
+    std::lock_guard lock(mutex);
+    std::unordered_map<std::shared_ptr<Player>, ViewerChanges> changes;
+    std::vector<std::shared_ptr<Player>> current;
+    {
+        std::lock_guard viewersLock(chunkViewersMutex);
+        for (const auto& entity : entities | std::views::values) {
+            ChunkCoordinates coords{getChunkCoordinate(entity->position.x), getChunkCoordinate(entity->position.z)};
+            int range = trackingRange(entity->type);
+
+            current.clear();
+            auto it = chunkViewersMap.find(coords);
+            if (it != chunkViewersMap.end()) {
+                for (const auto& player : it->second) {
+                    if (player.get() == entity.get()) {
+                        continue;
+                    }
+                    if (std::max(std::abs(player->currentChunkX - coords.chunkX), std::abs(player->currentChunkZ - coords.chunkZ)) <= range) {
+                        current.push_back(player);
+                    }
+                }
+            }
+
+            std::vector<std::shared_ptr<Player>>& previous = viewers[entity->entityID];
+            for (const auto& player : current) {
+                if (std::ranges::find(previous, player) == previous.end()) {
+                    changes[player].spawned.push_back(entity);
+                }
+            }
+            for (const auto& player : previous) {
+                if (std::ranges::find(current, player) == current.end()) {
+                    changes[player].destroyed.push_back(entity->entityID);
+                }
+            }
+            previous.swap(current);
+        }
+    }
+
+    for (const auto& [player, playerChanges] : changes) {
+        if (player->client) {
+            sendViewerChanges(*player->client, playerChanges);
+        }
+    }
+}
+
+void EntityTracker::remove(int32_t entityID) {
+    std::lock_guard lock(mutex);
+    auto it = viewers.find(entityID);
+    if (it == viewers.end()) {
+        return;
+    }
+    const std::vector<int32_t> entityIDs{entityID};
+    for (const auto& player : it->second) {
+        if (player->client) {
+            sendRemoveEntityPacket(*player->client, entityIDs);
+        }
+    }
+    viewers.erase(it);
+}
+
+void EntityTracker::removeViewer(const std::shared_ptr<Player>& player) {
+    std::lock_guard lock(mutex);
+    for (auto& entityViewers : viewers | std::views::values) {
+        std::erase(entityViewers, player);
+    }
+}
+
+void EntityTracker::forEachViewer(int32_t entityID, const std::function<void(const std::shared_ptr<Player>&)>& f) {
+    std::lock_guard lock(mutex);
+    auto it = viewers.find(entityID);
+    if (it == viewers.end()) {
+        return;
+    }
+    for (const auto& player : it->second) {
+        f(player);
+    }
+}
+
+void EntityTracker::sendToViewers(int32_t entityID, PacketWriter& writer) {
+    std::shared_ptr<const SharedFrame> frame;
+    forEachViewer(entityID, [&](const std::shared_ptr<Player>& player) {
+        if (!player->client) {
+            return;
+        }
+        // Compress and frame once, only the encryption is done per client
+        if (!frame) {
+            frame = std::make_shared<const SharedFrame>(writer.payload());
+        }
+        sendPacket(*player->client, frame);
+    });
+}
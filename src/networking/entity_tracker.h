@@ -0,0 +1,45 @@
+#ifndef ENTITY_TRACKER_H
+#define ENTITY_TRACKER_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class Entity;
+class PacketWriter;
+struct Player;
+enum class EntityType : int32_t;
+
+// How far away (in chunks) players see an entity of the given type
+int trackingRange(EntityType type);
+
+// Keeps track of which players can see which entities.
+// An entity's candidate viewers are the players whose view contains its chunk (chunkViewersMap),
+// narrowed down by the tracking range of its type. Entities are spawned for a player when they
+// come into range and destroyed when they leave it, and entity updates only go to current viewers.
+class EntityTracker {
+public:
+    // Re-evaluates the viewers of every entity, spawning and destroying entities on clients. Called by the tick loop.
+    void update();
+
+    // Destroys a removed entity on the clients that can see it
+    void remove(int32_t entityID);
+
+    // Forgets a disconnecting player. Must be called before its connection goes away.
+    void removeViewer(const std::shared_ptr<Player>& player);
+
+    // Calls f for every player that can see the entity, with the tracker locked
+    void forEachViewer(int32_t entityID, const std::function<void(const std::shared_ptr<Player>&)>& f);
+
+    // Sends a packet about an entity to every player that can see it
+    void sendToViewers(int32_t entityID, PacketWriter& writer);
+
+private:
+    std::mutex mutex;
+    std::unordered_map<int32_t, std::vector<std::shared_ptr<Player>>> viewers; // Key: Entity ID
+};
+
+#endif //ENTITY_TRACKER_H
@@ -6,12 +6,19 @@
 constexpr int MAX_RETRIES = 3;
 constexpr int RETRY_DELAY_MS = 1000; // 1 second
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <nlohmann/json.hpp>
 #include <nlohmann/json_fwd.hpp>
 #include "cppcodec/base64_rfc4648.hpp"
 #include "../thirdparty/httplib.h"
+#include "utils/thread_pool.h"
 
 std::vector<std::string> ca_paths = {
         "/etc/ssl/certs/ca-certificates.crt",               // Debian/Ubuntu/Gentoo etc.
@@ -22,40 +29,146 @@ std::vector<std::string> ca_paths = {
         "/etc/ssl/cert.pem",                                // Alpine Linux, macOS
 };
 
-std::string httpGet(const std::string& host, const std::string& path) {
-    httplib::SSLClient cli(host.c_str());
+// Idle keep-alive connections kept open per base URL
+constexpr size_t MAX_IDLE_CLIENTS = 16;
+constexpr time_t CONNECT_TIMEOUT_S = 5;
+constexpr time_t READ_TIMEOUT_S = 10;
+// Size at which a profile cache sweeps out its expired entries
+constexpr size_t MAX_CACHE_ENTRIES = 4096;
 
 #ifndef _WIN32
-    bool set_ca_cert = false;
-    for (const auto& path : ca_paths) {
-        if (access(path.c_str(), R_OK) == 0) {
-            cli.set_ca_cert_path(path.c_str());
-            set_ca_cert = true;
-            break;
+static const std::string& caCertPath() {
+    static const std::string path = [] {
+        for (const auto& candidate : ca_paths) {
+            if (access(candidate.c_str(), R_OK) == 0) {
+                return candidate;
+            }
         }
-    }
-    if (!set_ca_cert) {
         logMessage("No CA certificates found on system. SSL connections may fail.", LOG_ERROR);
+        return std::string();
+    }();
+    return path;
+}
+#endif
+
+// Clients are kept connected after a request, TLS session included, so the next request to the
+// same host skips the handshake. Each one is only ever used by one thread at a time.
+static std::mutex idleClientsMutex;
+static std::unordered_map<std::string, std::vector<std::unique_ptr<httplib::Client>>> idleClients;
+
+static std::unique_ptr<httplib::Client> acquireClient(const std::string& baseURL) {
+    {
+        std::lock_guard lock(idleClientsMutex);
+        auto it = idleClients.find(baseURL);
+        if (it != idleClients.end() && !it->second.empty()) {
+            std::unique_ptr<httplib::Client> client = std::move(it->second.back());
+            it->second.pop_back();
+            return client;
+        }
     }
-    cli.enable_server_certificate_verification(true);
+
+    auto client = std::make_unique<httplib::Client>(baseURL);
+#ifndef _WIN32
+    if (!caCertPath().empty()) {
+        client->set_ca_cert_path(caCertPath());
+    }
+    client->enable_server_certificate_verification(true);
 #endif
-    cli.set_follow_location(true);
+    client->set_keep_alive(true);
+    client->set_follow_location(true);
+    client->set_connection_timeout(CONNECT_TIMEOUT_S);
+    client->set_read_timeout(READ_TIMEOUT_S);
+    return client;
+}
+
+static void releaseClient(const std::string& baseURL, std::unique_ptr<httplib::Client> client) {
+    std::lock_guard lock(idleClientsMutex);
+    std::vector<std::unique_ptr<httplib::Client>>& idle = idleClients[baseURL];
+    if (idle.size() < MAX_IDLE_CLIENTS) {
+        idle.push_back(std::move(client));
+    }
+}
+
+static httplib::Result pooledGet(const std::string& baseURL, const std::string& path) {
+    std::unique_ptr<httplib::Client> client = acquireClient(baseURL);
+    httplib::Result res = client->Get(path);
+    // A failed request may leave the connection in any state, the next one starts fresh
+    if (res) {
+        releaseClient(baseURL, std::move(client));
+    }
+    return res;
+}
+
+// Remembers Mojang API answers for profile_cache_ttl seconds, so players reconnecting after a
+// restart don't each wait on another round trip
+template<typename Value>
+class ExpiringCache {
+public:
+    std::optional<Value> get(const std::string& key) {
+        std::lock_guard lock(mutex);
+        auto it = entries.find(key);
+        if (it == entries.end()) {
+            return std::nullopt;
+        }
+        if (std::chrono::steady_clock::now() >= it->second.expiry) {
+            entries.erase(it);
+            return std::nullopt;
+        }
+        return it->second.value;
+    }
+
+    void put(const std::string& key, Value value) {
+        if (serverConfig.profileCacheTTL <= 0) {
+            return;
+        }
+        auto now = std::chrono::steady_clock::now();
+        std::lock_guard lock(mutex);
+        if (entries.size() >= MAX_CACHE_ENTRIES) {
+            std::erase_if(entries, [now](const auto& entry) { return entry.second.expiry <= now; });
+            if (entries.size() >= MAX_CACHE_ENTRIES) {
+                entries.clear();
+            }
+        }
+        entries[key] = {std::move(value), now + std::chrono::seconds(serverConfig.profileCacheTTL)};
+    }
+
+private:
+    struct Entry {
+        Value value;
+        std::chrono::steady_clock::time_point expiry;
+    };
+
+    std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+};
+
+static ExpiringCache<std::string> uuidCache; // By lowercase player name
+static ExpiringCache<std::pair<std::string, std::string>> texturesCache; // Value and signature, by UUID
+
+static std::string lowercase(std::string name) {
+    std::ranges::transform(name, name.begin(), [](unsigned char c) { return std::tolower(c); });
+    return name;
+}
 
-    auto res = cli.Get(path.c_str());
+std::string httpGet(const std::string& baseURL, const std::string& path) {
+    auto res = pooledGet(baseURL, path);
 
     if (res && res->status == 200) {
         return res->body;
     }
 
-    logMessage("HTTP GET request failed for " + host + path, LOG_ERROR);
+    logMessage("HTTP GET request failed for " + baseURL + path, LOG_ERROR);
     return "";
 }
 
 std::string fetchPlayerUUID(const std::string& name) {
-    std::string host = "api.mojang.com";
+    if (std::optional<std::string> cached = uuidCache.get(lowercase(name))) {
+        return *cached;
+    }
+
     std::string path = "/users/profiles/minecraft/" + name;
 
-    std::string response = httpGet(host, path);
+    std::string response = httpGet(serverConfig.profileApiURL, path);
 
     if (response.empty()) {
         logMessage("Failed to fetch UUID for: " + name, LOG_ERROR);
@@ -77,14 +190,19 @@ std::string fetchPlayerUUID(const std::string& name) {
         return "";
     }
 
-    return profileJson["id"];
+    std::string uuid = profileJson["id"];
+    uuidCache.put(lowercase(name), uuid);
+    return uuid;
 }
 
 std::pair<std::string, std::string> fetchPlayerSkin(const std::string& uuid) {
-    std::string host = "sessionserver.mojang.com";
+    if (std::optional<std::pair<std::string, std::string>> cached = texturesCache.get(uuid)) {
+        return *cached;
+    }
+
     std::string path = "/session/minecraft/profile/" + uuid + "?unsigned=false";
 
-    std::string response = httpGet(host, path);
+    std::string response = httpGet(serverConfig.sessionServerURL, path);
 
     if (response.empty()) {
         logMessage("Failed to fetch profile for UUID: " + uuid, LOG_ERROR);
@@ -108,7 +226,9 @@ std::pair<std::string, std::string> fetchPlayerSkin(const std::string& uuid) {
 
     for (const auto& prop : profileJson["properties"]) {
         if (prop["name"] == "textures" && prop.contains("value")) {
-            return { prop["value"], prop["signature"] };
+            std::pair<std::string, std::string> textures = { prop["value"], prop.value("signature", "") };
+            texturesCache.put(uuid, textures);
+            return textures;
         }
     }
 
@@ -151,29 +271,12 @@ std::string extractSkinURL(const std::string& texturesBase64) {
     return texturesJson["textures"]["SKIN"]["url"].get<std::string>();
 }
 
-bool authenticatePlayer(const std::string& username, const std::string& serverHash, const std::string& ipAddress, std::string& outUUID, std::string& outName, std::pair<std::string, std::string>& skinTexturesPair) {
-    httplib::Client sessionClient("sessionserver.mojang.com");
-
+static AuthResult authenticatePlayer(const std::string& username, const std::string& serverHash, const std::string& ipAddress) {
     std::string endpoint = "/session/minecraft/hasJoined?username=" + httplib::detail::encode_query_param(username) + "&serverId=" + httplib::detail::encode_query_param(serverHash);
 
-#ifndef _WIN32
-    bool set_ca_cert = false;
-    for (const auto& path : ca_paths) {
-        if (access(path.c_str(), R_OK) == 0) {
-            sessionClient.set_ca_cert_path(path.c_str());
-            set_ca_cert = true;
-            break;
-        }
-    }
-    if (!set_ca_cert) {
-        logMessage("No CA certificates fouifnd on system. SSL connections may fail.", LOG_ERROR);
-    }
-    sessionClient.enable_server_certificate_verification(true);
-#endif
-    sessionClient.set_follow_location(true);
-
+    AuthResult result;
     for (int tryCount = 0; tryCount < MAX_RETRIES; ++tryCount) {
-        auto res = sessionClient.Get(endpoint.c_str());
+        auto res = pooledGet(serverConfig.sessionServerURL, endpoint);
 
         if (res && res->status == 200) {
             // Parse JSON response
@@ -182,23 +285,29 @@ bool authenticatePlayer(const std::string& username, const std::string& serverHa
                 responseJson = nlohmann::json::parse(res->body);
             } catch (const nlohmann::json::parse_error& e) {
                 logMessage("JSON parse error for authentication response: " + std::string(e.what()), LOG_ERROR);
-                return false;
+                return result;
             }
 
             if (!responseJson.contains("id") || !responseJson.contains("name")) {
                 logMessage("No UUID or name found in authentication response.", LOG_ERROR);
-                return false;
+                return result;
             }
 
-            outUUID = responseJson["id"];
-            outName = responseJson["name"];
+            result.uuid = responseJson["id"];
+            result.name = responseJson["name"];
 
             for (const auto& prop : responseJson["properties"]) {
                 if (prop["name"] == "textures" && prop.contains("value") && prop.contains("signature")) {
-                    skinTexturesPair = { prop["value"], prop["signature"] };
+                    result.textures = { prop["value"], prop["signature"] };
                 }
             }
-            return true;
+            result.success = true;
+
+            uuidCache.put(lowercase(result.name), result.uuid);
+            if (!result.textures.first.empty()) {
+                texturesCache.put(result.uuid, result.textures);
+            }
+            return result;
         }
         if (res && res->status == 204) {
             // 204 No Content: Authentication failed
@@ -208,7 +317,7 @@ bool authenticatePlayer(const std::string& username, const std::string& serverHa
                 std::this_thread::sleep_for(std::chrono::milliseconds(RETRY_DELAY_MS));
                 continue; // Retry the loop
             }
-            return false;
+            return result;
         }
         if (res && res->status == 403) {
             // 403 Forbidden: Player has multiplayer disabled or is banned
@@ -218,7 +327,7 @@ bool authenticatePlayer(const std::string& username, const std::string& serverHa
             } catch (...) {
                 logMessage("Authentication Error: 403 Forbidden", LOG_ERROR);
             }
-            return false;
+            return result;
         }
         // Handle other HTTP statuses
         if (res) {
@@ -226,12 +335,31 @@ bool authenticatePlayer(const std::string& username, const std::string& serverHa
         } else {
             logMessage("Authentication request failed: No response from session server.", LOG_ERROR);
         }
-        return false;
+        return result;
     }
 
     // If all retries are exhausted
     logMessage("Authentication failed for player " + username + " after " + std::to_string(MAX_RETRIES) + " attempts.", LOG_ERROR);
-    return false;
+    return result;
+}
+
+// Session server requests spend nearly all their time waiting, so this pool is sized for
+// concurrency rather than for the number of cores
+static thread_pool& authPool() {
+    static thread_pool pool(serverConfig.authThreads);
+    return pool;
+}
+
+void authenticatePlayerAsync(const std::string& username, const std::string& serverHash, const std::string& ipAddress, std::function<void(const AuthResult&)> onComplete) {
+    authPool().enqueue([username, serverHash, ipAddress, onComplete = std::move(onComplete)]() {
+        AuthResult result;
+        try {
+            result = authenticatePlayer(username, serverHash, ipAddress);
+        } catch (const std::exception& e) {
+            logMessage("Authentication request failed with error: " + std::string(e.what()), LOG_ERROR);
+        }
+        onComplete(result);
+    });
 }
 
 std::vector<std::string> fetchMojangPublicKeys() {
@@ -258,6 +386,24 @@ std::vector<std::string> fetchMojangPublicKeys() {
     return publicKeys;
 }
 
+static std::mutex mojangPublicKeysMutex;
+static std::vector<std::string> mojangPublicKeys; // Guarded by mojangPublicKeysMutex
+
+bool loadMojangPublicKeys() {
+    std::vector<std::string> publicKeys = fetchMojangPublicKeys();
+    if (publicKeys.empty()) {
+        return false;
+    }
+    std::lock_guard lock(mojangPublicKeysMutex);
+    mojangPublicKeys = std::move(publicKeys);
+    return true;
+}
+
+std::vector<std::string> cachedMojangPublicKeys() {
+    std::lock_guard lock(mojangPublicKeysMutex);
+    return mojangPublicKeys;
+}
+
 bool validateResourcePackURL(const ResourcePack& pack) {
     try {
         ParsedURL parsed = parseURL(pack.url);
@@ -1,6 +1,8 @@
 #ifndef FETCH_H
 #define FETCH_H
+#include <functional>
 #include <string>
+#include <utility>
 #include <vector>
 
 struct ResourcePack;
@@ -12,11 +14,26 @@ struct ParsedURL {
     std::string path;
 };
 
+// What the session server answered for a joining player
+struct AuthResult {
+    bool success = false;
+    std::string uuid;
+    std::string name;
+    std::pair<std::string, std::string> textures; // Value and signature, empty if the profile has none
+};
+
 std::string fetchPlayerUUID(const std::string& name);
 std::pair<std::string, std::string> fetchPlayerSkin(const std::string& uuid);
 std::string extractSkinURL(const std::string& texturesBase64);
-bool authenticatePlayer(const std::string& username, const std::string& serverHash, const std::string& ipAddress, std::string& outUUID, std::string& outName, std::pair<std::string, std::string>& skinTexturesPair);
+// Checks with the session server that the player joined using this server hash. The request runs on
+// the auth pool and onComplete is called there, so a slow session server ties up neither the
+// network threads nor the shared thread pool.
+void authenticatePlayerAsync(const std::string& username, const std::string& serverHash, const std::string& ipAddress, std::function<void(const AuthResult&)> onComplete);
 std::vector<std::string> fetchMojangPublicKeys();
+// Fetches Mojang's public keys once at startup. Play handlers run on the tick thread and only
+// read the cached copy, which is empty if the fetch failed.
+bool loadMojangPublicKeys();
+std::vector<std::string> cachedMojangPublicKeys();
 bool validateResourcePackURL(const ResourcePack& pack);
 bool downloadResourcePack(const ResourcePack& pack, const std::string& downloadPath);
 
@@ -0,0 +1,88 @@
+#include "inbound_buffer.h"
+
+#include <cstring>
+#include <openssl/err.h>
+#include <openssl/evp.h>
+
+#include "core/utils.h"
+
+constexpr int32_t MAX_PACKET_LENGTH = 2097151; // 3-byte VarInt
+
+InboundBuffer::InboundBuffer(const size_t initialCapacity) : storage(initialCapacity) {}
+
+std::span<uint8_t> InboundBuffer::writableSpan(const size_t minimum) {
+    if (storage.size() - writePos < minimum) {
+        // Slide unread bytes to the front before growing
+        if (readPos > 0) {
+            std::memmove(storage.data(), storage.data() + readPos, writePos - readPos);
+            writePos -= readPos;
+            decryptPos = std::max(decryptPos, readPos) - readPos;
+            readPos = 0;
+        }
+        if (storage.size() - writePos < minimum) {
+            storage.resize(std::max(storage.size() * 2, writePos + minimum));
+        }
+    }
+    return {storage.data() + writePos, storage.size() - writePos};
+}
+
+void InboundBuffer::commit(const size_t count) {
+    writePos += count;
+}
+
+bool InboundBuffer::decrypt(EVP_CIPHER_CTX* ctx) {
+    // Bytes consumed before the cipher was enabled were plaintext
+    decryptPos = std::max(decryptPos, readPos);
+    if (decryptPos == writePos) {
+        return true;
+    }
+
+    uint8_t* start = storage.data() + decryptPos;
+    int length = static_cast<int>(writePos - decryptPos);
+    int outLen = 0;
+    // CFB8 is a stream mode, so in-place decryption produces exactly as many bytes as it consumes
+    if (EVP_DecryptUpdate(ctx, start, &outLen, start, length) != 1 || outLen != length) {
+        logMessage("Failed to decrypt inbound data", LOG_ERROR);
+        ERR_print_errors_fp(stderr);
+        return false;
+    }
+    decryptPos = writePos;
+    return true;
+}
+
+PacketReadResult InboundBuffer::nextFrame(std::span<const uint8_t>& frame) {
+    // Read the length prefix (VarInt)
+    int32_t length = 0;
+    size_t index = readPos;
+    for (int shift = 0;; shift += 7) {
+        if (index >= writePos) {
+            return PacketReadResult::Incomplete;
+        }
+        uint8_t read = storage[index++];
+        length |= (read & 0x7F) << shift;
+        if ((read & 0x80) == 0) {
+            break;
+        }
+        if (shift >= 14) {
+            logMessage("VarInt length prefix is too big", LOG_ERROR);
+            return PacketReadResult::Error;
+        }
+    }
+
+    if (length <= 0 || length > MAX_PACKET_LENGTH) {
+        logMessage("Invalid packet length: " + std::to_string(length), LOG_ERROR);
+        return PacketReadResult::Error;
+    }
+    if (writePos - index < static_cast<size_t>(length)) {
+        return PacketReadResult::Incomplete;
+    }
+
+    frame = {storage.data() + index, static_cast<size_t>(length)};
+    readPos = index + length;
+
+    // Rewind to the start of the buffer whenever it drains, which keeps most reads compaction-free
+    if (readPos == writePos) {
+        readPos = decryptPos = writePos = 0;
+    }
+    return PacketReadResult::Packet;
+}
@@ -0,0 +1,39 @@
+#ifndef INBOUND_BUFFER_H
+#define INBOUND_BUFFER_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <openssl/types.h>
+
+#include "network.h"
+
+// Per-connection receive buffer.
+// recv() writes straight into the free tail, new bytes are decrypted in place with a single
+// EVP call and packets are framed as views into the buffer. Consumed space at the front is
+// reclaimed by sliding the unread bytes down, so a frame never wraps and never needs copying.
+class InboundBuffer {
+public:
+    explicit InboundBuffer(size_t initialCapacity = 16384);
+
+    // Free space for the next recv(), compacting or growing the buffer to fit at least minimum bytes
+    std::span<uint8_t> writableSpan(size_t minimum);
+    void commit(size_t count);
+
+    // Decrypts every byte committed since the last call, in place
+    bool decrypt(EVP_CIPHER_CTX* ctx);
+
+    // Extracts the next length-prefixed frame (without its length prefix).
+    // The view stays valid until the next call to writableSpan().
+    PacketReadResult nextFrame(std::span<const uint8_t>& frame);
+
+    size_t size() const { return writePos - readPos; }
+
+private:
+    std::vector<uint8_t> storage;
+    size_t readPos = 0;    // First unconsumed byte
+    size_t decryptPos = 0; // First byte that has not been decrypted yet
+    size_t writePos = 0;   // End of received data
+};
+
+#endif //INBOUND_BUFFER_H
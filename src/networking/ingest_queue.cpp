@@ -0,0 +1,57 @@
+#include "ingest_queue.h"
+
+// Intrusive MPSC queue after Dmitry Vyukov's design: producers swap themselves in as the head with a
+// single exchange, and the consumer follows the next pointers from the tail.
+
+IngestQueue::IngestQueue() : head(&stub), tail(&stub) {}
+
+IngestQueue::~IngestQueue() {
+    while (pop()) {
+    }
+}
+
+void IngestQueue::pushNode(IngestPacket* node) {
+    node->next.store(nullptr, std::memory_order_relaxed);
+    IngestPacket* previous = head.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+}
+
+void IngestQueue::push(const int32_t packetID, const std::span<const uint8_t> packet) {
+    auto node = new IngestPacket();
+    node->packetID = packetID;
+    node->data.assign(packet.begin(), packet.end());
+    count.fetch_add(1, std::memory_order_relaxed);
+    pushNode(node);
+}
+
+std::unique_ptr<IngestPacket> IngestQueue::pop() {
+    IngestPacket* first = tail;
+    IngestPacket* next = first->next.load(std::memory_order_acquire);
+    if (first == &stub) {
+        if (!next) {
+            return nullptr;
+        }
+        // Skip over the stub
+        tail = next;
+        first = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if (next) {
+        tail = next;
+        count.fetch_sub(1, std::memory_order_relaxed);
+        return std::unique_ptr<IngestPacket>(first);
+    }
+    if (first != head.load(std::memory_order_acquire)) {
+        // A producer has swapped in a new head but not linked it yet
+        return nullptr;
+    }
+    // first is the last packet: put the stub behind it so it can be unlinked
+    pushNode(&stub);
+    next = first->next.load(std::memory_order_acquire);
+    if (next) {
+        tail = next;
+        count.fetch_sub(1, std::memory_order_relaxed);
+        return std::unique_ptr<IngestPacket>(first);
+    }
+    return nullptr;
+}
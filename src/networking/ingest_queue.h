@@ -0,0 +1,44 @@
+#ifndef INGEST_QUEUE_H
+#define INGEST_QUEUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+// A serverbound Play packet waiting for the tick thread
+struct IngestPacket {
+    int32_t packetID = 0;
+    std::vector<uint8_t> data; // Packet ID + Data, as received
+    std::atomic<IngestPacket*> next{nullptr};
+};
+
+// Lock-free multi-producer, single-consumer queue of a connection's Play packets.
+// The network thread that reads the connection pushes decoded frames, the tick thread pops them at the
+// start of each tick, so game state only ever has the tick thread writing to it.
+class IngestQueue {
+public:
+    IngestQueue();
+    ~IngestQueue();
+
+    IngestQueue(const IngestQueue&) = delete;
+    IngestQueue& operator=(const IngestQueue&) = delete;
+
+    // Copies the packet in. Any thread.
+    void push(int32_t packetID, std::span<const uint8_t> packet);
+    // Next packet in arrival order, or null if there is none (yet). Consumer thread only.
+    std::unique_ptr<IngestPacket> pop();
+
+    size_t size() const { return count.load(std::memory_order_relaxed); }
+
+private:
+    void pushNode(IngestPacket* node);
+
+    std::atomic<IngestPacket*> head; // Most recently pushed
+    IngestPacket* tail;              // Next to pop, only touched by the consumer
+    IngestPacket stub;               // Keeps the list non-empty so producers never touch tail
+    std::atomic<size_t> count{0};
+};
+
+#endif //INGEST_QUEUE_H
@@ -3,52 +3,44 @@
 #include <random>
 #ifdef _WIN32
 #include <ws2tcpip.h>
+#else
+#include <poll.h>
+#include <unistd.h>
 #endif
 #include <openssl/err.h>
 #include <openssl/evp.h>
 
 #include "client.h"
+#include "compression_policy.h"
+#include "outbound_lanes.h"
+#include "packet_stats.h"
+#include "packet_writer.h"
+#include "shared_frame.h"
+#include "utils/thread_pool.h"
 #include "core/config.h"
 #include "core/server.h"
 
-int32_t readVarInt(SocketType sock) {
-    int32_t numRead = 0;
-    int32_t result = 0;
-    uint8_t readByte;
-    do {
-        int recvResult = recv(sock, reinterpret_cast<char*>(&readByte), 1, 0);
-        if (recvResult <= 0) {
-            return -1;
-        }
-        int32_t value = (readByte & 0b01111111);
-        result |= (value << (7 * numRead));
-
-        numRead++;
-        if (numRead > 5) {
-            return -1;
-        }
-    } while ((readByte & 0b10000000) != 0);
-
-    return result;
-}
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
 
-void logicalShiftRightAssign(int32_t& value, int shift) {
-    // Cast to unsigned to perform logical shift
-    uint32_t unsignedValue = static_cast<uint32_t>(value);
-    unsignedValue >>= shift; // Logical shift
-    value = static_cast<int32_t>(unsignedValue);
-}
+constexpr size_t RECEIVE_CHUNK_SIZE = 16384;
+constexpr size_t FLUSH_THRESHOLD = 65536;
+// How long a kicked client gets to read its Disconnect packet
+constexpr auto CLOSE_FLUSH_TIMEOUT = std::chrono::seconds(2);
 
 void writeVarInt(std::vector<uint8_t>& buffer, int32_t value) {
-    while (true) {
-        if ((value & ~0x7F) == 0) {
-            writeByte(buffer, static_cast<uint8_t>(value));
-            break;
-        }
-
-        writeByte(buffer, static_cast<uint8_t>((value & 0x7F) | 0x80));
-        logicalShiftRightAssign(value, 7);
+    // Size the buffer once, then fill in the 7-bit groups
+    size_t size = varIntSize(value);
+    size_t start = buffer.size();
+    buffer.resize(start + size);
+    uint8_t* out = buffer.data() + start;
+    auto unsignedValue = static_cast<uint32_t>(value);
+    for (size_t i = 0; i + 1 < size; i++) {
+        out[i] = static_cast<uint8_t>((unsignedValue & 0x7F) | 0x80);
+        unsignedValue >>= 7;
     }
+    out[size - 1] = static_cast<uint8_t>(unsignedValue);
 }
 
 void writeString(std::vector<uint8_t>& buffer, const std::string& str) {
@@ -137,473 +129,442 @@ void writeUUID(std::vector<uint8_t>& buffer, const std::array<uint8_t, 16>& uuid
     }
 }
 
-int32_t parseVarInt(const std::vector<uint8_t>& data, size_t& index) {
-    int32_t value = 0;
-    int32_t position = 0;
-
-    while (true) {
-        uint8_t currentByte = parseByte(data, index);
-        value |= (currentByte & 0x7F) << position;
+int receiveIntoBuffer(ClientConnection& client) {
+    // Read as much as the kernel has for us in a single call
+    std::span<uint8_t> space = client.inbound.writableSpan(RECEIVE_CHUNK_SIZE);
+    int bytesRead = recv(client.socket, reinterpret_cast<char*>(space.data()), static_cast<int>(space.size()), 0);
+    if (bytesRead > 0) {
+        client.inbound.commit(bytesRead);
+        client.lastReceived = std::chrono::steady_clock::now();
+    }
+    return bytesRead;
+}
 
-        if ((currentByte & 0x80) == 0) {
-            break;
+// Reads a VarInt from a frame, returns false if the frame ends first
+static bool readFrameVarInt(std::span<const uint8_t> frame, size_t& index, int32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (index >= frame.size()) {
+            return false;
         }
-
-        position += 7;
-
-        if (position >= 32) {
-            throw std::runtime_error("Error: VarLong is too big.");
+        uint8_t read = frame[index++];
+        value |= (read & 0x7F) << shift;
+        if ((read & 0x80) == 0) {
+            return true;
         }
     }
-
-    return value;
+    return false;
 }
 
-int64_t parseLong(const std::vector<uint8_t>& data, size_t& index) {
-    if (index + 8 > data.size()) {
-        // Error: Not enough data
-        return 0;
+PacketReadResult extractPacket(ClientConnection& client, std::vector<uint8_t>& scratch, std::span<const uint8_t>& packet) {
+    // Decrypt everything that arrived since the last call in one go
+    if (client.decryptCtx && !client.inbound.decrypt(client.decryptCtx)) {
+        return PacketReadResult::Error;
     }
 
-    uint64_t value = 0;
-    for (int i = 0; i < 8; ++i) {
-        value |= static_cast<uint64_t>(data[index + i]) << (8 * (7 - i));
+    std::span<const uint8_t> frame;
+    PacketReadResult result = client.inbound.nextFrame(frame);
+    if (result != PacketReadResult::Packet) {
+        return result;
     }
 
-    index += 8;
-    return value;
-}
+    bool compressed = false;
+    std::chrono::steady_clock::time_point started;
+    // Check for compression
+    if (client.compressionEnabled && serverConfig.enableCompression) {
+        size_t index = 0;
+        // Read the Data Length VarInt
+        int32_t dataLength = 0;
+        if (!readFrameVarInt(frame, index, dataLength) || dataLength < 0) {
+            logMessage("Invalid Data Length in compressed packet", LOG_ERROR);
+            return PacketReadResult::Error;
+        }
 
-short parseShort(const std::vector<uint8_t>& data, size_t& index) {
-    if (index + 2 > data.size()) {
-        // Error: Not enough data
-        return 0;
+        if (dataLength == 0) {
+            // Packet is not compressed
+            packet = frame.subspan(index);
+        } else {
+            // Packet is compressed
+            compressed = true;
+            started = std::chrono::steady_clock::now();
+            try {
+                decompressData(frame.subspan(index), dataLength, scratch);
+                packet = scratch;
+            } catch (const std::exception& e) {
+                logMessage("Decompression failed: " + std::string(e.what()), LOG_ERROR);
+                return PacketReadResult::Error;
+            }
+        }
+    } else {
+        packet = frame;
     }
 
-    short value = (data[index] << 8) | data[index + 1];
-    index += 2;
-    return value;
+    size_t index = 0;
+    int32_t packetID = -1;
+    readFrameVarInt(packet, index, packetID);
+    recordPacketReceived(packetID, packet.size(), frame.size(), compressed, client.decryptCtx != nullptr, compressed ? nanosSince(started) : 0);
+
+    return PacketReadResult::Packet;
 }
 
-float parseFloat(const std::vector<uint8_t>& data, size_t& index) {
-    if (index + 4 > data.size()) {
-        // Error: Not enough data
-        return 0.0f;
-    }
+void shutdownSocket(SocketType sock) {
+#ifdef _WIN32
+    shutdown(sock, SD_BOTH);
+#else
+    shutdown(sock, SHUT_RDWR);
+#endif
+}
 
-    uint32_t value = (data[index] << 24) | (data[index + 1] << 16) | (data[index + 2] << 8) | data[index + 3];
-    float result;
-    memcpy(&result, &value, sizeof(float));
-    index += 4;
-    return result;
+void closeSocket(SocketType sock) {
+#ifdef _WIN32
+    closesocket(sock);
+#else
+    close(sock);
+#endif
 }
 
-double parseDouble(const std::vector<uint8_t>& data, size_t& index) {
-    if (index + 8 > data.size()) {
-        // Error: Not enough data
-        return 0.0;
+SocketType openListenSocket(uint16_t port, bool reusePort) {
+    SocketType serverSock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (serverSock == INVALID_SOCKET) {
+        logMessage("Failed to create socket.", LOG_ERROR);
+        return INVALID_SOCKET;
     }
 
-    uint64_t value = 0;
-    for (int i = 0; i < 8; ++i) {
-        value |= static_cast<uint64_t>(data[index + i]) << (8 * (7 - i));
+    // Set socket options
+    int opt = 1;
+#ifdef _WIN32
+    setsockopt(serverSock, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&opt), sizeof(opt));
+#else
+    setsockopt(serverSock, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+#endif
+#ifdef SO_REUSEPORT
+    // Lets every network thread bind its own socket to the port, the kernel spreads new connections over them
+    if (reusePort && setsockopt(serverSock, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) == SOCKET_ERROR) {
+        logMessage("Failed to enable SO_REUSEPORT.", LOG_ERROR);
+        closeSocket(serverSock);
+        return INVALID_SOCKET;
     }
+#endif
 
-    double result;
-    memcpy(&result, &value, sizeof(double));
-    index += 8;
-    return result;
-}
-
-std::string parseString(const std::vector<uint8_t>& data, size_t& index) {
-    int32_t length = parseVarInt(data, index);
-    std::string result(data.begin() + index, data.begin() + index + length);
-    index += length;
-    return result;
-}
+    sockaddr_in serverAddr{};
+    serverAddr.sin_family = AF_INET;
+#ifdef _WIN32
+    serverAddr.sin_addr.s_addr = INADDR_ANY;
+#else
+    serverAddr.sin_addr.s_addr = htonl(INADDR_ANY);
+#endif
+    serverAddr.sin_port = htons(port);
 
-std::vector<uint8_t> parseBytes(const std::vector<uint8_t>& data, size_t& index, size_t length) {
-    if (index + length > data.size()) {
-        // Error: Not enough data
-        return {};
+    if (bind(serverSock, reinterpret_cast<sockaddr*>(&serverAddr), sizeof(serverAddr)) == SOCKET_ERROR) {
+        logMessage("Failed to bind socket.", LOG_ERROR);
+        closeSocket(serverSock);
+        return INVALID_SOCKET;
     }
 
-    std::vector<uint8_t> result(data.begin() + index, data.begin() + index + length);
-    index += length;
-    return result;
+    if (listen(serverSock, SOMAXCONN) == SOCKET_ERROR) {
+        logMessage("Failed to listen on socket.", LOG_ERROR);
+        closeSocket(serverSock);
+        return INVALID_SOCKET;
+    }
+    return serverSock;
 }
 
-uint64_t parseVarLong(const std::vector<uint8_t>& data, size_t& index) {
-    int64_t value = 0;
-    int32_t position = 0;
+static EVP_CIPHER_CTX* outboundCipher(const ClientConnection& client) {
+    return serverConfig.enableEncryption ? client.encryptCtx : nullptr;
+}
 
+// Flushes the outbound queue, optionally waiting for a non-blocking socket to drain. Frames held
+// back by backpressure are moved onto the wire whenever the socket falls below the low watermark,
+// up to the high watermark (or all of them when waiting). Called with sendMutex held.
+static bool flushLocked(ClientConnection& client, bool wait) {
+    OutboundLanes& lanes = client.lanes;
     while (true) {
-        uint8_t currentByte = parseByte(data, index);
-        value |= static_cast<int64_t>(currentByte & 0x7F) << position;
-
-        if ((currentByte & 0x80) == 0) {
-            break;
+        if (!client.outbound.flush(client.socket)) {
+            logMessage("Failed to send packet: " + std::string(strerror(errno)), LOG_DEBUG);
+            return false;
         }
-
-        position += 7;
-
-        if (position >= 64) {
-            throw std::runtime_error("Error: VarLong is too big.");
+        if (client.outbound.size() <= static_cast<size_t>(serverConfig.outboundLowWatermark)) {
+            if (!lanes.empty()) {
+                size_t limit = wait ? SIZE_MAX : static_cast<size_t>(serverConfig.outboundHighWatermark);
+                try {
+                    lanes.drainInto(client.outbound, outboundCipher(client), limit, client.compressionEnabled);
+                } catch (const std::exception& e) {
+                    logMessage(e.what(), LOG_ERROR);
+                    ERR_print_errors_fp(stderr);
+                    return false;
+                }
+                lanes.congested = client.outbound.size() >= static_cast<size_t>(serverConfig.outboundHighWatermark);
+                continue;
+            }
+            lanes.congested = false;
+        }
+        if (!wait || client.outbound.empty()) {
+            return true;
+        }
+#ifndef _WIN32
+        pollfd pfd{client.socket, POLLOUT, 0};
+        if (poll(&pfd, 1, 5000) <= 0) {
+            logMessage("Timed out waiting for a client to accept data", LOG_DEBUG);
+            return false;
         }
+#endif
     }
-
-    return value;
 }
 
-SlotData parseSlotData(const std::vector<uint8_t>& data, size_t& index) {
-    SlotData slot;
-    slot.itemCount = parseVarInt(data, index);
-    if (slot.itemCount == 0) {
-        return slot;
-    }
-
-    int32_t itemID = parseVarInt(data, index);
-    if (itemID != -1) {
-        slot.itemId = itemID;
-    }
-
-    int32_t numComponentsToAdd = parseVarInt(data, index);
-    if (numComponentsToAdd > 0) {
-        logMessage("Num components to add: " + std::to_string(numComponentsToAdd), LOG_DEBUG);
+bool flushPackets(ClientConnection& client, bool wait) {
+    // A kicked connection still gets what was queued before the kick
+    if (client.connectionClosed && !client.closing) {
+        return false;
     }
-    int32_t numComponentsToRemove = parseVarInt(data, index);
-    if (numComponentsToRemove > 0) {
-        logMessage("Num components to remove: " + std::to_string(numComponentsToRemove), LOG_DEBUG);
+    std::lock_guard lock(client.sendMutex);
+    bool flushed = client.outbound.empty() && client.lanes.empty() ? true : flushLocked(client, wait);
+    if (client.closing && (!flushed || (client.outbound.empty() && client.lanes.empty() && client.pendingFrames.empty()))) {
+        // The network thread releases the connection once it sees the socket shut down
+        shutdownSocket(client.socket);
     }
-
-    return slot;
+    return flushed;
 }
 
-uint8_t parseByte(const std::vector<uint8_t>& data, size_t& index) {
-    if (index >= data.size()) {
-        // Error: Not enough data
-        return 0;
+// Asks for the outbound queue to be written out. Connections owned by the reactor are flushed
+// by their I/O thread so the caller never waits on the socket. Called with sendMutex held.
+static bool requestFlushLocked(ClientConnection& client) {
+    if (client.flushHandler) {
+        client.flushHandler();
+        return true;
     }
-
-    return data[index++];
+    return flushLocked(client, true);
 }
 
-bool readUnencryptedPacket(const ClientConnection& client, std::vector<uint8_t>& packetData) {
-    // Read the length prefix (VarInt)
-    int32_t length = readVarInt(client.socket);
-    if (length == -1) {
-        // Connection closed or error
-        return false;
+void scheduleFlush(ClientConnection& client) {
+    if (client.connectionClosed) {
+        return;
     }
-
-    // Read the packet payload based on the length
-    packetData.resize(length);
-    size_t totalRead = 0;
-    while (totalRead < static_cast<size_t>(length)) {
-        ssize_t bytesRead = recv(client.socket, reinterpret_cast<char*>(packetData.data()) + totalRead, length - totalRead, 0);
-        if (bytesRead <= 0) {
-            // Connection closed or error
-            return false;
-        }
-        totalRead += bytesRead;
+    if (client.flushHandler) {
+        client.flushHandler();
+        return;
     }
-
-    return true;
+    flushPackets(client);
 }
 
-bool readPacketTimeout(const ClientConnection& client, std::vector<uint8_t>& packetData, int timeout, bool unencrypted) {
-    fd_set readSet;
-    FD_ZERO(&readSet);
-    FD_SET(client.socket, &readSet);
-
-    timeval tv;
-    tv.tv_sec = timeout;
-    tv.tv_usec = 0;
-
-    int selectResult = select(client.socket + 1, &readSet, nullptr, nullptr, &tv);
-    if (selectResult == -1) {
-        // Error occurred
-        return false;
-    }
-    if (selectResult == 0) {
-        // Timeout
-        return false;
-    }
-    if (unencrypted) {
-        return readUnencryptedPacket(client, packetData);
+void shutdownAfterFlush(ClientConnection& client) {
+    client.closeDeadline = std::chrono::steady_clock::now() + CLOSE_FLUSH_TIMEOUT;
+    client.closing = true;
+    if (client.flushHandler) {
+        client.flushHandler();
+        return;
     }
-    return readPacket(client, packetData);
-}
-
-bool readPacket(const ClientConnection& client, std::vector<uint8_t>& packetData) {
-    if (serverConfig.enableEncryption && client.decryptCtx) {
-        // Step 1: Read encrypted length prefix (VarInt up to 5 bytes)
-        int32_t length = 0;
-        int32_t numRead = 0;
-        uint8_t decryptedByte;
-        bool lengthRead = false;
-
-        while (numRead < 5 && !lengthRead) {
-            uint8_t encryptedByte;
-            ssize_t bytesRead = recv(client.socket, reinterpret_cast<char*>(&encryptedByte), 1, 0);
-            if (bytesRead <= 0) {
-                // Connection closed or error
-                return false;
-            }
-
-            // Decrypt the byte
-            int outLen = 0;
-            if (EVP_DecryptUpdate(client.decryptCtx, &decryptedByte, &outLen, &encryptedByte, 1) != 1) {
-                logMessage("Failed to decrypt length byte", LOG_ERROR);
-                ERR_print_errors_fp(stderr);
-                return false;
-            }
-
-            if (outLen != 1) {
-                logMessage("Unexpected decrypted length for length byte", LOG_ERROR);
-                return false;
-            }
-
-            // Accumulate the length
-            length |= (decryptedByte & 0x7F) << (7 * numRead);
-            if ((decryptedByte & 0x80) == 0) {
-                lengthRead = true;
-            }
-            numRead++;
-        }
-
-        if (!lengthRead) {
-            logMessage("VarInt length prefix is too big", LOG_ERROR);
-            return false;
-        }
-
-        // Step 2: Read encrypted payload based on the decrypted length
-        std::vector<uint8_t> encryptedPayload(length);
-        size_t totalRead = 0;
-        while (totalRead < static_cast<size_t>(length)) {
-            ssize_t bytesRead = recv(client.socket, reinterpret_cast<char*>(encryptedPayload.data()) + totalRead, length - totalRead, 0);
-            if (bytesRead <= 0) {
-                // Connection closed or error
-                return false;
-            }
-            totalRead += bytesRead;
-        }
-
-        // Step 3: Decrypt the payload
-        std::vector<uint8_t> decryptedPayload(length);
-        int decryptedLen = 0;
-        if (EVP_DecryptUpdate(client.decryptCtx, decryptedPayload.data(), &decryptedLen, encryptedPayload.data(), length) != 1) {
-            logMessage("Failed to decrypt payload", LOG_ERROR);
-            ERR_print_errors_fp(stderr);
-            return false;
-        }
-        decryptedPayload.resize(decryptedLen);
-
-        // Assign the decrypted payload to packetData
-        packetData = decryptedPayload;
-
-        // Check for compression
-        if (client.compressionEnabled && serverConfig.enableCompression) {
-            size_t index = 0;
-            // Read the Data Length VarInt
-            int32_t dataLength = parseVarInt(decryptedPayload, index);
-
-            if (dataLength == 0) {
-                // Packet is not compressed
-                packetData = std::vector<uint8_t>(decryptedPayload.begin() + index, decryptedPayload.end());
+    // Blocking fallback, the connection's own thread is waiting in recv
+    flushPackets(client);
+    shutdownSocket(client.socket);
+}
+
+// Queues a finished frame. Outside of Play packets go out immediately, in Play they are
+// batched until the end of the tick unless enough has piled up. Once a client stops keeping up,
+// everything but keep alives and teleports waits in its lanes. Called with sendMutex held.
+static bool queueFrame(ClientConnection& client, const FrameInfo& info, std::span<const uint8_t> frame, const std::shared_ptr<const SharedFrame>& shared = nullptr) {
+    bool inPlay = client.state == ClientState::Play || client.state == ClientState::AwaitingTeleportConfirm;
+    if (inPlay) {
+        OutboundLane lane = laneFor(info.packetID);
+        if (lane != OutboundLane::Urgent && (client.lanes.congested || !client.lanes.empty(lane))) {
+            if (shared) {
+                client.lanes.push(lane, info, shared, client.compressionEnabled);
             } else {
-                // Packet is compressed
-                // Extract compressed data
-                std::vector<uint8_t> compressedData(decryptedPayload.begin() + index, decryptedPayload.end());
-
-                try {
-                    // Decompress data
-                    std::vector<uint8_t> decompressedData = decompressData(compressedData);
-
-                    // Replace packetData with decompressed data
-                    packetData = decompressedData;
-                } catch (const std::exception& e) {
-                    logMessage("Decompression failed: " + std::string(e.what()), LOG_ERROR);
-                    return false;
-                }
+                client.lanes.push(lane, info, frame, client.compressionEnabled);
             }
+            return true;
         }
-
-        return true;
     }
-    // Existing unencrypted readPacket logic
-    // Read the length prefix (VarInt)
-    int32_t length = 0;
-    int32_t numRead = 0;
-    uint8_t read;
-    do {
-        ssize_t bytesRead = recv(client.socket, reinterpret_cast<char*>(&read), 1, 0);
-        if (bytesRead <= 0) {
-            // Connection closed or error
-            return false;
-        }
-        length |= (read & 0x7F) << (7 * numRead);
-        numRead++;
-        if (numRead > 5) {
-            // VarInt is too big
-            logMessage("VarInt is too big", LOG_ERROR);
-            return false;
-        }
-    } while ((read & 0x80) != 0);
-
-    // Read the packet payload based on the length
-    std::vector<uint8_t> receivedData(length);
-    size_t totalRead = 0;
-    while (totalRead < static_cast<size_t>(length)) {
-        ssize_t bytesRead = recv(client.socket, reinterpret_cast<char*>(receivedData.data()) + totalRead, length - totalRead, 0);
-        if (bytesRead <= 0) {
-            // Connection closed or error
-            return false;
-        }
-        totalRead += bytesRead;
-    }
-
-    // Check for compression
-    if (client.compressionEnabled && serverConfig.enableCompression) {
-        size_t index = 0;
-        // Read the Data Length VarInt
-        int32_t dataLength = parseVarInt(receivedData, index);
 
-        if (dataLength == 0) {
-            // Packet is not compressed
-            packetData = std::vector<uint8_t>(receivedData.begin() + index, receivedData.end());
-        } else {
-            // Packet is compressed
-            // Extract compressed data
-            std::vector<uint8_t> compressedData(receivedData.begin() + index, receivedData.end());
+    // Encryption happens as the frame is copied into the outbound queue
+    EVP_CIPHER_CTX* cipher = outboundCipher(client);
+    auto started = cipher ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+    try {
+        client.outbound.write(frame, cipher);
+        recordFrameWritten(info.packetID, frame.size(), cipher != nullptr, cipher ? nanosSince(started) : 0);
+    } catch (const std::exception& e) {
+        logMessage(e.what(), LOG_ERROR);
+        ERR_print_errors_fp(stderr);
+        return false;
+    }
 
-            try {
-                // Decompress data
-                std::vector<uint8_t> decompressedData = decompressData(compressedData);
+    if (!inPlay) {
+        return requestFlushLocked(client);
+    }
+    if (client.outbound.size() >= static_cast<size_t>(serverConfig.outboundHighWatermark)) {
+        client.lanes.congested = true;
+    }
+    if (client.outbound.size() >= FLUSH_THRESHOLD) {
+        return requestFlushLocked(client);
+    }
+    return true;
+}
 
-                // Replace packetData with decompressed data
-                packetData = decompressedData;
-            } catch (const std::exception& e) {
-                logMessage("Decompression failed: " + std::string(e.what()), LOG_ERROR);
-                return false;
-            }
-        }
+// A frame that has to wait for an earlier packet of the same connection to finish compressing
+struct PendingFrame {
+    std::vector<uint8_t> data; // Payload until compressed, then the frame starting at start
+    size_t start = 0;
+    std::shared_ptr<const SharedFrame> shared; // Set instead of data for broadcast frames
+    FrameInfo info;
+    bool ready = false;
+};
+
+// Encrypts every finished frame at the head of the pending list, in order. Called with sendMutex held.
+static bool drainPendingFrames(ClientConnection& client) {
+    bool success = true;
+    while (!client.pendingFrames.empty() && client.pendingFrames.front()->ready) {
+        const PendingFrame& pending = *client.pendingFrames.front();
+        std::span<const uint8_t> frame = pending.shared ? pending.shared->get(client.compressionEnabled)
+                                                        : std::span<const uint8_t>(pending.data).subspan(pending.start);
+        success = queueFrame(client, pending.info, frame, pending.shared) && success;
+        client.pendingFrames.pop_front();
+    }
+    return success;
+}
+
+// Queues a frame behind any packets that are still being compressed. Called with sendMutex held.
+static bool queueInOrder(ClientConnection& client, const FrameInfo& info, std::span<const uint8_t> frame, const std::shared_ptr<const SharedFrame>& shared = nullptr) {
+    if (client.pendingFrames.empty()) {
+        return queueFrame(client, info, frame, shared);
+    }
+    auto pending = std::make_shared<PendingFrame>();
+    pending->info = info;
+    if (shared) {
+        pending->shared = shared;
     } else {
-        // No compression; assign received data directly
-        packetData = receivedData;
+        pending->data.assign(frame.begin(), frame.end());
     }
-
+    pending->ready = true;
+    client.pendingFrames.push_back(std::move(pending));
     return true;
 }
 
-std::vector<uint8_t> buildPacket(const std::vector<uint8_t>& payload) {
-    std::vector<uint8_t> packet;
-    writeVarInt(packet, static_cast<int32_t>(payload.size()));
-    packet.insert(packet.end(), payload.begin(), payload.end());
-    return packet;
+static thread_pool& compressionPool() {
+    static thread_pool pool(serverConfig.compressionThreads);
+    return pool;
 }
 
-std::vector<uint8_t> writeLength(const std::vector<uint8_t>& payload) {
-    std::vector<uint8_t> packet;
-    writeVarInt(packet, static_cast<int32_t>(payload.size()));
-    return packet;
+static void compressPendingFrame(const std::shared_ptr<ClientConnection>& client, const std::shared_ptr<PendingFrame>& pending) {
+    std::vector<uint8_t> frame;
+    int32_t dataLength = static_cast<int32_t>(pending->data.size());
+    if (!compressPacket(pending->data, frame, PacketWriter::HEADROOM)) {
+        frame.resize(PacketWriter::HEADROOM);
+        frame.insert(frame.end(), pending->data.begin(), pending->data.end());
+        dataLength = 0;
+    }
+    size_t start = finishFrame(frame, dataLength).data() - frame.data();
+
+    std::lock_guard lock(client->sendMutex);
+    pending->data = std::move(frame);
+    pending->start = start;
+    pending->ready = true;
+    if (!client->connectionClosed || client->closing) {
+        drainPendingFrames(*client);
+        requestFlushLocked(*client);
+    }
+}
+
+// Hands a payload to the compression workers. Its frame keeps its place in the connection's
+// send order and is encrypted once every frame before it is queued. Called with sendMutex held.
+static void compressOffThread(const std::shared_ptr<ClientConnection>& client, const FrameInfo& info, std::span<const uint8_t> payload) {
+    auto pending = std::make_shared<PendingFrame>();
+    pending->data.assign(payload.begin(), payload.end());
+    pending->info = info;
+    client->pendingFrames.push_back(pending);
+    try {
+        compressionPool().enqueue(compressPendingFrame, client, pending);
+    } catch (const std::exception&) {
+        // Shutting down, drop the packet
+        client->pendingFrames.pop_back();
+    }
 }
 
 bool sendUnencryptedPacket(ClientConnection& client, const std::vector<uint8_t>& packetData) {
     if (client.connectionClosed) {
         return false;
     }
+    PacketWriter writer;
+    writer.buffer().insert(writer.buffer().end(), packetData.begin(), packetData.end());
+
+    FrameInfo info = describePayload(writer.payload());
+    recordPacketSent(info.packetID, writer.payload().size());
+
     std::lock_guard lock(client.sendMutex);
-    std::vector<uint8_t> dataToSend = buildPacket(packetData);
-    size_t totalSent = 0;
-    size_t packetSize = dataToSend.size();
-    const char* dataPtr = reinterpret_cast<const char*>(dataToSend.data());
-
-    while (totalSent < packetSize) {
-        ssize_t sent = send(client.socket, dataPtr + totalSent, packetSize - totalSent, 0);
-        if (sent == -1) {
-            logMessage("Failed to send packet: " + std::string(strerror(errno)), LOG_DEBUG);
-            return false;
-        }
-        totalSent += sent;
+    try {
+        std::span<const uint8_t> frame = writer.frame(false);
+        client.outbound.write(frame);
+        recordFrameWritten(info.packetID, frame.size(), false, 0);
+    } catch (const std::exception& e) {
+        logMessage(e.what(), LOG_ERROR);
+        return false;
     }
-    return true;
+    return requestFlushLocked(client);
 }
 
-bool sendPacket(ClientConnection& client, const std::vector<uint8_t>& packetData) {
+bool sendPacket(ClientConnection& client, PacketWriter& writer) {
     if (client.connectionClosed) {
         return false;
     }
+    std::span<const uint8_t> payload = writer.payload();
+    FrameInfo info = describePayload(payload);
+    recordSerializeTime(info.packetID, nanosSince(writer.startedAt()));
+    recordPacketSent(info.packetID, payload.size());
+    bool inPlay = client.state == ClientState::Play || client.state == ClientState::AwaitingTeleportConfirm;
     std::lock_guard<std::mutex> lock(client.sendMutex);
-    std::vector<uint8_t> dataToSend;
-
-    // Determine if compression should be applied
-    bool shouldCompress = serverConfig.enableCompression &&
-                          packetData.size() >= serverConfig.compressionThreshold;
 
-    if (shouldCompress && client.compressionEnabled) {
-        try {
-            // Compress the (Packet ID + Data)
-            std::vector<uint8_t> compressedData = compressData(packetData);
-
-            // Create a new packet with Data Length (uncompressed size) + Compressed Data
-            std::vector<uint8_t> compressedPacket;
-            writeVarInt(compressedPacket, packetData.size()); // Data Length
-            compressedPacket.insert(compressedPacket.end(), compressedData.begin(), compressedData.end());
-
-            dataToSend = buildPacket(compressedPacket);
-        } catch (const std::exception& e) {
-            logMessage("Compression failed: " + std::string(e.what()), LOG_ERROR);
-            return false;
+    // In Play, compression runs on the worker threads instead of the caller's
+    if (inPlay && client.compressionEnabled && payload.size() >= static_cast<size_t>(serverConfig.compressionThreshold)) {
+        if (auto self = client.weak_from_this().lock()) {
+            compressOffThread(self, info, payload);
+            return true;
         }
-    } else if (client.compressionEnabled) {
-        // No compression: Data Length is 0
-        std::vector<uint8_t> uncompressedPacket;
-        writeVarInt(uncompressedPacket, 0); // Data Length = 0
-        uncompressedPacket.insert(uncompressedPacket.end(), packetData.begin(), packetData.end());
-
-        // Build the final packet with length prefix
-        dataToSend = buildPacket(uncompressedPacket);
-    } else {
-        // No compression and compression not enabled
-        dataToSend = buildPacket(packetData);
-    }
-
-    // Handle encryption if enabled
-    if (serverConfig.enableEncryption && client.encryptCtx) {
-        // Encrypt dataToSend
-        std::vector<uint8_t> encryptedData(dataToSend.size() + EVP_CIPHER_block_size(EVP_aes_128_cfb8()));
-        int outLen = 0;
-        if (EVP_EncryptUpdate(client.encryptCtx, encryptedData.data(), &outLen, dataToSend.data(), dataToSend.size()) != 1) {
-            logMessage("Failed to encrypt packet data", LOG_ERROR);
-            ERR_print_errors_fp(stderr);
-            return false;
-        }
-        encryptedData.resize(outLen);
-        dataToSend = encryptedData;
     }
 
-    // Send the packet
-    size_t totalSent = 0;
-    size_t packetSize = dataToSend.size();
-    const char* dataPtr = reinterpret_cast<const char*>(dataToSend.data());
-
-    while (totalSent < packetSize) {
-        ssize_t sent = send(client.socket, dataPtr + totalSent, packetSize - totalSent, 0);
-        if (sent == -1) {
-            logMessage("Failed to send packet: " + std::string(strerror(errno)), LOG_ERROR);
-            return false;
+    if (client.compressionEnabled) {
+        // Compress the (Packet ID + Data) behind room for the Packet Length and Data Length
+        PooledBuffer compressed;
+        if (compressPacket(payload, *compressed, PacketWriter::HEADROOM)) {
+            return queueInOrder(client, info, finishFrame(*compressed, static_cast<int32_t>(payload.size())));
         }
-        totalSent += sent;
     }
-    return true;
+
+    // Uncompressed, with a Data Length of 0 once compression is enabled
+    return queueInOrder(client, info, writer.frame(client.compressionEnabled));
+}
+
+bool sendPacket(ClientConnection& client, const std::vector<uint8_t>& packetData) {
+    PacketWriter writer;
+    writer.buffer().insert(writer.buffer().end(), packetData.begin(), packetData.end());
+    return sendPacket(client, writer);
 }
 
-void broadcastToOthers(const std::vector<uint8_t>& packetData, const std::string& excludeUUID) {
-    std::lock_guard lock(connectedClientsMutex);
-    for (const auto& [uuid, client] : connectedClients) {
-        if (uuid != excludeUUID) {
-            sendPacket(*client, packetData);
+bool sendPacket(ClientConnection& client, const std::shared_ptr<const SharedFrame>& frame) {
+    if (client.connectionClosed) {
+        return false;
+    }
+    recordPacketSent(frame->info().packetID, frame->payloadSize());
+    std::lock_guard<std::mutex> lock(client.sendMutex);
+    return queueInOrder(client, frame->info(), frame->get(client.compressionEnabled), frame);
+}
+
+void broadcastToOthers(PacketWriter& writer, const std::string& excludeUUID) {
+    // Compress and frame once, only the encryption is done per client
+    auto frame = std::make_shared<const SharedFrame>(writer.payload());
+    recordSerializeTime(frame->info().packetID, nanosSince(writer.startedAt()));
+
+    // Queue outside the lock so joins and leaves on other threads don't wait for the fan-out
+    std::vector<std::shared_ptr<ClientConnection>> clients;
+    {
+        std::lock_guard lock(connectedClientsMutex);
+        clients.reserve(connectedClients.size());
+        for (const auto& [uuid, client] : connectedClients) {
+            if (uuid != excludeUUID) {
+                if (std::shared_ptr<ClientConnection> connection = client->weak_from_this().lock()) {
+                    clients.push_back(std::move(connection));
+                }
+            }
         }
     }
+    for (const std::shared_ptr<ClientConnection>& client : clients) {
+        sendPacket(*client, frame);
+    }
 }
\ No newline at end of file
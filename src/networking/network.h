@@ -1,8 +1,11 @@
 #ifndef NETWORK_H
 #define NETWORK_H
+#include <bit>
 #include <vector>
 #include <cstdint>
+#include <memory>
 #include <mutex>
+#include <span>
 #include <string>
 
 #ifdef _WIN32
@@ -19,8 +22,20 @@ typedef int SocketType;
 
 struct SlotData;
 struct ClientConnection;
+class PacketWriter;
+class SharedFrame;
+
+enum class PacketReadResult {
+    Packet,     // A complete packet was extracted
+    Incomplete, // More bytes are needed
+    Error       // Malformed stream, the connection should be closed
+};
+
+// Number of bytes writeVarInt needs for a value: 7 bits per byte, negative values always take 5
+constexpr size_t varIntSize(int32_t value) {
+    return (std::bit_width(static_cast<uint32_t>(value) | 1) + 6) / 7;
+}
 
-int32_t readVarInt(SocketType sock);
 void writeVarInt(std::vector<uint8_t>& buffer, int32_t value);
 void writeString(std::vector<uint8_t>& buffer, const std::string& str);
 void writeInt(std::vector<uint8_t>& buffer, int32_t value);
@@ -34,22 +49,24 @@ void writeShort(std::vector<uint8_t>& buffer, int16_t value);
 void writeVarLong(std::vector<uint8_t>& buffer, uint64_t value);
 void writeSlotSimple(std::vector<uint8_t>& buffer, const SlotData& slot);
 void writeUUID(std::vector<uint8_t>& buffer, const std::array<uint8_t, 16>& uuid);
-int32_t parseVarInt(const std::vector<uint8_t>& data, size_t& index);
-int64_t parseLong(const std::vector<uint8_t>& data, size_t& index);
-short parseShort(const std::vector<uint8_t>& data, size_t& index);
-float parseFloat(const std::vector<uint8_t>& data, size_t& index);
-double parseDouble(const std::vector<uint8_t>& data, size_t& index);
-std::string parseString(const std::vector<uint8_t>& data, size_t& index);
-std::vector<uint8_t> parseBytes(const std::vector<uint8_t>& data, size_t& index, size_t length);
-uint8_t parseByte(const std::vector<uint8_t>& data, size_t& index);
-uint64_t parseVarLong(const std::vector<uint8_t>& data, size_t& index);
-SlotData parseSlotData(const std::vector<uint8_t>& data, size_t& index);
-bool readUnencryptedPacket(const ClientConnection& client, std::vector<uint8_t>& packetData);
-bool readPacketTimeout(const ClientConnection& client, std::vector<uint8_t>& packetData, int timeout, bool unencrypted);
-bool readPacket(const ClientConnection& client, std::vector<uint8_t>& packetData);
+int receiveIntoBuffer(ClientConnection& client);
+// Extracts the next packet (Packet ID + Data). Uncompressed packets are returned as a view into the
+// receive buffer, compressed ones are inflated into scratch.
+PacketReadResult extractPacket(ClientConnection& client, std::vector<uint8_t>& scratch, std::span<const uint8_t>& packet);
+void shutdownSocket(SocketType sock);
+void closeSocket(SocketType sock);
+// Binds and listens on every interface. With reusePort, several sockets can share the port (Linux only).
+SocketType openListenSocket(uint16_t port, bool reusePort);
 bool sendUnencryptedPacket(ClientConnection& client, const std::vector<uint8_t>& packetData);
+bool sendPacket(ClientConnection& client, PacketWriter& writer);
 bool sendPacket(ClientConnection& client, const std::vector<uint8_t>& packetData);
-void broadcastToOthers(const std::vector<uint8_t>& packetData, const std::string& excludeUUID = "");
+bool sendPacket(ClientConnection& client, const std::shared_ptr<const SharedFrame>& frame);
+bool flushPackets(ClientConnection& client, bool wait = false);
+void scheduleFlush(ClientConnection& client);
+// Shuts the socket down once everything queued so far is written, or closes it after a short
+// deadline if the client stops reading. Never waits on the socket.
+void shutdownAfterFlush(ClientConnection& client);
+void broadcastToOthers(PacketWriter& writer, const std::string& excludeUUID = "");
 
 #endif // NETWORK_H
 
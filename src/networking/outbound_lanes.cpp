@@ -0,0 +1,270 @@
+#include "outbound_lanes.h"
+
+#include "outbound_queue.h"
+#include "packet_ids.h"
+#include "packet_stats.h"
+#include "packet_writer.h"
+#include "shared_frame.h"
+
+// Reads a VarInt from a frame, returns false if the frame ends first
+static bool readVarInt(std::span<const uint8_t> data, size_t& index, int32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (index >= data.size()) {
+            return false;
+        }
+        uint8_t read = data[index++];
+        value |= (read & 0x7F) << shift;
+        if ((read & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool isEntityPacket(int32_t packetID) {
+    switch (packetID) {
+        case SPAWN_ENTITY:
+        case UPDATE_ENTITY_POSITION:
+        case UPDATE_ENTITY_POSITION_AND_ROTATION:
+        case UPDATE_ENTITY_ROTATION:
+        case SET_HEAD_ROTATION:
+        case SET_ENTITY_VELOCITY:
+        case TELEPORT_ENTITY:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool isPositionPacket(int32_t packetID) {
+    return packetID == UPDATE_ENTITY_POSITION || packetID == UPDATE_ENTITY_POSITION_AND_ROTATION || packetID == TELEPORT_ENTITY;
+}
+
+// Packets after which older updates for an entity must not be merged into newer ones, since the
+// entity ID may belong to a different entity. Bundle delimiters are no barrier: dropping a packet
+// leaves its bundle intact, and merged moves are appended inside the newest bundle.
+static bool isBarrier(int32_t packetID) {
+    return packetID == SPAWN_ENTITY || packetID == REMOVE_ENTITIES;
+}
+
+FrameInfo describePayload(std::span<const uint8_t> payload) {
+    FrameInfo info;
+    size_t index = 0;
+    int32_t value = 0;
+    if (!readVarInt(payload, index, value)) {
+        return info;
+    }
+    info.packetID = value;
+    if (isEntityPacket(value) && readVarInt(payload, index, value)) {
+        info.entityID = value;
+    }
+    return info;
+}
+
+OutboundLane laneFor(int32_t packetID) {
+    switch (packetID) {
+        case KEEP_ALIVE_PLAY:
+        case SYNCHRONIZE_PLAYER_POSITION:
+            return OutboundLane::Urgent;
+        case CHUNK_BATCH_START:
+        case CHUNK_DATA:
+        case CHUNK_BATCH_FINISHED:
+        case BLOCK_UPDATE:
+        case UPDATE_SECTION_BLOCKS:
+        case ACKNOWLEDGE_BLOCK_CHANGE: // Has to reach the client after the block updates it follows
+        case SET_CENTER_CHUNK:
+            return OutboundLane::Bulk;
+        default:
+            return OutboundLane::Normal;
+    }
+}
+
+// The Packet ID + Data of an uncompressed frame, or an empty span if it is compressed
+static std::span<const uint8_t> uncompressedPayload(std::span<const uint8_t> frame, bool compressionEnabled) {
+    size_t index = 0;
+    int32_t value = 0;
+    if (!readVarInt(frame, index, value)) {
+        return {};
+    }
+    if (compressionEnabled && (!readVarInt(frame, index, value) || value != 0)) {
+        return {};
+    }
+    return frame.subspan(index);
+}
+
+// Adds two big-endian 16-bit position deltas, returns false if the sum does not fit
+static bool addDelta(const uint8_t* older, const uint8_t* newer, uint8_t* out) {
+    int32_t sum = static_cast<int16_t>((older[0] << 8) | older[1]) + static_cast<int16_t>((newer[0] << 8) | newer[1]);
+    if (sum < INT16_MIN || sum > INT16_MAX) {
+        return false;
+    }
+    out[0] = static_cast<uint8_t>((sum >> 8) & 0xFF);
+    out[1] = static_cast<uint8_t>(sum & 0xFF);
+    return true;
+}
+
+// Merges two relative moves of the same type into one, taking everything but the deltas from the newer one
+static bool mergeMoves(std::span<const uint8_t> older, std::span<const uint8_t> newer, std::vector<uint8_t>& merged) {
+    size_t olderIndex = 0, newerIndex = 0;
+    int32_t value = 0;
+    // Packet ID and Entity ID
+    if (!readVarInt(older, olderIndex, value) || !readVarInt(older, olderIndex, value) ||
+        !readVarInt(newer, newerIndex, value) || !readVarInt(newer, newerIndex, value)) {
+        return false;
+    }
+    if (older.size() - olderIndex < 6 || older.size() - olderIndex != newer.size() - newerIndex) {
+        return false;
+    }
+
+    merged.insert(merged.end(), newer.begin(), newer.end());
+    uint8_t* out = merged.data() + merged.size() - (newer.size() - newerIndex);
+    for (int axis = 0; axis < 3; axis++) {
+        if (!addDelta(older.data() + olderIndex + axis * 2, newer.data() + newerIndex + axis * 2, out + axis * 2)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::span<const uint8_t> OutboundLanes::Entry::bytes(const bool compressionEnabled) const {
+    if (shared) {
+        return shared->get(compressionEnabled);
+    }
+    return std::span<const uint8_t>(data).subspan(start);
+}
+
+bool OutboundLanes::empty(const OutboundLane lane) const {
+    switch (lane) {
+        case OutboundLane::Normal:
+            return normalFrames == 0;
+        case OutboundLane::Bulk:
+            return bulkFrames == 0;
+        default:
+            return true;
+    }
+}
+
+void OutboundLanes::push(const OutboundLane lane, const FrameInfo& info, std::span<const uint8_t> frame, const bool compressionEnabled) {
+    Entry entry;
+    entry.info = info;
+    entry.data.assign(frame.begin(), frame.end());
+    push(lane, std::move(entry), compressionEnabled);
+}
+
+void OutboundLanes::push(const OutboundLane lane, const FrameInfo& info, const std::shared_ptr<const SharedFrame>& frame, const bool compressionEnabled) {
+    Entry entry;
+    entry.info = info;
+    entry.shared = frame;
+    push(lane, std::move(entry), compressionEnabled);
+}
+
+void OutboundLanes::push(const OutboundLane lane, Entry entry, const bool compressionEnabled) {
+    if (lane == OutboundLane::Bulk) {
+        heldBytes += entry.bytes(compressionEnabled).size();
+        bulk.push_back(std::move(entry));
+        bulkFrames++;
+        return;
+    }
+
+    if (entry.info.entityID >= 0 && supersede(entry, compressionEnabled)) {
+        return;
+    }
+    heldBytes += entry.bytes(compressionEnabled).size();
+    normal.push_back(std::move(entry));
+    normalFrames++;
+}
+
+void OutboundLanes::drop(Entry& entry, const bool compressionEnabled) {
+    heldBytes -= entry.bytes(compressionEnabled).size();
+    normalFrames--;
+    entry.dropped = true;
+    entry.data = {};
+    entry.shared.reset();
+}
+
+// Drops held movement the new frame makes redundant. Returns true if the new frame was merged into
+// a replacement that has already been queued.
+bool OutboundLanes::supersede(const Entry& entry, const bool compressionEnabled) {
+    const int32_t packetID = entry.info.packetID;
+    const int32_t entityID = entry.info.entityID;
+    bool relativeMove = packetID == UPDATE_ENTITY_POSITION || packetID == UPDATE_ENTITY_POSITION_AND_ROTATION;
+
+    for (auto it = normal.rbegin(); it != normal.rend(); ++it) {
+        Entry& held = *it;
+        if (held.dropped) {
+            continue;
+        }
+        if (isBarrier(held.info.packetID)) {
+            break;
+        }
+        if (held.info.entityID != entityID) {
+            continue;
+        }
+        const int32_t heldID = held.info.packetID;
+
+        if (packetID == TELEPORT_ENTITY) {
+            // An absolute position replaces every earlier move and turn
+            if (isPositionPacket(heldID) || heldID == UPDATE_ENTITY_ROTATION) {
+                drop(held, compressionEnabled);
+                droppedFrames++;
+            }
+            continue;
+        }
+
+        if (!relativeMove) {
+            // Rotation, head rotation and velocity are absolute, only the newest one matters
+            if (heldID == packetID) {
+                drop(held, compressionEnabled);
+                droppedFrames++;
+            }
+            continue;
+        }
+
+        if (!isPositionPacket(heldID)) {
+            continue;
+        }
+        // Relative moves only add up with the latest earlier move of the same kind
+        if (heldID != packetID) {
+            return false;
+        }
+        std::span<const uint8_t> older = uncompressedPayload(held.bytes(compressionEnabled), compressionEnabled);
+        std::span<const uint8_t> newer = uncompressedPayload(entry.bytes(compressionEnabled), compressionEnabled);
+        if (older.empty() || newer.empty()) {
+            return false;
+        }
+
+        Entry merged;
+        merged.info = entry.info;
+        merged.data.resize(PacketWriter::HEADROOM);
+        if (!mergeMoves(older, newer, merged.data)) {
+            return false;
+        }
+        merged.start = finishFrame(merged.data, compressionEnabled ? 0 : -1).data() - merged.data.data();
+
+        drop(held, compressionEnabled);
+        mergedFrames++;
+        heldBytes += merged.bytes(compressionEnabled).size();
+        normal.push_back(std::move(merged));
+        normalFrames++;
+        return true;
+    }
+    return false;
+}
+
+void OutboundLanes::drainInto(OutboundQueue& wire, EVP_CIPHER_CTX* cipher, const size_t limit, const bool compressionEnabled) {
+    while (wire.size() < limit && (!normal.empty() || !bulk.empty())) {
+        bool fromNormal = !normal.empty();
+        std::deque<Entry>& lane = fromNormal ? normal : bulk;
+        Entry& entry = lane.front();
+        if (!entry.dropped) {
+            std::span<const uint8_t> frame = entry.bytes(compressionEnabled);
+            auto started = cipher ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+            wire.write(frame, cipher);
+            recordFrameWritten(entry.info.packetID, frame.size(), cipher != nullptr, cipher ? nanosSince(started) : 0);
+            heldBytes -= frame.size();
+            (fromNormal ? normalFrames : bulkFrames)--;
+        }
+        lane.pop_front();
+    }
+}
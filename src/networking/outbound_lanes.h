@@ -0,0 +1,73 @@
+#ifndef OUTBOUND_LANES_H
+#define OUTBOUND_LANES_H
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <span>
+#include <vector>
+#include <openssl/types.h>
+
+class OutboundQueue;
+class SharedFrame;
+
+enum class OutboundLane {
+    Urgent, // Keep alive and teleports, never held back
+    Normal, // Entity movement and everything else
+    Bulk    // Chunk data and packets that must stay ordered with it
+};
+
+// What the backpressure logic needs to know about a frame
+struct FrameInfo {
+    int32_t packetID = -1;
+    int32_t entityID = -1; // Only for entity movement packets
+};
+
+FrameInfo describePayload(std::span<const uint8_t> payload);
+OutboundLane laneFor(int32_t packetID);
+
+// Frames held back from a congested connection, by priority.
+// Once a client's socket queue passes the high watermark, new Normal and Bulk frames wait here
+// (plaintext, since CFB8 has to encrypt in wire order) instead of piling up on the socket.
+// Held movement for an entity is dropped or merged when a newer update supersedes it, and
+// Bulk frames only move on once the Normal lane is empty.
+// Not thread-safe: ClientConnection::sendMutex guards it.
+class OutboundLanes {
+public:
+    void push(OutboundLane lane, const FrameInfo& info, std::span<const uint8_t> frame, bool compressionEnabled);
+    void push(OutboundLane lane, const FrameInfo& info, const std::shared_ptr<const SharedFrame>& frame, bool compressionEnabled);
+
+    // Encrypts held frames into the wire queue, Normal before Bulk, until it holds at least limit bytes
+    void drainInto(OutboundQueue& wire, EVP_CIPHER_CTX* cipher, size_t limit, bool compressionEnabled);
+
+    bool empty() const { return normalFrames == 0 && bulkFrames == 0; }
+    bool empty(OutboundLane lane) const;
+    size_t size() const { return heldBytes; }
+
+    bool congested = false;
+    uint64_t droppedFrames = 0;
+    uint64_t mergedFrames = 0;
+
+private:
+    struct Entry {
+        FrameInfo info;
+        std::vector<uint8_t> data;
+        size_t start = 0;
+        std::shared_ptr<const SharedFrame> shared;
+        bool dropped = false;
+
+        std::span<const uint8_t> bytes(bool compressionEnabled) const;
+    };
+
+    void push(OutboundLane lane, Entry entry, bool compressionEnabled);
+    bool supersede(const Entry& entry, bool compressionEnabled);
+    void drop(Entry& entry, bool compressionEnabled);
+
+    std::deque<Entry> normal;
+    std::deque<Entry> bulk;
+    size_t normalFrames = 0;
+    size_t bulkFrames = 0;
+    size_t heldBytes = 0;
+};
+
+#endif //OUTBOUND_LANES_H
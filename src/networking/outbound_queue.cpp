@@ -0,0 +1,124 @@
+#include "outbound_queue.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#ifndef _WIN32
+#include <netinet/tcp.h>
+#include <sys/uio.h>
+#endif
+#include <openssl/evp.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+constexpr size_t CHUNK_SIZE = 65536;
+constexpr size_t MAX_SPARE_CHUNKS = 4;
+constexpr int MAX_IOV = 64;
+
+void OutboundQueue::write(std::span<const uint8_t> data, EVP_CIPHER_CTX* cipher) {
+    while (!data.empty()) {
+        if (chunks.empty() || chunks.back().end == chunks.back().data.size()) {
+            Chunk chunk;
+            if (!spareChunks.empty()) {
+                chunk.data = std::move(spareChunks.back());
+                spareChunks.pop_back();
+            } else {
+                chunk.data.resize(CHUNK_SIZE);
+            }
+            chunks.push_back(std::move(chunk));
+        }
+
+        Chunk& tail = chunks.back();
+        size_t count = std::min(data.size(), tail.data.size() - tail.end);
+        uint8_t* out = tail.data.data() + tail.end;
+        if (cipher) {
+            // CFB8 is a stream mode, so a frame can be encrypted across chunk boundaries
+            int outLen = 0;
+            if (EVP_EncryptUpdate(cipher, out, &outLen, data.data(), static_cast<int>(count)) != 1) {
+                throw std::runtime_error("Failed to encrypt packet data");
+            }
+        } else {
+            std::memcpy(out, data.data(), count);
+        }
+        tail.end += count;
+        queuedBytes += count;
+        data = data.subspan(count);
+    }
+}
+
+bool OutboundQueue::flush(SocketType socket) {
+#ifndef _WIN32
+    // Cork while a backlog needs several calls so the kernel only emits full segments
+    bool corked = false;
+#ifdef TCP_CORK
+    int cork = 1;
+    if (chunks.size() > MAX_IOV) {
+        corked = setsockopt(socket, IPPROTO_TCP, TCP_CORK, &cork, sizeof(cork)) == 0;
+    }
+#endif
+#endif
+
+    bool ok = true;
+    while (queuedBytes > 0) {
+#ifdef _WIN32
+        Chunk& chunk = chunks.front();
+        int sent = send(socket, reinterpret_cast<const char*>(chunk.data.data() + chunk.begin), static_cast<int>(chunk.end - chunk.begin), 0);
+        if (sent == SOCKET_ERROR) {
+            ok = WSAGetLastError() == WSAEWOULDBLOCK;
+            break;
+        }
+#else
+        iovec iov[MAX_IOV];
+        int count = 0;
+        for (const Chunk& chunk : chunks) {
+            if (count == MAX_IOV) break;
+            iov[count].iov_base = const_cast<uint8_t*>(chunk.data.data() + chunk.begin);
+            iov[count].iov_len = chunk.end - chunk.begin;
+            count++;
+        }
+
+        msghdr message{};
+        message.msg_iov = iov;
+        message.msg_iovlen = count;
+        ssize_t sent = sendmsg(socket, &message, MSG_NOSIGNAL);
+        if (sent == -1) {
+            if (errno == EINTR) continue;
+            ok = errno == EAGAIN || errno == EWOULDBLOCK;
+            break;
+        }
+#endif
+        consume(sent);
+    }
+
+#if !defined(_WIN32) && defined(TCP_CORK)
+    if (corked) {
+        cork = 0;
+        setsockopt(socket, IPPROTO_TCP, TCP_CORK, &cork, sizeof(cork));
+    }
+#endif
+    return ok;
+}
+
+void OutboundQueue::consume(size_t count) {
+    queuedBytes -= count;
+    while (count > 0) {
+        Chunk& chunk = chunks.front();
+        size_t taken = std::min(count, chunk.end - chunk.begin);
+        chunk.begin += taken;
+        count -= taken;
+
+        if (chunk.begin == chunk.end && (chunk.end == chunk.data.size() || chunks.size() > 1)) {
+            if (spareChunks.size() < MAX_SPARE_CHUNKS) {
+                spareChunks.push_back(std::move(chunk.data));
+            }
+            chunks.pop_front();
+        }
+    }
+
+    // Reuse the tail chunk from the start once it is fully sent
+    if (chunks.size() == 1 && chunks.front().begin == chunks.front().end) {
+        chunks.front().begin = chunks.front().end = 0;
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef OUTBOUND_QUEUE_H
+#define OUTBOUND_QUEUE_H
+
+#include <cstdint>
+#include <deque>
+#include <span>
+#include <vector>
+#include <openssl/types.h>
+
+#include "network.h"
+
+// Bytes waiting to be written to a client's socket.
+// Frames are appended (and encrypted, if a cipher is given) into fixed-size chunks,
+// and a flush hands every queued chunk to the kernel in one sendmsg() call.
+// Not thread-safe: ClientConnection::sendMutex guards it.
+class OutboundQueue {
+public:
+    void write(std::span<const uint8_t> data, EVP_CIPHER_CTX* cipher = nullptr);
+
+    // Writes as much as the socket accepts without blocking. Returns false on a socket error.
+    bool flush(SocketType socket);
+
+    size_t size() const { return queuedBytes; }
+    bool empty() const { return queuedBytes == 0; }
+
+private:
+    struct Chunk {
+        std::vector<uint8_t> data;
+        size_t begin = 0; // First unsent byte
+        size_t end = 0;   // End of queued bytes
+    };
+
+    void consume(size_t count);
+
+    std::deque<Chunk> chunks;
+    std::vector<std::vector<uint8_t>> spareChunks;
+    size_t queuedBytes = 0;
+};
+
+#endif //OUTBOUND_QUEUE_H
@@ -0,0 +1,168 @@
+#include "packet_capture.h"
+
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "network.h"
+#include "packet_reader.h"
+#include "core/config.h"
+#include "core/server.h"
+#include "core/utils.h"
+#include "entities/player.h"
+
+constexpr char CAPTURE_MAGIC[] = {'M', 'C', 'P', 'C', 'A', 'P'};
+constexpr size_t CAPTURE_FLUSH_SIZE = 65536;
+constexpr size_t MAX_CAPTURED_PACKET = 2097151;
+
+enum CaptureRecordType : uint8_t {
+    CAPTURE_PLAYER = 1,
+    CAPTURE_PACKET = 2
+};
+
+static std::mutex captureMutex;
+static std::atomic<bool> capturing{false};
+static std::ofstream captureFile;
+static std::vector<uint8_t> captureBuffer;                           // Records not written to the file yet
+static std::unordered_map<std::string, uint32_t> captureConnections; // Player UUID -> connection number
+static uint64_t lastCapturedTick = 0;
+
+// Called with captureMutex held
+static void flushCaptureBuffer() {
+    captureFile.write(reinterpret_cast<const char*>(captureBuffer.data()), static_cast<std::streamsize>(captureBuffer.size()));
+    captureBuffer.clear();
+}
+
+bool startPacketCapture(const std::string& path) {
+    std::lock_guard lock(captureMutex);
+    if (capturing) {
+        return false;
+    }
+    captureFile.open(path, std::ios::binary | std::ios::trunc);
+    if (!captureFile) {
+        logMessage("Failed to create capture file " + path, LOG_ERROR);
+        return false;
+    }
+
+    captureBuffer.assign(std::begin(CAPTURE_MAGIC), std::end(CAPTURE_MAGIC));
+    captureBuffer.push_back(CAPTURE_VERSION);
+    writeVarInt(captureBuffer, serverConfig.ticksPerSecond);
+    captureConnections.clear();
+    lastCapturedTick = timerWheel.currentTick();
+    capturing = true;
+    logMessage("Capturing serverbound packets to " + path, LOG_INFO);
+    return true;
+}
+
+bool stopPacketCapture() {
+    std::lock_guard lock(captureMutex);
+    if (!capturing) {
+        return false;
+    }
+    capturing = false;
+    flushCaptureBuffer();
+    captureFile.close();
+    logMessage("Packet capture stopped, " + std::to_string(captureConnections.size()) + " connections recorded", LOG_INFO);
+    return true;
+}
+
+bool packetCaptureActive() {
+    return capturing.load(std::memory_order_relaxed);
+}
+
+void capturePacket(const Player& player, std::span<const uint8_t> packet) {
+    std::lock_guard lock(captureMutex);
+    if (!capturing) {
+        return;
+    }
+
+    auto [it, firstPacket] = captureConnections.try_emplace(player.uuidString, static_cast<uint32_t>(captureConnections.size()));
+    if (firstPacket) {
+        captureBuffer.push_back(CAPTURE_PLAYER);
+        writeVarInt(captureBuffer, static_cast<int32_t>(it->second));
+        writeString(captureBuffer, player.name);
+        captureBuffer.insert(captureBuffer.end(), player.uuid.begin(), player.uuid.end());
+        writeDouble(captureBuffer, player.position.x);
+        writeDouble(captureBuffer, player.position.y);
+        writeDouble(captureBuffer, player.position.z);
+        writeFloat(captureBuffer, player.rotation.yaw);
+        writeFloat(captureBuffer, player.rotation.pitch);
+        captureBuffer.push_back(static_cast<uint8_t>(player.gameMode));
+    }
+
+    uint64_t tick = timerWheel.currentTick();
+    captureBuffer.push_back(CAPTURE_PACKET);
+    writeVarInt(captureBuffer, static_cast<int32_t>(tick - lastCapturedTick));
+    lastCapturedTick = tick;
+    writeVarInt(captureBuffer, static_cast<int32_t>(it->second));
+    writeVarInt(captureBuffer, static_cast<int32_t>(packet.size()));
+    captureBuffer.insert(captureBuffer.end(), packet.begin(), packet.end());
+
+    if (captureBuffer.size() >= CAPTURE_FLUSH_SIZE) {
+        flushCaptureBuffer();
+    }
+}
+
+bool loadPacketCapture(const std::string& path, PacketCapture& capture) {
+    std::vector<uint8_t> contents = readFile(path);
+    if (contents.size() < sizeof(CAPTURE_MAGIC) + 1 || std::memcmp(contents.data(), CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC)) != 0) {
+        logMessage(path + " is not a packet capture", LOG_ERROR);
+        return false;
+    }
+
+    PacketReader reader(std::span<const uint8_t>(contents).subspan(sizeof(CAPTURE_MAGIC)));
+    try {
+        uint8_t version = reader.readByte();
+        if (version != CAPTURE_VERSION) {
+            logMessage("Unsupported capture version " + std::to_string(version), LOG_ERROR);
+            return false;
+        }
+        capture.ticksPerSecond = reader.readVarInt();
+
+        uint64_t tick = 0;
+        std::unordered_set<uint32_t> connections; // Every connection a Player record was read for
+        while (!reader.empty()) {
+            switch (reader.readByte()) {
+                case CAPTURE_PLAYER: {
+                    CapturedPlayer player{};
+                    player.connection = static_cast<uint32_t>(reader.readVarInt());
+                    player.name = std::string(reader.readString(16));
+                    std::span<const uint8_t> uuid = reader.readBytes(16);
+                    std::copy(uuid.begin(), uuid.end(), player.uuid.begin());
+                    player.x = reader.readDouble();
+                    player.y = reader.readDouble();
+                    player.z = reader.readDouble();
+                    player.yaw = reader.readFloat();
+                    player.pitch = reader.readFloat();
+                    player.gameMode = reader.readByte();
+                    connections.insert(player.connection);
+                    capture.players.push_back(std::move(player));
+                    break;
+                }
+                case CAPTURE_PACKET: {
+                    CapturedPacket packet;
+                    tick += static_cast<uint32_t>(reader.readVarInt());
+                    packet.tick = tick;
+                    packet.connection = static_cast<uint32_t>(reader.readVarInt());
+                    std::span<const uint8_t> data = reader.readByteArray(MAX_CAPTURED_PACKET);
+                    packet.data.assign(data.begin(), data.end());
+
+                    if (!connections.contains(packet.connection)) {
+                        throw PacketReadError("packet for an unknown connection");
+                    }
+                    capture.packets.push_back(std::move(packet));
+                    break;
+                }
+                default:
+                    throw PacketReadError("unknown record type");
+            }
+        }
+    } catch (const PacketReadError& e) {
+        // A capture cut short by a crash is still worth replaying up to there
+        logMessage("Capture " + path + " ends early: " + e.what(), LOG_WARNING);
+    }
+    return true;
+}
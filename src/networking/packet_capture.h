@@ -0,0 +1,59 @@
+#ifndef PACKET_CAPTURE_H
+#define PACKET_CAPTURE_H
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+struct ClientConnection;
+struct Player;
+
+// Capture files hold the decoded serverbound Play packets of every connection, in the order
+// handleClientPacket saw them, so a session can be replayed offline by MCppServerReplay.
+//
+// Layout: the magic "MCPCAP", a version byte and the ticks per second as a VarInt, then records
+// that each start with a type byte:
+//   Player: VarInt connection, String name, 16 byte UUID, X/Y/Z doubles, yaw/pitch floats, gamemode byte.
+//           Written before the first packet of a connection, with where the player was at that point.
+//   Packet: VarInt ticks since the previous packet, VarInt connection, VarInt length, Packet ID + Data.
+
+constexpr uint8_t CAPTURE_VERSION = 1;
+
+struct CapturedPlayer {
+    uint32_t connection;
+    std::string name;
+    std::array<uint8_t, 16> uuid;
+    double x, y, z;
+    float yaw, pitch;
+    uint8_t gameMode;
+};
+
+struct CapturedPacket {
+    uint32_t connection;
+    uint64_t tick; // Since the start of the capture
+    std::vector<uint8_t> data;
+};
+
+struct PacketCapture {
+    int32_t ticksPerSecond = 20;
+    std::vector<CapturedPlayer> players;
+    std::vector<CapturedPacket> packets;
+};
+
+// Starts writing every Play packet handled from now on to path. Returns false if a capture is
+// already running or the file can't be created.
+bool startPacketCapture(const std::string& path);
+// Flushes and closes the capture file. Returns false if no capture was running.
+bool stopPacketCapture();
+bool packetCaptureActive();
+
+// Called by handleClientPacket on the tick thread with the whole packet (Packet ID + Data)
+void capturePacket(const Player& player, std::span<const uint8_t> packet);
+
+// Reads a whole capture file. Logs and returns false if it is not a capture. A capture that is cut
+// short, e.g. by a crash, is read up to the break with a warning.
+bool loadPacketCapture(const std::string& path, PacketCapture& capture);
+
+#endif //PACKET_CAPTURE_H
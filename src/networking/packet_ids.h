@@ -57,13 +57,26 @@
 #define OPEN_SCREEN 0x33
 #define BLOCK_DESTROY_STAGE 0x06
 #define UPDATE_ATTRIBUTES 0x75
+#define ENCRYPTION_REQUEST 0x01
+#define DISCONNECT_CONFIG 0x02
+#define KEEP_ALIVE_CONFIG 0x04
+#define PING_CONFIG 0x05
+#define BLOCK_UPDATE 0x09
+#define CHUNK_BATCH_FINISHED 0x0C
+#define CHUNK_BATCH_START 0x0D
+#define DISCONNECT_PLAY 0x1D
+#define CHUNK_DATA 0x27
+#define PING_PLAY 0x35
+#define UPDATE_SECTION_BLOCKS 0x49
 
 // Client -> Server Packets
 #define STATUS_REQUEST 0x00
 #define ZERO_PACKET 0x00
 #define CLIENT_INFORMATION 0x00
 #define HANDSHAKE 0x00
+#define LOGIN_START 0x00
 #define PING_REQUEST 0x01
+#define ENCRYPTION_RESPONSE 0x01
 #define LOGIN_PLUGIN_RESPONSE 0x02
 #define ACKNOWLEDGE_FINISH_CONFIGURATION 0x03
 #define LOGIN_ACKNOWLEDGE 0x03
@@ -87,5 +100,9 @@
 #define CREATIVE_MODE_SLOT 0x32
 #define SWING_ARM 0x36
 #define USE_ITEM_ON 0x38
+#define SERVERBOUND_KEEP_ALIVE_CONFIG 0x04
+#define PONG_CONFIG 0x05
+#define CHUNK_BATCH_RECEIVED 0x08
+#define PONG_PLAY 0x27
 
 #endif //PACKET_IDS_H
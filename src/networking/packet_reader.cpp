@@ -0,0 +1,179 @@
+#include "packet_reader.h"
+
+#include <bit>
+#include <cstring>
+
+#include "entities/slot_data.h"
+
+constexpr int MAX_VARINT_BYTES = 5;
+constexpr int MAX_VARLONG_BYTES = 10;
+
+// Packs the low 7 bits of each byte of a little-endian word into one value
+static uint64_t compactGroups(uint64_t word) {
+    return (word & 0x7F)
+        | ((word >> 1) & (0x7FULL << 7))
+        | ((word >> 2) & (0x7FULL << 14))
+        | ((word >> 3) & (0x7FULL << 21))
+        | ((word >> 4) & (0x7FULL << 28))
+        | ((word >> 5) & (0x7FULL << 35))
+        | ((word >> 6) & (0x7FULL << 42))
+        | ((word >> 7) & (0x7FULL << 49));
+}
+
+// Decodes a VarInt of up to 8 bytes from a single unaligned load. Returns its length in bytes,
+// or 0 if none of the 8 bytes ends it.
+static int decodeVarIntWord(const uint8_t* in, uint64_t& value) {
+    uint64_t word;
+    std::memcpy(&word, in, sizeof(word));
+    // The first byte without a continuation bit is the last one
+    uint64_t stops = ~word & 0x8080808080808080ULL;
+    if (stops == 0) {
+        return 0;
+    }
+    int length = std::countr_zero(stops) / 8 + 1;
+    uint64_t mask = length == 8 ? ~0ULL : (1ULL << (length * 8)) - 1;
+    value = compactGroups(word & mask);
+    return length;
+}
+
+const uint8_t* PacketReader::take(const size_t count) {
+    if (count > remaining()) {
+        throw PacketReadError("Packet ended " + std::to_string(count - remaining()) + " byte(s) early at offset " + std::to_string(offset));
+    }
+    const uint8_t* start = data.data() + offset;
+    offset += count;
+    return start;
+}
+
+uint64_t PacketReader::readVarIntSlow(const int maxBytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < maxBytes; i++) {
+        uint8_t read = readByte();
+        value |= static_cast<uint64_t>(read & 0x7F) << (7 * i);
+        if ((read & 0x80) == 0) {
+            return value;
+        }
+    }
+    throw PacketReadError(maxBytes == MAX_VARINT_BYTES ? "VarInt is too big" : "VarLong is too big");
+}
+
+int32_t PacketReader::readVarInt() {
+    if constexpr (std::endian::native == std::endian::little) {
+        // Most VarInts are a byte or two, decode them without a loop when a full word is left
+        if (remaining() >= sizeof(uint64_t)) {
+            uint64_t value = 0;
+            int length = decodeVarIntWord(data.data() + offset, value);
+            if (length == 0 || length > MAX_VARINT_BYTES) {
+                throw PacketReadError("VarInt is too big");
+            }
+            offset += length;
+            return static_cast<int32_t>(static_cast<uint32_t>(value));
+        }
+    }
+    return static_cast<int32_t>(static_cast<uint32_t>(readVarIntSlow(MAX_VARINT_BYTES)));
+}
+
+int64_t PacketReader::readVarLong() {
+    if constexpr (std::endian::native == std::endian::little) {
+        if (remaining() >= sizeof(uint64_t)) {
+            uint64_t value = 0;
+            if (int length = decodeVarIntWord(data.data() + offset, value)) {
+                offset += length;
+                return static_cast<int64_t>(value);
+            }
+        }
+    }
+    return static_cast<int64_t>(readVarIntSlow(MAX_VARLONG_BYTES));
+}
+
+uint8_t PacketReader::readByte() {
+    return *take(1);
+}
+
+int16_t PacketReader::readShort() {
+    const uint8_t* in = take(2);
+    return static_cast<int16_t>((in[0] << 8) | in[1]);
+}
+
+int32_t PacketReader::readInt() {
+    const uint8_t* in = take(4);
+    return static_cast<int32_t>((static_cast<uint32_t>(in[0]) << 24) | (in[1] << 16) | (in[2] << 8) | in[3]);
+}
+
+int64_t PacketReader::readLong() {
+    const uint8_t* in = take(8);
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value = (value << 8) | in[i];
+    }
+    return static_cast<int64_t>(value);
+}
+
+float PacketReader::readFloat() {
+    return std::bit_cast<float>(readInt());
+}
+
+double PacketReader::readDouble() {
+    return std::bit_cast<double>(readLong());
+}
+
+std::string_view PacketReader::readString(const size_t maxLength) {
+    int32_t length = readVarInt();
+    // The limit is in characters, each of which takes up to 3 bytes in (modified) UTF-8
+    if (length < 0 || static_cast<size_t>(length) > maxLength * 3) {
+        throw PacketReadError("Invalid string length: " + std::to_string(length));
+    }
+    return {reinterpret_cast<const char*>(take(length)), static_cast<size_t>(length)};
+}
+
+std::array<uint8_t, 16> PacketReader::readUUID() {
+    std::array<uint8_t, 16> uuid{};
+    std::memcpy(uuid.data(), take(uuid.size()), uuid.size());
+    return uuid;
+}
+
+std::span<const uint8_t> PacketReader::readBytes(const size_t length) {
+    return {take(length), length};
+}
+
+std::span<const uint8_t> PacketReader::readByteArray(const size_t maxLength) {
+    int32_t length = readVarInt();
+    if (length < 0 || static_cast<size_t>(length) > maxLength) {
+        throw PacketReadError("Invalid byte array length: " + std::to_string(length));
+    }
+    return readBytes(length);
+}
+
+std::span<const uint8_t> PacketReader::readRemaining() {
+    return readBytes(remaining());
+}
+
+SlotData PacketReader::readSlot() {
+    SlotData slot;
+    int32_t itemCount = readVarInt();
+    if (itemCount <= 0) {
+        return slot;
+    }
+    slot.itemCount = itemCount;
+    slot.itemId = readVarInt();
+
+    int32_t numComponentsToAdd = readVarInt();
+    int32_t numComponentsToRemove = readVarInt();
+    slot.numCompToAdd = numComponentsToAdd;
+    slot.numCompToRemove = numComponentsToRemove;
+    if (numComponentsToAdd > 0) {
+        std::vector<Component> componentsToAdd;
+        for (int32_t i = 0; i < numComponentsToAdd; ++i) {
+            componentsToAdd.push_back(parseComponent(*this));
+        }
+        slot.compsToAdd = std::move(componentsToAdd);
+    }
+    if (numComponentsToRemove > 0) {
+        std::vector<ComponentType> componentsToRemove;
+        for (int32_t i = 0; i < numComponentsToRemove; ++i) {
+            componentsToRemove.push_back(static_cast<ComponentType>(readVarInt()));
+        }
+        slot.compsToRemove = std::move(componentsToRemove);
+    }
+    return slot;
+}
@@ -0,0 +1,58 @@
+#ifndef PACKET_READER_H
+#define PACKET_READER_H
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+struct SlotData;
+
+// Thrown when a packet ends before a field does, or a field is malformed.
+// handleClientData catches it and drops the connection.
+class PacketReadError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// Reads the fields of a serverbound packet straight from the frame it arrived in.
+// Strings and byte arrays come back as views into the frame, so they are only valid while the
+// packet is being handled; copy them into a std::string or std::vector to keep them.
+class PacketReader {
+public:
+    explicit PacketReader(std::span<const uint8_t> data) : data(data) {}
+
+    int32_t readVarInt();
+    int64_t readVarLong();
+    uint8_t readByte();
+    bool readBool() { return readByte() != 0; }
+    int16_t readShort();
+    int32_t readInt();
+    int64_t readLong();
+    float readFloat();
+    double readDouble();
+
+    // A VarInt length followed by that many UTF-8 bytes
+    std::string_view readString(size_t maxLength = 32767);
+    std::array<uint8_t, 16> readUUID();
+    std::span<const uint8_t> readBytes(size_t length);
+    // A VarInt length followed by that many bytes
+    std::span<const uint8_t> readByteArray(size_t maxLength);
+    std::span<const uint8_t> readRemaining();
+    SlotData readSlot();
+
+    size_t position() const { return offset; }
+    size_t remaining() const { return data.size() - offset; }
+    bool empty() const { return offset == data.size(); }
+
+private:
+    const uint8_t* take(size_t count);
+    uint64_t readVarIntSlow(int maxBytes);
+
+    std::span<const uint8_t> data;
+    size_t offset = 0;
+};
+
+#endif //PACKET_READER_H
@@ -0,0 +1,206 @@
+#include "packet_stats.h"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+
+#include "compression_policy.h"
+
+constexpr size_t MAX_PACKET_ID = 256;
+constexpr size_t DIRECTIONS = 2;
+
+enum Counter : size_t {
+    Count,
+    RawBytes,
+    CompressedBytes,
+    EncryptedBytes,
+    WireBytes,
+    SerializeNanos,
+    CompressNanos,
+    EncryptNanos,
+    COUNTER_COUNT
+};
+
+using Totals = std::array<std::array<std::array<uint64_t, COUNTER_COUNT>, MAX_PACKET_ID>, DIRECTIONS>;
+
+struct Shard {
+    // Only the owning thread writes, so plain load + store is enough and other threads can read at any time
+    std::array<std::array<std::array<std::atomic<uint64_t>, COUNTER_COUNT>, MAX_PACKET_ID>, DIRECTIONS> counters{};
+    bool inUse = true;
+};
+
+static std::mutex shardsMutex;
+static std::vector<std::unique_ptr<Shard>> shards; // Never shrinks, a thread that exits leaves its counts behind
+static Totals baseline{};                          // Totals at the last reset
+
+static Shard* acquireShard() {
+    std::lock_guard lock(shardsMutex);
+    for (const auto& shard : shards) {
+        if (!shard->inUse) {
+            shard->inUse = true;
+            return shard.get();
+        }
+    }
+    shards.push_back(std::make_unique<Shard>());
+    return shards.back().get();
+}
+
+// Hands the shard over to the next thread that starts recording
+struct ShardHandle {
+    Shard* shard = acquireShard();
+
+    ~ShardHandle() {
+        std::lock_guard lock(shardsMutex);
+        shard->inUse = false;
+    }
+};
+
+static std::array<std::atomic<uint64_t>, COUNTER_COUNT>* countersFor(PacketDirection direction, int32_t packetID) {
+    if (packetID < 0 || packetID >= static_cast<int32_t>(MAX_PACKET_ID)) {
+        return nullptr;
+    }
+    static thread_local ShardHandle handle;
+    return &handle.shard->counters[static_cast<size_t>(direction)][packetID];
+}
+
+static void add(std::atomic<uint64_t>& counter, uint64_t value) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+void recordPacketSent(const int32_t packetID, const size_t rawBytes) {
+    if (auto counters = countersFor(PacketDirection::Clientbound, packetID)) {
+        add((*counters)[Count], 1);
+        add((*counters)[RawBytes], rawBytes);
+    }
+}
+
+void recordSerializeTime(const int32_t packetID, const uint64_t nanos) {
+    if (auto counters = countersFor(PacketDirection::Clientbound, packetID)) {
+        add((*counters)[SerializeNanos], nanos);
+    }
+}
+
+void recordCompression(const int32_t packetID, const size_t compressedBytes, const uint64_t nanos) {
+    if (auto counters = countersFor(PacketDirection::Clientbound, packetID)) {
+        add((*counters)[CompressedBytes], compressedBytes);
+        add((*counters)[CompressNanos], nanos);
+    }
+}
+
+void recordFrameWritten(const int32_t packetID, const size_t frameBytes, const bool encrypted, const uint64_t encryptNanos) {
+    if (auto counters = countersFor(PacketDirection::Clientbound, packetID)) {
+        add((*counters)[WireBytes], frameBytes);
+        if (encrypted) {
+            add((*counters)[EncryptedBytes], frameBytes);
+            add((*counters)[EncryptNanos], encryptNanos);
+        }
+    }
+}
+
+void recordPacketReceived(const int32_t packetID, const size_t rawBytes, const size_t frameBytes, const bool compressed, const bool encrypted, const uint64_t inflateNanos) {
+    if (auto counters = countersFor(PacketDirection::Serverbound, packetID)) {
+        add((*counters)[Count], 1);
+        add((*counters)[RawBytes], rawBytes);
+        add((*counters)[WireBytes], frameBytes);
+        if (compressed) {
+            add((*counters)[CompressedBytes], frameBytes);
+            add((*counters)[CompressNanos], inflateNanos);
+        }
+        if (encrypted) {
+            add((*counters)[EncryptedBytes], frameBytes);
+        }
+    }
+}
+
+// Sums every shard. Called with shardsMutex held.
+static Totals mergeShards() {
+    Totals totals{};
+    for (const auto& shard : shards) {
+        for (size_t direction = 0; direction < DIRECTIONS; direction++) {
+            for (size_t id = 0; id < MAX_PACKET_ID; id++) {
+                for (size_t counter = 0; counter < COUNTER_COUNT; counter++) {
+                    totals[direction][id][counter] += shard->counters[direction][id][counter].load(std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+    return totals;
+}
+
+std::vector<PacketTrafficStats> getPacketStats() {
+    std::lock_guard lock(shardsMutex);
+    Totals totals = mergeShards();
+
+    std::vector<PacketTrafficStats> stats;
+    for (size_t direction = 0; direction < DIRECTIONS; direction++) {
+        for (size_t id = 0; id < MAX_PACKET_ID; id++) {
+            std::array<uint64_t, COUNTER_COUNT> values{};
+            for (size_t counter = 0; counter < COUNTER_COUNT; counter++) {
+                // A shard may still be writing its counts while the baseline was taken
+                uint64_t total = totals[direction][id][counter];
+                uint64_t base = baseline[direction][id][counter];
+                values[counter] = total > base ? total - base : 0;
+            }
+            if (values[Count] == 0 && values[WireBytes] == 0) {
+                continue;
+            }
+            stats.push_back({
+                static_cast<PacketDirection>(direction),
+                static_cast<int32_t>(id),
+                values[Count],
+                values[RawBytes],
+                values[CompressedBytes],
+                values[EncryptedBytes],
+                values[WireBytes],
+                values[SerializeNanos],
+                values[CompressNanos],
+                values[EncryptNanos]
+            });
+        }
+    }
+    return stats;
+}
+
+void resetPacketStats() {
+    // Shards belong to their threads, so a reset moves the baseline instead of clearing them
+    std::lock_guard lock(shardsMutex);
+    baseline = mergeShards();
+}
+
+std::string dumpPacketStats() {
+    nlohmann::json traffic = nlohmann::json::array();
+    for (const PacketTrafficStats& entry : getPacketStats()) {
+        traffic.push_back({
+            {"direction", entry.direction == PacketDirection::Clientbound ? "clientbound" : "serverbound"},
+            {"packet_id", entry.packetID},
+            {"count", entry.count},
+            {"raw_bytes", entry.rawBytes},
+            {"compressed_bytes", entry.compressedBytes},
+            {"encrypted_bytes", entry.encryptedBytes},
+            {"wire_bytes", entry.wireBytes},
+            {"serialize_ns", entry.serializeNanos},
+            {"compress_ns", entry.compressNanos},
+            {"encrypt_ns", entry.encryptNanos}
+        });
+    }
+
+    nlohmann::json compression = nlohmann::json::array();
+    for (const PacketCompressionStats& entry : getCompressionStats()) {
+        compression.push_back({
+            {"packet_id", entry.packetID},
+            {"packets", entry.packets},
+            {"skipped", entry.skipped},
+            {"raw_bytes", entry.rawBytes},
+            {"compressed_bytes", entry.compressedBytes},
+            {"ratio", entry.ratio},
+            {"disabled", entry.disabled}
+        });
+    }
+
+    nlohmann::json dump;
+    dump["traffic"] = std::move(traffic);
+    dump["compression"] = std::move(compression);
+    return dump.dump(2);
+}
@@ -0,0 +1,47 @@
+#ifndef PACKET_STATS_H
+#define PACKET_STATS_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class PacketDirection : uint8_t {
+    Serverbound,
+    Clientbound
+};
+
+struct PacketTrafficStats {
+    PacketDirection direction;
+    int32_t packetID;
+    uint64_t count;
+    uint64_t rawBytes;        // Packet ID + Data
+    uint64_t compressedBytes; // Deflated payloads, counted once per compression
+    uint64_t encryptedBytes;  // Frames that went through the cipher
+    uint64_t wireBytes;       // Frames queued for or read from the socket
+    uint64_t serializeNanos;  // Clientbound only: building the packet
+    uint64_t compressNanos;   // Deflating clientbound, inflating serverbound packets
+    uint64_t encryptNanos;    // Clientbound only, serverbound data is decrypted in bulk
+};
+
+// Counters are kept in one shard per thread, written without locks by their owner and only merged
+// when someone asks for them. Packet IDs outside 0..255 are ignored.
+
+void recordPacketSent(int32_t packetID, size_t rawBytes);
+void recordSerializeTime(int32_t packetID, uint64_t nanos);
+void recordCompression(int32_t packetID, size_t compressedBytes, uint64_t nanos);
+void recordFrameWritten(int32_t packetID, size_t frameBytes, bool encrypted, uint64_t encryptNanos);
+void recordPacketReceived(int32_t packetID, size_t rawBytes, size_t frameBytes, bool compressed, bool encrypted, uint64_t inflateNanos);
+
+// Totals since the start or the last reset, for every packet type that has been seen
+std::vector<PacketTrafficStats> getPacketStats();
+void resetPacketStats();
+
+// The traffic and compression statistics as JSON
+std::string dumpPacketStats();
+
+inline uint64_t nanosSince(const std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+#endif //PACKET_STATS_H
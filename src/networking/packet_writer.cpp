@@ -0,0 +1,74 @@
+#include "packet_writer.h"
+
+#include <memory>
+
+#include "network.h"
+
+constexpr size_t MAX_POOLED_BUFFERS = 16;
+constexpr size_t MAX_POOLED_CAPACITY = 2097152; // Don't hold on to buffers from unusually large packets
+
+static thread_local std::vector<std::unique_ptr<std::vector<uint8_t>>> bufferPool;
+
+PooledBuffer::PooledBuffer() {
+    if (bufferPool.empty()) {
+        buffer = new std::vector<uint8_t>();
+    } else {
+        buffer = bufferPool.back().release();
+        bufferPool.pop_back();
+    }
+}
+
+PooledBuffer::~PooledBuffer() {
+    if (bufferPool.size() < MAX_POOLED_BUFFERS && buffer->capacity() <= MAX_POOLED_CAPACITY) {
+        buffer->clear();
+        bufferPool.emplace_back(buffer);
+    } else {
+        delete buffer;
+    }
+}
+
+PacketWriter::PacketWriter() {
+    storage->resize(HEADROOM);
+}
+
+PacketWriter::PacketWriter(const int32_t packetID) {
+    reset(packetID);
+}
+
+std::span<const uint8_t> PacketWriter::payload() const {
+    return std::span<const uint8_t>(*storage).subspan(HEADROOM);
+}
+
+void PacketWriter::reset(const int32_t packetID) {
+    storage->resize(HEADROOM);
+    writeVarInt(*storage, packetID);
+    started = std::chrono::steady_clock::now();
+}
+
+std::span<const uint8_t> PacketWriter::frame(const bool compressionEnabled) {
+    return finishFrame(*storage, compressionEnabled ? 0 : -1);
+}
+
+static void putVarInt(uint8_t* out, uint32_t value) {
+    while (value >= 0x80) {
+        *out++ = static_cast<uint8_t>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    *out = static_cast<uint8_t>(value);
+}
+
+std::span<const uint8_t> finishFrame(std::vector<uint8_t>& buffer, const int32_t dataLength) {
+    size_t start = PacketWriter::HEADROOM;
+
+    if (dataLength >= 0) {
+        start -= varIntSize(dataLength);
+        putVarInt(buffer.data() + start, dataLength);
+    }
+
+    // Packet Length covers the Data Length field as well
+    auto length = static_cast<uint32_t>(buffer.size() - start);
+    start -= varIntSize(length);
+    putVarInt(buffer.data() + start, length);
+
+    return std::span<const uint8_t>(buffer).subspan(start);
+}
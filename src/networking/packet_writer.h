@@ -0,0 +1,63 @@
+#ifndef PACKET_WRITER_H
+#define PACKET_WRITER_H
+
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// A byte buffer borrowed from a per-thread free list and handed back on destruction.
+// Returned buffers keep their capacity, so once a thread has warmed up its pool,
+// building a packet no longer touches the heap.
+class PooledBuffer {
+public:
+    PooledBuffer();
+    ~PooledBuffer();
+
+    PooledBuffer(const PooledBuffer&) = delete;
+    PooledBuffer& operator=(const PooledBuffer&) = delete;
+
+    std::vector<uint8_t>& operator*() const { return *buffer; }
+    std::vector<uint8_t>* operator->() const { return buffer; }
+
+private:
+    std::vector<uint8_t>* buffer;
+};
+
+// Builds a clientbound packet (Packet ID + Data) in a pooled buffer.
+// The buffer starts with HEADROOM spare bytes: once the packet is complete the
+// Packet Length and Data Length VarInts are written backwards into that space,
+// so the frame is finished in place instead of being copied behind a new header.
+class PacketWriter {
+public:
+    // Room for a Packet Length and a Data Length VarInt
+    static constexpr size_t HEADROOM = 10;
+
+    PacketWriter();
+    explicit PacketWriter(int32_t packetID);
+
+    // The buffer the write* helpers append to. The first HEADROOM bytes are reserved.
+    std::vector<uint8_t>& buffer() { return *storage; }
+
+    // Packet ID + Data
+    std::span<const uint8_t> payload() const;
+
+    // Discards everything written so far and starts a new packet
+    void reset(int32_t packetID);
+
+    // The uncompressed frame, with a zero Data Length when compression is enabled for the connection
+    std::span<const uint8_t> frame(bool compressionEnabled);
+
+    // When the packet was started, for the serialize time in the packet statistics
+    std::chrono::steady_clock::time_point startedAt() const { return started; }
+
+private:
+    PooledBuffer storage;
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+};
+
+// Writes the frame header in front of the data at buffer[HEADROOM..] and returns the whole frame.
+// A negative dataLength leaves out the Data Length field (compression not enabled).
+std::span<const uint8_t> finishFrame(std::vector<uint8_t>& buffer, int32_t dataLength);
+
+#endif //PACKET_WRITER_H
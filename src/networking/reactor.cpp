@@ -0,0 +1,380 @@
+#include "reactor.h"
+
+#include <cerrno>
+#include <cstring>
+#include <ranges>
+#ifdef __linux__
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+#include "client.h"
+#include "core/utils.h"
+
+constexpr int MAX_EVENTS = 64;
+constexpr int MAX_ACCEPTS_PER_WAKEUP = 64;
+constexpr int EPOLL_TIMEOUT_MS = 1000;
+constexpr auto IDLE_TIMEOUT = std::chrono::seconds(30);
+
+NetworkReactor::NetworkReactor(const size_t threadCount) : threadCount(std::max<size_t>(threadCount, 1)), nextThread(0), running(false) {}
+
+NetworkReactor::~NetworkReactor() {
+    stop();
+}
+
+NetworkReactor::IoThread::~IoThread() {
+#ifdef __linux__
+    if (listenFd != -1) close(listenFd);
+    if (wakeFd != -1) close(wakeFd);
+    if (epollFd != -1) close(epollFd);
+#endif
+}
+
+// Closes the listening sockets that no I/O thread owns yet, from index first on
+static void closeListenSockets(const std::vector<SocketType>& listenSockets, const size_t first) {
+    for (size_t i = first; i < listenSockets.size(); ++i) {
+        closeSocket(listenSockets[i]);
+    }
+}
+
+bool NetworkReactor::start(const std::vector<SocketType>& listenSockets) {
+    if (running.load()) return true;
+
+#ifdef __linux__
+    if (!listenSockets.empty() && listenSockets.size() != threadCount) {
+        logMessage("Expected one listening socket per I/O thread", LOG_ERROR);
+        closeListenSockets(listenSockets, 0);
+        return false;
+    }
+    for (size_t i = 0; i < threadCount; ++i) {
+        auto ioThread = std::make_shared<IoThread>();
+        if (!listenSockets.empty()) {
+            // The thread closes its listening socket when it is destroyed, even if setting it up fails
+            ioThread->listenFd = listenSockets[i];
+        }
+        ioThread->epollFd = epoll_create1(EPOLL_CLOEXEC);
+        ioThread->wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        epoll_event wakeEvent{};
+        wakeEvent.events = EPOLLIN;
+        wakeEvent.data.fd = ioThread->wakeFd;
+        if (ioThread->epollFd == -1 || ioThread->wakeFd == -1 ||
+            epoll_ctl(ioThread->epollFd, EPOLL_CTL_ADD, ioThread->wakeFd, &wakeEvent) == -1) {
+            logMessage("Failed to create epoll instance: " + std::string(strerror(errno)), LOG_ERROR);
+            closeListenSockets(listenSockets, i + 1);
+            ioThreads.clear();
+            return false;
+        }
+        if (!listenSockets.empty() && !addListener(*ioThread, listenSockets[i])) {
+            closeListenSockets(listenSockets, i + 1);
+            ioThreads.clear();
+            return false;
+        }
+        ioThreads.push_back(std::move(ioThread));
+    }
+
+    running.store(true);
+    unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t i = 0; i < ioThreads.size(); ++i) {
+        ioThreads[i]->thread = std::thread(&NetworkReactor::ioLoop, this, ioThreads[i]);
+        if (listenSockets.empty()) {
+            continue;
+        }
+        // Each shard accepts and serves its own connections, keep it and their state on one core
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(i % cores, &cpus);
+        if (pthread_setaffinity_np(ioThreads[i]->thread.native_handle(), sizeof(cpus), &cpus) != 0) {
+            logMessage("Failed to pin I/O thread " + std::to_string(i) + " to a core", LOG_WARNING);
+        }
+    }
+    logMessage("Network reactor started with " + std::to_string(threadCount) + " I/O threads" +
+               (listenSockets.empty() ? "" : ", each accepting on its own SO_REUSEPORT socket"), LOG_DEBUG);
+#else
+    if (!listenSockets.empty()) {
+        logMessage("SO_REUSEPORT listeners are only supported on Linux", LOG_ERROR);
+        closeListenSockets(listenSockets, 0);
+        return false;
+    }
+    running.store(true);
+#endif
+    return true;
+}
+
+void NetworkReactor::stop() {
+    if (!running.exchange(false)) return;
+
+#ifdef __linux__
+    for (auto& ioThread : ioThreads) {
+        if (ioThread->thread.joinable()) {
+            ioThread->thread.join();
+        }
+
+        std::vector<std::shared_ptr<ClientConnection>> remaining;
+        {
+            std::lock_guard lock(ioThread->mutex);
+            for (auto& client : ioThread->connections | std::views::values) {
+                remaining.push_back(client);
+            }
+        }
+        for (auto& client : remaining) {
+            closeConnection(*ioThread, client);
+        }
+    }
+    ioThreads.clear();
+#endif
+}
+
+void NetworkReactor::addConnection(SocketType socket) {
+#ifdef __linux__
+    registerConnection(ioThreads[nextThread.fetch_add(1) % ioThreads.size()], socket);
+#else
+    std::thread(handleClient, socket).detach();
+#endif
+}
+
+bool NetworkReactor::addListener(IoThread& ioThread, SocketType socket) {
+#ifdef __linux__
+    ioThread.listenFd = socket;
+    int flags = fcntl(socket, F_GETFL, 0);
+    if (flags == -1 || fcntl(socket, F_SETFL, flags | O_NONBLOCK) == -1) {
+        logMessage("Failed to make listening socket non-blocking: " + std::string(strerror(errno)), LOG_ERROR);
+        return false;
+    }
+
+    // Level-triggered, acceptConnections takes a bounded batch so existing clients keep being served
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = socket;
+    if (epoll_ctl(ioThread.epollFd, EPOLL_CTL_ADD, socket, &event) == -1) {
+        logMessage("Failed to register listening socket: " + std::string(strerror(errno)), LOG_ERROR);
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void NetworkReactor::wait() {
+    for (auto& ioThread : ioThreads) {
+        if (ioThread->thread.joinable()) {
+            ioThread->thread.join();
+        }
+    }
+}
+
+void NetworkReactor::acceptConnections(const std::shared_ptr<IoThread>& owner) {
+#ifdef __linux__
+    for (int i = 0; i < MAX_ACCEPTS_PER_WAKEUP; ++i) {
+        SocketType socket = accept4(owner->listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (socket == INVALID_SOCKET) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                logMessage("Failed to accept client connection: " + std::string(strerror(errno)), LOG_ERROR);
+            }
+            return;
+        }
+        registerConnection(owner, socket);
+    }
+#endif
+}
+
+void NetworkReactor::registerConnection(const std::shared_ptr<IoThread>& owner, SocketType socket) {
+#ifdef __linux__
+    // Connections stay on the I/O thread they were assigned to
+    IoThread& ioThread = *owner;
+
+    int flags = fcntl(socket, F_GETFL, 0);
+    if (flags == -1 || fcntl(socket, F_SETFL, flags | O_NONBLOCK) == -1) {
+        logMessage("Failed to make client socket non-blocking: " + std::string(strerror(errno)), LOG_ERROR);
+        close(socket);
+        return;
+    }
+
+    // Packets are batched per tick, so Nagle would only add latency
+    int noDelay = 1;
+    setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+    auto client = std::make_shared<ClientConnection>();
+    client->socket = socket;
+    client->state = ClientState::Handshake;
+    client->flushHandler = [weakThread = std::weak_ptr(owner), weakClient = std::weak_ptr(client)] {
+        if (auto ioThread = weakThread.lock()) {
+            requestFlush(*ioThread, weakClient);
+        }
+    };
+
+    {
+        std::lock_guard lock(ioThread.mutex);
+        ioThread.connections[socket] = client;
+    }
+
+    // Edge-triggered: reads drain the socket, and EPOLLOUT only reports a full send buffer draining
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    event.data.fd = socket;
+    if (epoll_ctl(ioThread.epollFd, EPOLL_CTL_ADD, socket, &event) == -1) {
+        logMessage("Failed to register client socket: " + std::string(strerror(errno)), LOG_ERROR);
+        std::lock_guard lock(ioThread.mutex);
+        ioThread.connections.erase(socket);
+    }
+#endif
+}
+
+void NetworkReactor::ioLoop(const std::shared_ptr<IoThread>& owner) {
+#ifdef __linux__
+    IoThread& ioThread = *owner;
+    epoll_event events[MAX_EVENTS];
+    auto lastSweep = std::chrono::steady_clock::now();
+
+    while (running.load()) {
+        int eventCount = epoll_wait(ioThread.epollFd, events, MAX_EVENTS, EPOLL_TIMEOUT_MS);
+        if (eventCount == -1) {
+            if (errno == EINTR) continue;
+            logMessage("epoll_wait failed: " + std::string(strerror(errno)), LOG_ERROR);
+            break;
+        }
+
+        for (int i = 0; i < eventCount; ++i) {
+            if (events[i].data.fd == ioThread.wakeFd) {
+                flushRequested(ioThread);
+                continue;
+            }
+            if (events[i].data.fd == ioThread.listenFd) {
+                acceptConnections(owner);
+                continue;
+            }
+
+            std::shared_ptr<ClientConnection> client;
+            {
+                std::lock_guard lock(ioThread.mutex);
+                auto it = ioThread.connections.find(events[i].data.fd);
+                if (it == ioThread.connections.end()) continue;
+                client = it->second;
+            }
+
+            if (events[i].events & EPOLLIN) {
+                handleReadable(ioThread, client);
+            } else if (events[i].events & (EPOLLERR | EPOLLHUP | EPOLLRDHUP)) {
+                closeConnection(ioThread, client);
+                continue;
+            }
+            if (events[i].events & EPOLLOUT) {
+                // Room in the send buffer again, carry on with whatever a previous flush left behind
+                flushPackets(*client);
+            }
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastSweep >= std::chrono::seconds(1)) {
+            closeIdleConnections(ioThread);
+            lastSweep = now;
+        }
+    }
+#endif
+}
+
+void NetworkReactor::requestFlush(IoThread& ioThread, const std::weak_ptr<ClientConnection>& client) {
+    bool wake;
+    {
+        std::lock_guard lock(ioThread.flushMutex);
+        wake = ioThread.flushRequests.empty();
+        ioThread.flushRequests.push_back(client);
+    }
+#ifdef __linux__
+    // One wakeup per batch of requests
+    if (wake) {
+        uint64_t one = 1;
+        write(ioThread.wakeFd, &one, sizeof(one));
+    }
+#endif
+}
+
+void NetworkReactor::flushRequested(IoThread& ioThread) {
+#ifdef __linux__
+    uint64_t count;
+    read(ioThread.wakeFd, &count, sizeof(count));
+#endif
+
+    std::vector<std::weak_ptr<ClientConnection>> requests;
+    {
+        std::lock_guard lock(ioThread.flushMutex);
+        requests.swap(ioThread.flushRequests);
+    }
+    for (const auto& request : requests) {
+        if (auto client = request.lock()) {
+            flushPackets(*client);
+        }
+    }
+}
+
+void NetworkReactor::handleReadable(IoThread& ioThread, const std::shared_ptr<ClientConnection>& client) {
+    try {
+        // Drain the socket, handing every chunk to the connection's state machine
+        while (true) {
+            int received = receiveIntoBuffer(*client);
+            if (received > 0) {
+                if (!handleClientData(*client)) {
+                    closeConnection(ioThread, client);
+                    return;
+                }
+                continue;
+            }
+            if (received == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                // Answer everything this batch of packets produced in one write
+                flushPackets(*client);
+                return;
+            }
+            if (received == -1 && errno == EINTR) {
+                continue;
+            }
+            // Peer closed the connection or the socket failed
+            closeConnection(ioThread, client);
+            return;
+        }
+    } catch (const std::exception& e) {
+        logMessage("Client disconnected with error: " + std::string(e.what()), LOG_ERROR);
+        closeConnection(ioThread, client);
+    }
+}
+
+void NetworkReactor::closeConnection(IoThread& ioThread, const std::shared_ptr<ClientConnection>& client) {
+    {
+        std::lock_guard lock(ioThread.mutex);
+        if (ioThread.connections.erase(client->socket) == 0) {
+            return; // Already closed
+        }
+    }
+
+#ifdef __linux__
+    epoll_ctl(ioThread.epollFd, EPOLL_CTL_DEL, client->socket, nullptr);
+#endif
+    handleConnectionClosed(*client);
+
+    // The descriptor itself is closed once the last reference to the connection goes away
+    shutdownSocket(client->socket);
+}
+
+void NetworkReactor::closeIdleConnections(IoThread& ioThread) {
+    auto now = std::chrono::steady_clock::now();
+    std::vector<std::shared_ptr<ClientConnection>> idle;
+    {
+        std::lock_guard lock(ioThread.mutex);
+        for (auto& client : ioThread.connections | std::views::values) {
+            // Kicked clients that did not read their Disconnect packet in time are closed as well
+            if (now - client->lastReceived > IDLE_TIMEOUT || (client->closing && now >= client->closeDeadline)) {
+                idle.push_back(client);
+            }
+        }
+    }
+
+    for (auto& client : idle) {
+        logMessage(client->closing ? "Closing kicked connection that stopped reading" : "Closing idle connection", LOG_DEBUG);
+        closeConnection(ioThread, client);
+    }
+}
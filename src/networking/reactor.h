@@ -0,0 +1,63 @@
+#ifndef REACTOR_H
+#define REACTOR_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "network.h"
+
+struct ClientConnection;
+
+// Multiplexes client sockets over a fixed set of I/O threads.
+// Uses epoll on Linux, other platforms fall back to a thread per connection.
+class NetworkReactor {
+public:
+    explicit NetworkReactor(size_t threadCount);
+    ~NetworkReactor();
+
+    // With listenSockets (one per I/O thread, Linux only) every thread accepts on its own socket and
+    // keeps the connections it accepted, and is pinned to a core. Otherwise sockets come from addConnection.
+    // Takes ownership of listenSockets, they are closed if starting fails.
+    bool start(const std::vector<SocketType>& listenSockets = {});
+    void stop();
+
+    // Takes ownership of an accepted socket
+    void addConnection(SocketType socket);
+    // Blocks until the I/O threads exit
+    void wait();
+
+private:
+    struct IoThread {
+        int epollFd = -1;
+        int wakeFd = -1; // eventfd used to hand flushes to the thread
+        int listenFd = -1; // SO_REUSEPORT socket this thread accepts on, if any
+        std::thread thread;
+        std::mutex mutex;
+        std::unordered_map<SocketType, std::shared_ptr<ClientConnection>> connections;
+        std::mutex flushMutex;
+        std::vector<std::weak_ptr<ClientConnection>> flushRequests; // Guarded by flushMutex
+
+        ~IoThread();
+    };
+
+    static void requestFlush(IoThread& ioThread, const std::weak_ptr<ClientConnection>& client);
+    static bool addListener(IoThread& ioThread, SocketType socket);
+    void registerConnection(const std::shared_ptr<IoThread>& owner, SocketType socket);
+    void acceptConnections(const std::shared_ptr<IoThread>& owner);
+    void ioLoop(const std::shared_ptr<IoThread>& owner);
+    void flushRequested(IoThread& ioThread);
+    void handleReadable(IoThread& ioThread, const std::shared_ptr<ClientConnection>& client);
+    void closeConnection(IoThread& ioThread, const std::shared_ptr<ClientConnection>& client);
+    void closeIdleConnections(IoThread& ioThread);
+
+    size_t threadCount;
+    std::vector<std::shared_ptr<IoThread>> ioThreads;
+    std::atomic<size_t> nextThread;
+    std::atomic<bool> running;
+};
+
+#endif //REACTOR_H
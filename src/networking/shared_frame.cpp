@@ -0,0 +1,34 @@
+#include "shared_frame.h"
+
+#include "compression_policy.h"
+#include "packet_writer.h"
+#include "core/config.h"
+
+SharedFrame::SharedFrame(std::span<const uint8_t> payload) : frameInfo(describePayload(payload)) {
+    plainFrame.reserve(PacketWriter::HEADROOM + payload.size());
+    plainFrame.resize(PacketWriter::HEADROOM);
+    plainFrame.insert(plainFrame.end(), payload.begin(), payload.end());
+    plainStart = finishFrame(plainFrame, -1).data() - plainFrame.data();
+
+    if (!serverConfig.enableCompression) {
+        return;
+    }
+
+    if (compressPacket(payload, compressedFrame, PacketWriter::HEADROOM)) {
+        compressedStart = finishFrame(compressedFrame, static_cast<int32_t>(payload.size())).data() - compressedFrame.data();
+    } else {
+        compressedFrame = plainFrame;
+        compressedStart = finishFrame(compressedFrame, 0).data() - compressedFrame.data();
+    }
+}
+
+size_t SharedFrame::payloadSize() const {
+    return plainFrame.size() - PacketWriter::HEADROOM;
+}
+
+std::span<const uint8_t> SharedFrame::get(const bool compressionEnabled) const {
+    if (compressionEnabled) {
+        return std::span<const uint8_t>(compressedFrame).subspan(compressedStart);
+    }
+    return std::span<const uint8_t>(plainFrame).subspan(plainStart);
+}
@@ -0,0 +1,34 @@
+#ifndef SHARED_FRAME_H
+#define SHARED_FRAME_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "outbound_lanes.h"
+
+// A packet framed (and compressed, if it is large enough) once for every recipient.
+// Sending it to a connection only costs that connection's encryption, instead of
+// repeating the compression and framing per client. Frames are immutable after
+// construction and passed around as shared_ptr<const SharedFrame>.
+class SharedFrame {
+public:
+    // payload is Packet ID + Data, e.g. PacketWriter::payload()
+    explicit SharedFrame(std::span<const uint8_t> payload);
+
+    // The wire bytes for a connection with or without compression enabled
+    std::span<const uint8_t> get(bool compressionEnabled) const;
+
+    const FrameInfo& info() const { return frameInfo; }
+    // Packet ID + Data
+    size_t payloadSize() const;
+
+private:
+    std::vector<uint8_t> plainFrame;      // Packet Length + Packet ID + Data
+    std::vector<uint8_t> compressedFrame; // Packet Length + Data Length + Packet ID + Data (deflated if the policy allows)
+    size_t plainStart = 0;
+    size_t compressedStart = 0;
+    FrameInfo frameInfo;
+};
+
+#endif //SHARED_FRAME_H
@@ -4,10 +4,8 @@
 #include <string>
 #include <unordered_map>
 
-#include "encryption/rsa_key.h"
 
-
-// Registry Manager to handle registry entries and their IDs (and some other stuff like RSA keys, because why not)
+// Registry Manager to handle registry entries and their IDs
 class RegistryManager {
 public:
     // Maps registry name to a map of entry identifier to ID
@@ -18,11 +16,6 @@ public:
 
     // Retrieves the ID of a registry entry
     int32_t getRegistryID(const std::string& registryName, const std::string& entryIdentifier) const;
-
-    RSAKeyPair& getRSAKeyPair() { return rsaKeyPair; }
-
-private:
-    RSAKeyPair rsaKeyPair;
 };
 
 
@@ -0,0 +1,176 @@
+// MCppServerReplay: feeds a capture written by /capture back through the Play packet handlers.
+// Every captured connection gets a socketless ClientConnection, its packets are handled in capture
+// order as fast as possible, and the time spent per packet ID and per captured tick is reported.
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+#include "commands/CommandBuilder.h"
+#include "core/config.h"
+#include "core/server.h"
+#include "core/utils.h"
+#include "entities/entity_factory.h"
+#include "entities/player.h"
+#include "networking/chunk_sender.h"
+#include "networking/client.h"
+#include "networking/fetch.h"
+#include "networking/packet_capture.h"
+#include "networking/packet_reader.h"
+#include "registries/registry_manager.h"
+#include "world/chunk.h"
+
+struct HandlerTiming {
+    uint64_t count = 0;
+    uint64_t errors = 0;
+    std::chrono::nanoseconds total{0};
+    std::chrono::nanoseconds max{0};
+};
+
+// Logs the captured player in the way completeLogin would, minus the socket and the login packets.
+// The connection is marked closed so everything the handlers send is dropped before it is framed.
+static std::shared_ptr<ClientConnection> spawnPlayer(const CapturedPlayer& captured) {
+    auto connection = std::make_shared<ClientConnection>();
+    connection->state = ClientState::Play;
+    connection->connectionClosed = true;
+    connection->playerName = captured.name;
+    connection->uuidBytes = captured.uuid;
+    connection->registryManager = std::make_shared<RegistryManager>();
+
+    std::shared_ptr<Player> player = EntityFactory::createPlayer(captured.uuid, captured.name);
+    std::string uuid = bytesToUUIDString(captured.uuid);
+    std::erase(uuid, '-');
+    player->uuidString = uuid;
+    player->gameMode = static_cast<Gamemode>(captured.gameMode);
+    player->listed = true;
+    player->ping = 0;
+    player->setPosition(captured.x, captured.y, captured.z);
+    player->rotation.yaw = captured.yaw;
+    player->rotation.pitch = captured.pitch;
+    player->currentChunkX = getChunkCoordinate(captured.x);
+    player->currentChunkZ = getChunkCoordinate(captured.z);
+    player->setClient(connection.get());
+    connection->playerUUID = uuid;
+    connection->player = player;
+
+    {
+        std::lock_guard lock(playersMutex);
+        globalPlayers[uuid] = player;
+        globalPlayersName[captured.name] = player;
+    }
+    ++playerCount;
+    {
+        std::lock_guard lock(connectedClientsMutex);
+        connectedClients[uuid] = connection.get();
+    }
+    return connection;
+}
+
+static std::string formatPacketID(const int32_t packetID) {
+    std::stringstream out;
+    out << "0x" << std::hex << std::setw(2) << std::setfill('0') << packetID;
+    return out.str();
+}
+
+static std::string formatMillis(const std::chrono::nanoseconds duration) {
+    std::stringstream out;
+    out << std::fixed << std::setprecision(3) << std::chrono::duration<double, std::milli>(duration).count() << " ms";
+    return out.str();
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cout << "Usage: MCppServerReplay <capture file>\n"
+                     "Run it from the server's working directory, without a world/ folder to replay against a fresh world.\n";
+        return 1;
+    }
+
+    PacketCapture capture;
+    if (!loadPacketCapture(argv[1], capture)) {
+        return 1;
+    }
+    if (std::filesystem::exists("world/region")) {
+        logMessage("world/region exists, chunks will be loaded from it instead of generated", LOG_WARNING);
+    }
+
+    loadConfig();
+    loadGameData();
+    if (serverConfig.enableSecureChat) {
+        loadMojangPublicKeys();
+    }
+    buildAllCommands();
+    serverConfig.ticksPerSecond = capture.ticksPerSecond;
+
+    std::unordered_map<uint32_t, const CapturedPlayer*> players;
+    for (const CapturedPlayer& player : capture.players) {
+        players[player.connection] = &player;
+    }
+    std::unordered_map<uint32_t, std::shared_ptr<ClientConnection>> connections;
+
+    std::map<int32_t, HandlerTiming> handlers;
+    std::chrono::nanoseconds worstTick{0};
+    std::chrono::nanoseconds currentTick{0};
+    uint64_t worstTickNumber = 0;
+    uint64_t tick = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (const CapturedPacket& packet : capture.packets) {
+        // Chunk batches, timers such as mining stages and the batched block changes run between ticks, like on the live server
+        while (tick < packet.tick) {
+            if (currentTick > worstTick) {
+                worstTick = currentTick;
+                worstTickNumber = tick;
+            }
+            currentTick = std::chrono::nanoseconds(0);
+            sendChunkBatches();
+            timerWheel.tick();
+            flushBlockChanges();
+            tick++;
+        }
+
+        std::shared_ptr<ClientConnection>& connection = connections[packet.connection];
+        if (!connection) {
+            connection = spawnPlayer(*players.at(packet.connection));
+        }
+
+        PacketReader reader(packet.data);
+        int32_t packetID = PacketReader(packet.data).readVarInt();
+        HandlerTiming& timing = handlers[packetID];
+        auto handleStart = std::chrono::steady_clock::now();
+        try {
+            handleClientPacket(*connection, reader, connection->player, *connection->registryManager);
+        } catch (const std::exception& e) {
+            logMessage("Packet " + formatPacketID(packetID) + " from " + connection->playerName + " failed: " + e.what(), LOG_ERROR);
+            timing.errors++;
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - handleStart);
+        timing.count++;
+        timing.total += elapsed;
+        timing.max = std::max(timing.max, elapsed);
+        currentTick += elapsed;
+    }
+    if (currentTick > worstTick) {
+        worstTick = currentTick;
+        worstTickNumber = tick;
+    }
+    auto wall = std::chrono::steady_clock::now() - start;
+
+    double seconds = std::chrono::duration<double>(wall).count();
+    std::cout << std::fixed << std::setprecision(1)
+              << "Replayed " << capture.packets.size() << " packets from " << capture.players.size() << " connections over "
+              << tick << " ticks (" << static_cast<double>(tick) / capture.ticksPerSecond << "s captured) in " << seconds << "s\n"
+              << "  " << static_cast<double>(capture.packets.size()) / std::max(seconds, 1e-9) << " packets/s, worst tick "
+              << worstTickNumber << " took " << formatMillis(worstTick) << " of handler time\n"
+              << "  ID      count   errors        total          avg          max\n";
+    for (const auto& [packetID, timing] : handlers) {
+        std::cout << "  " << std::left << std::setw(6) << formatPacketID(packetID) << std::right << std::setw(9) << timing.count
+                  << std::setw(9) << timing.errors << std::setw(13) << formatMillis(timing.total)
+                  << std::setw(13) << formatMillis(timing.total / timing.count) << std::setw(13) << formatMillis(timing.max) << "\n";
+    }
+    std::cout.flush();
+    return 0;
+}
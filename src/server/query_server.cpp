@@ -208,110 +208,10 @@ void QueryServer::sendStatResponse(uint32_t sessionId, int32_t challengeToken, s
     response.push_back((sessionId >> 8) & 0xFF);
     response.push_back(sessionId & 0xFF);
 
-    std::string hostIP = "127.0.0.1"; // For now
-
-    if (fullStat) {
-        // 11 bytes of padding
-        for (int i = 0; i < 11; i++) {
-            response.push_back(0x00);
-        }
-
-        // Payload construction: K,V pairs
-        std::string payload;
-
-        std::string plugins = "";
-
-        payload += "hostname";
-        payload.append(1, '\0');
-        payload += serverConfig.motd;
-        payload.append(1, '\0');
-        payload += "gametype";
-        payload.append(1, '\0');
-        payload += "SMP";
-        payload.append(1, '\0');
-        payload += "game_id";
-        payload.append(1, '\0');
-        payload += "Minecraft";
-        payload.append(1, '\0');
-        payload += "version";
-        payload.append(1, '\0');
-        payload += serverConfig.server_version;
-        payload.append(1, '\0');
-        payload += "plugins";
-        payload.append(1, '\0');
-        payload += plugins;
-        payload.append(1, '\0');
-        payload += "map";
-        payload.append(1, '\0');
-        payload += serverConfig.worldType;
-        payload.append(1, '\0');
-        payload += "numplayers";
-        payload.append(1, '\0');
-        payload += std::to_string(globalPlayers.size());
-        payload.append(1, '\0');
-        payload += "maxplayers";
-        payload.append(1, '\0');
-        payload += std::to_string(serverConfig.maxPlayers);
-        payload.append(1, '\0');
-        payload += "hostport";
-        payload.append(1, '\0');
-        payload += std::to_string(serverConfig.port);
-        payload.append(1, '\0');
-        payload += "hostip";
-        payload.append(1, '\0');
-        payload += hostIP;
-        payload.append(1, '\0');
-
-        // Terminate K,V section with a double null
-        payload.append(1, '\0');
-
-        // Append K,V payload to response
-        response.insert(response.end(), payload.begin(), payload.end());
-
-        // 10 bytes of padding
-        for (int i = 0; i < 10; i++) {
-            response.push_back(0x00);
-        }
-
-        // Players section
-        std::string players = "";
-
-        if (globalPlayers.empty()) {
-            players = '\0';
-        } else {
-            for (const auto &key: globalPlayersName | std::views::keys) {
-                players += key;
-                players.append(1, '\0');
-            }
-            players.append(1, '\0');
-        }
-
-        players.append(1, '\0');
-
-        response.insert(response.end(), players.begin(), players.end());
-    } else {
-        std::string payload;
-        payload += serverConfig.motd;
-        payload.append(1, '\0');
-        payload += "SMP";
-        payload.append(1, '\0');
-        payload += serverConfig.worldType;
-        payload.append(1, '\0');
-        payload += std::to_string(globalPlayers.size());
-        payload.append(1, '\0');
-        payload += std::to_string(serverConfig.maxPlayers);
-        payload.append(1, '\0');
-
-        response.insert(response.end(), payload.begin(), payload.end());
-        uint16_t hostPort = serverConfig.port;
-        response.push_back(hostPort & 0xFF);
-        response.push_back((hostPort >> 8) & 0xFF);
-
-        payload = hostIP;
-        payload.append(1, '\0');
-
-        response.insert(response.end(), payload.begin(), payload.end());
-    }
+    // Payloads are built once per change of the player list, MOTD or icon
+    std::shared_ptr<const StatusSnapshot> status = serverStatus.current();
+    const std::string& payload = fullStat ? status->queryFull : status->queryBasic;
+    response.insert(response.end(), payload.begin(), payload.end());
 
     // Send the response
     ssize_t sent = sendto(udpSocket, reinterpret_cast<char*>(response.data()), response.size(), 0,
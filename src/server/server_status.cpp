@@ -0,0 +1,142 @@
+#include "server_status.h"
+
+#include <ranges>
+#include <nlohmann/json.hpp>
+
+#include "core/config.h"
+#include "core/server.h"
+#include "core/utils.h"
+#include "entities/player.h"
+#include "networking/client.h"
+#include "networking/network.h"
+#include "networking/packet_ids.h"
+#include "networking/packet_writer.h"
+#include "networking/shared_frame.h"
+
+// How often the MOTD and icon file are checked for changes
+constexpr std::chrono::seconds SOURCE_CHECK_INTERVAL(5);
+// Players listed in the server list hover text, as in vanilla
+constexpr size_t MAX_SAMPLE_PLAYERS = 12;
+
+static std::filesystem::file_time_type iconWriteTime() {
+    std::error_code error;
+    auto writeTime = std::filesystem::last_write_time(serverConfig.icon, error);
+    return error ? std::filesystem::file_time_type{} : writeTime;
+}
+
+static void appendField(std::string& payload, const std::string& value) {
+    payload += value;
+    payload.append(1, '\0');
+}
+
+std::shared_ptr<const StatusSnapshot> ServerStatus::current() {
+    auto now = std::chrono::steady_clock::now();
+    std::shared_ptr<const StatusSnapshot> latest = snapshot.load(std::memory_order_acquire);
+    if (latest && !stale.load(std::memory_order_acquire) && now < nextSourceCheck.load(std::memory_order_relaxed)) {
+        return latest;
+    }
+
+    // One thread rebuilds, the others wait for it and share its snapshot
+    std::lock_guard lock(rebuildMutex);
+    latest = snapshot.load(std::memory_order_acquire);
+    if (latest && !stale.load(std::memory_order_acquire)) {
+        if (now < nextSourceCheck.load(std::memory_order_relaxed)) {
+            return latest;
+        }
+        nextSourceCheck.store(now + SOURCE_CHECK_INTERVAL, std::memory_order_relaxed);
+        if (latest->motd == serverConfig.motd && latest->iconWriteTime == iconWriteTime()) {
+            return latest;
+        }
+    }
+
+    // Cleared before building so a player joining meanwhile triggers another rebuild
+    stale.store(false, std::memory_order_release);
+    latest = build();
+    snapshot.store(latest, std::memory_order_release);
+    nextSourceCheck.store(now + SOURCE_CHECK_INTERVAL, std::memory_order_relaxed);
+    return latest;
+}
+
+std::shared_ptr<const StatusSnapshot> ServerStatus::build() {
+    auto status = std::make_shared<StatusSnapshot>();
+    status->motd = serverConfig.motd;
+    status->maxPlayers = serverConfig.maxPlayers;
+    status->iconWriteTime = iconWriteTime();
+    status->onlinePlayers = playerCount.load();
+
+    nlohmann::json sample = nlohmann::json::array();
+    {
+        std::lock_guard lock(connectedClientsMutex);
+        for (const ClientConnection* client : connectedClients | std::views::values) {
+            const Player& player = *client->player;
+            status->playerNames.push_back(player.name);
+            if (sample.size() < MAX_SAMPLE_PLAYERS) {
+                sample.push_back({{"name", player.name}, {"id", bytesToUUIDString(player.uuid)}});
+            }
+        }
+    }
+
+    // Server list ping
+    nlohmann::json responseJson = {
+        {"version", {{"name", serverConfig.server_version}, {"protocol", serverConfig.protocol_version}}},
+        {"players", {{"max", status->maxPlayers}, {"online", status->onlinePlayers}, {"sample", sample}}},
+        {"description", {{"text", status->motd}}}
+    };
+
+    // Add favicon if available
+    std::vector<uint8_t> faviconData = readFile(serverConfig.icon);
+    if (!faviconData.empty()) {
+        responseJson["favicon"] = "data:image/png;base64," + base64Encode(faviconData);
+    }
+
+    PacketWriter writer(STATUS_RESPONSE);
+    writeString(writer.buffer(), responseJson.dump());
+    status->statusResponse = std::make_shared<const SharedFrame>(writer.payload());
+
+    // Query
+    std::string hostIP = "127.0.0.1"; // For now
+    std::string numPlayers = std::to_string(status->onlinePlayers);
+    std::string maxPlayers = std::to_string(status->maxPlayers);
+
+    appendField(status->queryBasic, status->motd);
+    appendField(status->queryBasic, "SMP");
+    appendField(status->queryBasic, serverConfig.worldType);
+    appendField(status->queryBasic, numPlayers);
+    appendField(status->queryBasic, maxPlayers);
+    auto hostPort = static_cast<uint16_t>(serverConfig.port);
+    status->queryBasic.push_back(static_cast<char>(hostPort & 0xFF));
+    status->queryBasic.push_back(static_cast<char>((hostPort >> 8) & 0xFF));
+    appendField(status->queryBasic, hostIP);
+
+    std::string& full = status->queryFull;
+    // 11 bytes of padding
+    full.append(11, '\0');
+    // K,V pairs
+    const std::pair<const char*, std::string> keyValues[] = {
+        {"hostname", status->motd},
+        {"gametype", "SMP"},
+        {"game_id", "Minecraft"},
+        {"version", serverConfig.server_version},
+        {"plugins", ""},
+        {"map", serverConfig.worldType},
+        {"numplayers", numPlayers},
+        {"maxplayers", maxPlayers},
+        {"hostport", std::to_string(serverConfig.port)},
+        {"hostip", hostIP},
+    };
+    for (const auto& [key, value] : keyValues) {
+        appendField(full, key);
+        appendField(full, value);
+    }
+    // Terminate K,V section with a double null
+    full.append(1, '\0');
+    // 10 bytes of padding
+    full.append(10, '\0');
+    // Players section
+    for (const std::string& name : status->playerNames) {
+        appendField(full, name);
+    }
+    full.append(1, '\0');
+
+    return status;
+}
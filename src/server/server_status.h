@@ -0,0 +1,46 @@
+#ifndef SERVER_STATUS_H
+#define SERVER_STATUS_H
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class SharedFrame;
+
+// Everything the server list ping, Query and RCON report about the server, serialized up front.
+// A snapshot is never modified; a new one replaces it when the players, MOTD or icon change.
+struct StatusSnapshot {
+    std::shared_ptr<const SharedFrame> statusResponse; // Status Response packet, favicon included
+    std::string queryBasic; // Basic stat payload, following the type and session ID
+    std::string queryFull;  // Full stat payload, following the type and session ID
+    int onlinePlayers = 0;
+    int maxPlayers = 0;
+    std::vector<std::string> playerNames;
+
+    // The inputs it was built from
+    std::string motd;
+    std::filesystem::file_time_type iconWriteTime;
+};
+
+class ServerStatus {
+public:
+    // The current snapshot. Readers never block unless it is out of date and has to be rebuilt.
+    std::shared_ptr<const StatusSnapshot> current();
+
+    // Forces a rebuild on the next request, called whenever a player joins or leaves
+    void invalidate() { stale.store(true, std::memory_order_release); }
+
+private:
+    static std::shared_ptr<const StatusSnapshot> build();
+
+    std::atomic<std::shared_ptr<const StatusSnapshot>> snapshot;
+    std::atomic<bool> stale{true};
+    std::atomic<std::chrono::steady_clock::time_point> nextSourceCheck{};
+    std::mutex rebuildMutex;
+};
+
+#endif //SERVER_STATUS_H
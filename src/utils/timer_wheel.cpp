@@ -0,0 +1,82 @@
+#include "timer_wheel.h"
+
+#include <algorithm>
+
+TimerWheel::TimerWheel(const size_t slotCount) : slots(std::max<size_t>(slotCount, 1)) {}
+
+void TimerWheel::insert(const TimerId id, Timer timer) {
+    slots[timer.dueTick % slots.size()].push_back(id);
+    timers.emplace(id, std::move(timer));
+}
+
+TimerId TimerWheel::schedule(const uint64_t delayTicks, std::function<void()> callback) {
+    auto wrapped = std::make_shared<std::function<bool()>>([callback = std::move(callback)]() {
+        callback();
+        return false;
+    });
+    std::lock_guard lock(mutex);
+    TimerId id = nextId++;
+    insert(id, {now + std::max<uint64_t>(delayTicks, 1), 0, std::move(wrapped)});
+    return id;
+}
+
+TimerId TimerWheel::scheduleRepeating(const uint64_t intervalTicks, std::function<bool()> callback) {
+    uint64_t interval = std::max<uint64_t>(intervalTicks, 1);
+    std::lock_guard lock(mutex);
+    TimerId id = nextId++;
+    insert(id, {now + interval, interval, std::make_shared<std::function<bool()>>(std::move(callback))});
+    return id;
+}
+
+bool TimerWheel::cancel(const TimerId id) {
+    std::lock_guard lock(mutex);
+    return timers.erase(id) > 0;
+}
+
+void TimerWheel::tick() {
+    std::vector<std::pair<TimerId, std::shared_ptr<std::function<bool()>>>> due;
+    {
+        std::lock_guard lock(mutex);
+        ++now;
+        std::vector<TimerId>& slot = slots[now % slots.size()];
+        std::erase_if(slot, [&](const TimerId id) {
+            auto it = timers.find(id);
+            if (it == timers.end()) {
+                return true; // Cancelled
+            }
+            if (it->second.dueTick != now) {
+                return false; // Due on a later turn of the wheel
+            }
+            due.emplace_back(id, it->second.callback);
+            if (it->second.interval == 0) {
+                timers.erase(it);
+            }
+            return true;
+        });
+
+        // Repeating timers go back in before their callbacks run, so a callback can still cancel its own timer
+        for (const auto& [id, callback] : due) {
+            auto it = timers.find(id);
+            if (it != timers.end()) {
+                it->second.dueTick = now + it->second.interval;
+                slots[it->second.dueTick % slots.size()].push_back(id);
+            }
+        }
+    }
+
+    for (const auto& [id, callback] : due) {
+        if (!(*callback)()) {
+            cancel(id);
+        }
+    }
+}
+
+uint64_t TimerWheel::currentTick() const {
+    std::lock_guard lock(mutex);
+    return now;
+}
+
+size_t TimerWheel::pending() const {
+    std::lock_guard lock(mutex);
+    return timers.size();
+}
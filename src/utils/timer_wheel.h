@@ -0,0 +1,50 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+using TimerId = uint64_t;
+
+// Hashed timer wheel advanced once per server tick. Timers are bucketed by their due tick, so a tick
+// only looks at the timers in one slot instead of polling everything that is waiting.
+// Timers longer than the wheel stay in their slot until the wheel has gone round enough times.
+// Scheduling and cancelling are thread-safe; callbacks run on the thread that calls tick().
+class TimerWheel {
+public:
+    explicit TimerWheel(size_t slotCount = 512);
+
+    // Runs callback once, delayTicks ticks from now (at least one)
+    TimerId schedule(uint64_t delayTicks, std::function<void()> callback);
+    // Runs callback every intervalTicks ticks until it returns false or the timer is cancelled
+    TimerId scheduleRepeating(uint64_t intervalTicks, std::function<bool()> callback);
+    // Returns false if the timer already ran or was cancelled. Id 0 is never a timer.
+    bool cancel(TimerId id);
+
+    // Advances the wheel by one tick and runs the timers that are due
+    void tick();
+
+    uint64_t currentTick() const;
+    size_t pending() const;
+
+private:
+    struct Timer {
+        uint64_t dueTick;
+        uint64_t interval; // 0 for one-shot timers
+        std::shared_ptr<std::function<bool()>> callback;
+    };
+
+    void insert(TimerId id, Timer timer);
+
+    std::vector<std::vector<TimerId>> slots;
+    std::unordered_map<TimerId, Timer> timers; // Cancelled timers are dropped from here, their slot entry is skipped
+    uint64_t now = 0;
+    TimerId nextId = 1;
+    mutable std::mutex mutex;
+};
+
+#endif //TIMER_WHEEL_H
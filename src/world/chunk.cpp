@@ -2,6 +2,7 @@
 
 #include <bitset>
 #include <iostream>
+#include <map>
 #include <tag_array.h>
 #include <tag_list.h>
 #include <tag_string.h>
@@ -9,7 +10,12 @@
 #include <nlohmann/json.hpp>
 
 #include "core/config.h"
+#include "networking/clientbound_packets.h"
 #include "networking/network.h"
+#include "networking/packet_ids.h"
+#include "networking/packet_stats.h"
+#include "networking/packet_writer.h"
+#include "networking/shared_frame.h"
 #include "entities/player.h"
 #include "region_file.h"
 #include "core/server.h"
@@ -205,6 +211,7 @@ void Chunk::setBlock(int32_t x, int32_t y, int32_t z, int32_t blockStateID, bool
 
 void Chunk::markDirty() {
     dirty = true;
+    version.fetch_add(1, std::memory_order_release);
 }
 
 int32_t getLocalCoordinate(int32_t coord) {
@@ -285,11 +292,22 @@ std::vector<uint8_t> encodeBlockIndices(const std::vector<uint8_t>& indices, int
 std::vector<ChunkCoordinates> getChunksInView(int32_t centerChunkX, int32_t centerChunkZ, int viewDistance) {
     std::vector<ChunkCoordinates> chunks;
     chunks.reserve((2 * viewDistance + 1) * (2 * viewDistance + 1));
-
-    for (int dx = -viewDistance; dx <= viewDistance; ++dx) {
-        for (int dz = -viewDistance; dz <= viewDistance; ++dz) {
-            ChunkCoordinates coords{centerChunkX + dx, centerChunkZ + dz};
-            chunks.emplace_back(coords);
+    chunks.emplace_back(centerChunkX, centerChunkZ);
+
+    // Spiral outwards one ring at a time, so the chunks nearest to the center come first
+    for (int ring = 1; ring <= viewDistance; ++ring) {
+        int32_t x = centerChunkX - ring;
+        int32_t z = centerChunkZ - ring;
+        for (int side = 0; side < 4; ++side) {
+            for (int step = 0; step < 2 * ring; ++step) {
+                chunks.emplace_back(x, z);
+                switch (side) {
+                    case 0: ++x; break;
+                    case 1: ++z; break;
+                    case 2: --x; break;
+                    default: --z; break;
+                }
+            }
         }
     }
 
@@ -805,42 +823,138 @@ std::shared_ptr<Chunk> getChunkContainingBlock(int32_t x, int32_t y, int32_t z)
     return nullptr;
 }
 
-void notifyChunkUpdate(const std::shared_ptr<Chunk>& chunk, int32_t x, int32_t y, int32_t z) {
-    // Construct a Block Change packet
-    std::vector<uint8_t> packetData;
-    packetData.push_back(0x09); // Packet ID for Block Update
-
-    // Block Position (VarLong)
-    int64_t position = encodePosition(x, y, z);
-    writeLong(packetData, position);
+// Blocks changed in one chunk section since the last flush
+struct PendingSectionChanges {
+    std::shared_ptr<Chunk> chunk;
+    int32_t sectionY;
+    std::vector<uint16_t> blocks; // Local X << 8 | local Z << 4 | local Y, as in Update Section Blocks
+};
+
+static std::mutex pendingBlockChangesMutex;
+// Keyed by the encoded section position
+static std::unordered_map<int64_t, PendingSectionChanges> pendingBlockChanges;
+// Highest sequence to acknowledge per client, sent after the block changes so the client
+// already has the server's blocks when it drops its prediction
+static std::map<std::weak_ptr<ClientConnection>, int32_t, std::owner_less<>> pendingBlockChangeAcks;
+
+static int64_t encodeSectionPosition(int32_t sectionX, int32_t sectionY, int32_t sectionZ) {
+    return (static_cast<int64_t>(sectionX & 0x3FFFFF) << 42) | (static_cast<int64_t>(sectionZ & 0x3FFFFF) << 20) | (sectionY & 0xFFFFF);
+}
 
-    // Block State ID
+// Block State ID at a world position, air if it is out of the chunk
+static int32_t getBlockStateForUpdate(const Chunk& chunk, int32_t x, int32_t y, int32_t z) {
     try {
-        Block block = chunk->getBlock(getLocalCoordinate(x), y, getLocalCoordinate(z));
-        writeVarInt(packetData, block.blockStateID);
+        return chunk.getBlock(getLocalCoordinate(x), y, getLocalCoordinate(z)).blockStateID;
     } catch (const std::out_of_range& e) {
-        logMessage("notifyChunkUpdate: " + std::string(e.what()), LOG_ERROR);
-        writeVarInt(packetData, 0); // Default to air if out of range
+        logMessage("flushBlockChanges: " + std::string(e.what()), LOG_ERROR);
+        return 0; // Default to air if out of range
     }
+}
 
-    // Determine which chunks are affected (in this case, only the chunk of the block)
+void notifyChunkUpdate(const std::shared_ptr<Chunk>& chunk, int32_t x, int32_t y, int32_t z) {
+    int32_t sectionY = y >> 4;
+    uint16_t local = static_cast<uint16_t>(getLocalCoordinate(x) << 8 | getLocalCoordinate(z) << 4 | (y & 0xF));
+
+    std::lock_guard lock(pendingBlockChangesMutex);
+    PendingSectionChanges& changes = pendingBlockChanges[encodeSectionPosition(chunk->chunkX, sectionY, chunk->chunkZ)];
+    if (!changes.chunk) {
+        changes.chunk = chunk;
+        changes.sectionY = sectionY;
+    }
+    changes.blocks.push_back(local);
+}
+
+void acknowledgeBlockChange(ClientConnection& client, int32_t sequence) {
+    std::lock_guard lock(pendingBlockChangesMutex);
+    auto [it, inserted] = pendingBlockChangeAcks.try_emplace(client.weak_from_this(), sequence);
+    if (!inserted) {
+        it->second = std::max(it->second, sequence);
+    }
+}
 
-    // Broadcast to all players viewing this chunk
+void flushBlockChanges() {
+    std::unordered_map<int64_t, PendingSectionChanges> changed;
+    std::map<std::weak_ptr<ClientConnection>, int32_t, std::owner_less<>> acks;
     {
-        ChunkCoordinates chunkCoords{chunk->chunkX, chunk->chunkZ};
-        std::lock_guard lock(chunkViewersMutex);
-        auto it = chunkViewersMap.find(chunkCoords);
-        if (it != chunkViewersMap.end()) {
-            for (const auto& player : it->second) {
-                sendPacket(*player->client, packetData);
+        std::lock_guard lock(pendingBlockChangesMutex);
+        changed.swap(pendingBlockChanges);
+        acks.swap(pendingBlockChangeAcks);
+    }
+
+    std::vector<std::shared_ptr<Player>> viewers;
+    for (auto& [sectionPosition, changes] : changed) {
+        // A block changed twice in the tick is sent once, with its current state
+        std::ranges::sort(changes.blocks);
+        changes.blocks.erase(std::ranges::unique(changes.blocks).begin(), changes.blocks.end());
+
+        const Chunk& chunk = *changes.chunk;
+        int32_t baseX = chunk.chunkX * CHUNK_WIDTH;
+        int32_t baseY = changes.sectionY * SECTION_HEIGHT;
+        int32_t baseZ = chunk.chunkZ * CHUNK_LENGTH;
+
+        std::unique_ptr<PacketWriter> writer;
+        if (changes.blocks.size() == 1) {
+            // Construct a Block Change packet
+            uint16_t local = changes.blocks.front();
+            int32_t x = baseX + (local >> 8);
+            int32_t y = baseY + (local & 0xF);
+            int32_t z = baseZ + (local >> 4 & 0xF);
+            writer = std::make_unique<PacketWriter>(BLOCK_UPDATE);
+            std::vector<uint8_t>& packetData = writer->buffer();
+
+            // Block Position (VarLong)
+            writeLong(packetData, encodePosition(x, y, z));
+            // Block State ID
+            writeVarInt(packetData, getBlockStateForUpdate(chunk, x, y, z));
+        } else {
+            writer = std::make_unique<PacketWriter>(UPDATE_SECTION_BLOCKS);
+            std::vector<uint8_t>& packetData = writer->buffer();
+
+            // Chunk Section Position (Long)
+            writeLong(packetData, sectionPosition);
+            // Blocks Array Length (VarInt)
+            writeVarInt(packetData, static_cast<int32_t>(changes.blocks.size()));
+            // Blocks Array (VarLong): Block State ID << 12 | local position
+            for (uint16_t local : changes.blocks) {
+                int32_t state = getBlockStateForUpdate(chunk, baseX + (local >> 8), baseY + (local & 0xF), baseZ + (local >> 4 & 0xF));
+                writeVarLong(packetData, static_cast<uint64_t>(state) << 12 | local);
             }
         }
+
+        // Broadcast to all players viewing this chunk, outside the lock
+        auto frame = std::make_shared<const SharedFrame>(writer->payload());
+        viewers.clear();
+        {
+            std::lock_guard lock(chunkViewersMutex);
+            auto it = chunkViewersMap.find(ChunkCoordinates{chunk.chunkX, chunk.chunkZ});
+            if (it != chunkViewersMap.end()) {
+                viewers = it->second;
+            }
+        }
+        for (const auto& player : viewers) {
+            sendPacket(*player->client, frame);
+        }
+    }
+
+    for (const auto& [weakClient, sequence] : acks) {
+        if (std::shared_ptr<ClientConnection> client = weakClient.lock()) {
+            sendAcknowledgeBlockChange(*client, sequence);
+        }
     }
 }
 
-void sendChunkDataToPlayer(ClientConnection& client, const std::shared_ptr<Chunk>& chunk) {
-    std::vector<uint8_t> packetData;
-    packetData.push_back(0x27); // Packet ID for Chunk Data
+// Returns the chunk's Chunk Data packet, serializing and compressing it only if a block changed
+// since it was last built. Holding packetMutex while building means players loading the same
+// chunk at once wait for one serialization instead of each doing their own.
+static std::shared_ptr<const SharedFrame> getChunkDataPacket(const std::shared_ptr<Chunk>& chunk) {
+    std::lock_guard lock(chunk->packetMutex);
+    uint64_t version = chunk->version.load(std::memory_order_acquire);
+    if (chunk->cachedPacket && chunk->cachedPacketVersion == version) {
+        return chunk->cachedPacket;
+    }
+
+    PacketWriter writer(0x27); // Packet ID for Chunk Data
+    std::vector<uint8_t>& packetData = writer.buffer();
 
     // Chunk X and Z
     writeInt(packetData, chunk->chunkX);
@@ -850,8 +964,15 @@ void sendChunkDataToPlayer(ClientConnection& client, const std::shared_ptr<Chunk
     std::vector<uint8_t> serializedChunkData = serializeChunkData(chunk);
     writeBytes(packetData, serializedChunkData);
 
+    chunk->cachedPacket = std::make_shared<const SharedFrame>(writer.payload());
+    chunk->cachedPacketVersion = version;
+    recordSerializeTime(chunk->cachedPacket->info().packetID, nanosSince(writer.startedAt()));
+    return chunk->cachedPacket;
+}
+
+void sendChunkDataToPlayer(ClientConnection& client, const std::shared_ptr<Chunk>& chunk) {
     // Send the packet to the player
-    sendPacket(client, packetData);
+    sendPacket(client, getChunkDataPacket(chunk));
 }
 
 std::shared_ptr<Chunk> generateFlatChunk(const FlatWorldSettings& settings, int32_t chunkX, int32_t chunkZ, int& highestY) {
@@ -1146,6 +1267,53 @@ std::shared_ptr<Chunk> loadChunkFromDisk(int chunkX, int chunkZ) {
     return chunk;
 }
 
+// Chunks requestChunkPacket handed to the thread pool to load or to build their Chunk Data
+// packet, guarded by chunkMapMutex
+static std::unordered_set<ChunkCoordinates> chunksPreparing;
+
+// The chunk's Chunk Data packet if it is built for the chunk as it is now. Never waits for a
+// packet that is being built, that counts as not ready.
+static std::shared_ptr<const SharedFrame> getReadyChunkDataPacket(Chunk& chunk) {
+    std::unique_lock lock(chunk.packetMutex, std::try_to_lock);
+    if (!lock.owns_lock() || !chunk.cachedPacket || chunk.cachedPacketVersion != chunk.version.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    return chunk.cachedPacket;
+}
+
+bool requestChunkPacket(int32_t chunkX, int32_t chunkZ, std::shared_ptr<const SharedFrame>& packet) {
+    ChunkCoordinates coords{chunkX, chunkZ};
+    std::shared_ptr<Chunk> chunk;
+    {
+        std::lock_guard lock(chunkMapMutex);
+        auto it = globalChunkMap.find(coords);
+        if (it != globalChunkMap.end()) {
+            chunk = it->second;
+            if (!chunk) {
+                packet = nullptr;
+                return true; // Can't be generated
+            }
+            if ((packet = getReadyChunkDataPacket(*chunk))) {
+                return true;
+            }
+        }
+        if (!chunksPreparing.insert(coords).second) {
+            return false; // Already on its way
+        }
+    }
+
+    // Loading, serializing and compressing all happen on the pool, the caller only picks up the result
+    threadPool.enqueue([coords, chunk] {
+        std::shared_ptr<Chunk> loaded = chunk ? chunk : getOrLoadChunk(coords.chunkX, coords.chunkZ);
+        if (loaded) {
+            getChunkDataPacket(loaded);
+        }
+        std::lock_guard lock(chunkMapMutex);
+        chunksPreparing.erase(coords);
+    });
+    return false;
+}
+
 std::shared_ptr<Chunk> getOrLoadChunk(int32_t chunkX, int32_t chunkZ) {
     ChunkCoordinates coords{chunkX, chunkZ};
     {
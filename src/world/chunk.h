@@ -1,5 +1,6 @@
 #ifndef CHUNK_H
 #define CHUNK_H
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -12,6 +13,7 @@
 #include "core/server.h"
 
 struct Player;
+class SharedFrame;
 constexpr int MIN_Y = -64;
 constexpr int CHUNK_WIDTH = 16;
 constexpr int CHUNK_HEIGHT = 384;
@@ -71,6 +73,13 @@ struct Chunk {
     bool dirty;
     Heightmaps heightmaps;
 
+    // Bumped by markDirty, a cached Chunk Data packet is only reused while it matches
+    std::atomic<uint64_t> version{0};
+    // Chunk Data packet framed (and compressed) once for every player loading the chunk
+    std::mutex packetMutex;
+    std::shared_ptr<const SharedFrame> cachedPacket; // Guarded by packetMutex
+    uint64_t cachedPacketVersion = 0;                // Guarded by packetMutex
+
     Chunk(int32_t x, int32_t z) : chunkX(x), chunkZ(z), dirty(false) {}
 
     Block getBlock(int32_t x, int32_t y, int32_t z) const;
@@ -108,12 +117,22 @@ int32_t getLocalCoordinate(int32_t coord);
 int calculateBitsPerEntry(const Palette& palette, int min = 4);
 std::vector<uint8_t> encodeBlockIndices(const std::vector<uint8_t>& indices, int bitsPerEntry);
 std::shared_ptr<Chunk> getChunkContainingBlock(int32_t x, int32_t y, int32_t z);
+// Queues a changed block for the viewers of its chunk, sent by flushBlockChanges
 void notifyChunkUpdate(const std::shared_ptr<Chunk> & chunk, int32_t x, int32_t y, int32_t z);
+// Acknowledges a client's block change sequence once the changes it caused have been sent
+void acknowledgeBlockChange(ClientConnection& client, int32_t sequence);
+// Sends the blocks changed since the last call: a Block Update for a section with one changed
+// block, an Update Section Blocks for the others. Called at the end of every tick.
+void flushBlockChanges();
 void updatePlayerChunkView(const std::shared_ptr<Player> & player, int32_t oldChunkX, int32_t oldChunkZ, int32_t newChunkX, int32_t newChunkZ);
 std::shared_ptr<Chunk> loadChunkFromDisk(int chunkX, int chunkZ);
 std::shared_ptr<Chunk> generateFlatChunk(const FlatWorldSettings& settings, int32_t chunkX, int32_t chunkZ, int& highestY);
 void sendChunkDataToPlayer(ClientConnection& client, const std::shared_ptr<Chunk>& chunk);
 std::shared_ptr<Chunk> getOrLoadChunk(int32_t chunkX, int32_t chunkZ);
+// Returns true with the chunk's Chunk Data packet (null if the chunk can't be generated) once the
+// chunk is in memory and its packet is built for its current blocks. Otherwise starts loading the
+// chunk and building the packet on the thread pool and returns false without waiting.
+bool requestChunkPacket(int32_t chunkX, int32_t chunkZ, std::shared_ptr<const SharedFrame>& packet);
 bool sendCurrentChunkToPlayer(ClientConnection& client, int chunkX, int chunkZ);
 std::vector<ChunkCoordinates> getChunksInView(int32_t centerChunkX, int32_t centerChunkZ, int viewDistance);
 
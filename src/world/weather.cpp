@@ -1,16 +1,22 @@
 #include "weather.h"
 
+#include "core/server.h"
 #include "networking/clientbound_packets.h"
 
 void Weather::setWeather(WeatherType type, int durationTicks) {
+    std::lock_guard lock(mutex);
     currentWeather = type;
     switch (type) {
         case WeatherType::CLEAR:
+            if (clearCounter == 0) {
+                pauseNaturalWeather();
+            }
             if (durationTicks > 0) {
                 clearCounter = durationTicks;
             } else {
                 setRandomClearDuration();
             }
+            scheduleClear();
             if (currentRainState) {
                 setRainState(false);
             }
@@ -19,24 +25,37 @@ void Weather::setWeather(WeatherType type, int durationTicks) {
             }
             break;
         case WeatherType::RAIN:
-            clearCounter = 0;
+            if (clearCounter > 0) {
+                clearCounter = 0;
+                timerWheel.cancel(clearTimer);
+                clearTimer = 0;
+                resumeNaturalWeather();
+            }
             if (durationTicks > 0) {
                 rainCounter = durationTicks;
             } else {
                 setRandomRainDuration();
             }
+            scheduleRain();
             if (!currentRainState) {
                 setRainState(true);
             }
             break;
         case WeatherType::THUNDER:
-            clearCounter = 0;
+            if (clearCounter > 0) {
+                clearCounter = 0;
+                timerWheel.cancel(clearTimer);
+                clearTimer = 0;
+                resumeNaturalWeather();
+            }
             if (durationTicks > 0) {
                 thunderCounter = durationTicks;
                 rainCounter = durationTicks;
             } else {
                 setRandomThunderAndRainDuration();
             }
+            scheduleRain();
+            scheduleThunder();
             if (!currentRainState) {
                 setRainState(true);
             }
@@ -47,40 +66,86 @@ void Weather::setWeather(WeatherType type, int durationTicks) {
     }
 }
 
-void Weather::handleTick() {
+void Weather::start() {
     std::lock_guard lock(mutex);
+    scheduleRain();
+    scheduleThunder();
+}
 
-    // Handle clear counter
-    if (clearCounter > 0) {
-        clearCounter--;
-        if (clearCounter == 0) {
-            // Clear period ended, resume natural weather
-            currentWeather = naturalWeatherState();
-            notifyWeatherChange(currentWeather);
-        }
-        // Handle smooth transitions (lerping)
-        handleLerping();
+void Weather::scheduleClear() {
+    timerWheel.cancel(clearTimer);
+    clearDueTick = timerWheel.currentTick() + clearCounter;
+    clearTimer = timerWheel.schedule(clearCounter, [this]() { onClearEnded(); });
+}
+
+void Weather::scheduleRain() {
+    timerWheel.cancel(rainTimer);
+    rainDueTick = timerWheel.currentTick() + rainCounter;
+    rainTimer = timerWheel.schedule(rainCounter, [this]() { onRainTimer(); });
+}
+
+void Weather::scheduleThunder() {
+    timerWheel.cancel(thunderTimer);
+    thunderDueTick = timerWheel.currentTick() + thunderCounter;
+    thunderTimer = timerWheel.schedule(thunderCounter, [this]() { onThunderTimer(); });
+}
+
+void Weather::pauseNaturalWeather() {
+    uint64_t now = timerWheel.currentTick();
+    if (timerWheel.cancel(rainTimer)) {
+        rainCounter = static_cast<int>(std::max<uint64_t>(rainDueTick - now, 1));
+    }
+    if (timerWheel.cancel(thunderTimer)) {
+        thunderCounter = static_cast<int>(std::max<uint64_t>(thunderDueTick - now, 1));
+    }
+    rainTimer = 0;
+    thunderTimer = 0;
+}
+
+void Weather::resumeNaturalWeather() {
+    scheduleRain();
+    scheduleThunder();
+}
+
+// A timer that was replaced or cancelled while the tick loop was about to run it finds its due tick
+// moved on or its id cleared, and does nothing
 
-        // When clearCounter is active, override other weather states
+void Weather::onClearEnded() {
+    std::lock_guard lock(mutex);
+    if (clearTimer == 0 || timerWheel.currentTick() < clearDueTick) {
         return;
     }
+    clearCounter = 0;
+    clearTimer = 0;
+    // Clear period ended, resume natural weather
+    currentWeather = naturalWeatherState();
+    notifyWeatherChange(currentWeather);
+    resumeNaturalWeather();
+}
 
-    // Handle rain counter
-    if (rainCounter > 0) {
-        rainCounter--;
-        if (rainCounter == 0) {
-            toggleRain();
-        }
+void Weather::onRainTimer() {
+    std::lock_guard lock(mutex);
+    if (rainTimer == 0 || timerWheel.currentTick() < rainDueTick) {
+        return;
     }
+    rainTimer = 0;
+    toggleRain();
+    scheduleRain();
+    updateWeather();
+}
 
-    // Handle thunder counter
-    if (thunderCounter > 0) {
-        thunderCounter--;
-        if (thunderCounter == 0) {
-            toggleThunder();
-        }
+void Weather::onThunderTimer() {
+    std::lock_guard lock(mutex);
+    if (thunderTimer == 0 || timerWheel.currentTick() < thunderDueTick) {
+        return;
     }
+    thunderTimer = 0;
+    toggleThunder();
+    scheduleThunder();
+    updateWeather();
+}
 
+void Weather::updateWeather() {
     // Determine current weather based on rain and thunder states
     WeatherType newWeather = WeatherType::CLEAR;
     if (currentRainState) {
@@ -94,9 +159,22 @@ void Weather::handleTick() {
         currentWeather = newWeather;
         notifyWeatherChange(currentWeather);
     }
+}
 
-    // Handle smooth transitions (lerping)
-    handleLerping();
+void Weather::startLerping() {
+    if (lerpTimer != 0) {
+        return;
+    }
+    lerpTimer = timerWheel.scheduleRepeating(1, [this]() {
+        std::lock_guard lock(mutex);
+        // Handle smooth transitions (lerping)
+        handleLerping();
+        if (rainLerpTicksRemaining > 0 || thunderLerpTicksRemaining > 0) {
+            return true;
+        }
+        lerpTimer = 0;
+        return false;
+    });
 }
 
 void Weather::notifyWeatherChange(WeatherType type) {
@@ -122,6 +200,7 @@ void Weather::notifyWeatherChange(WeatherType type) {
             // Calculate fixed delta once
             rainDelta = (targetRainLevel - currentRainLevel) / static_cast<float>(TRANSITION_TICKS);
             rainLerpTicksRemaining = TRANSITION_TICKS;
+            startLerping();
         }
     }
 
@@ -134,6 +213,7 @@ void Weather::notifyWeatherChange(WeatherType type) {
             // Calculate fixed delta once
             thunderDelta = (targetThunderLevel - currentThunderLevel) / static_cast<float>(TRANSITION_TICKS);
             thunderLerpTicksRemaining = TRANSITION_TICKS;
+            startLerping();
         }
     }
 
@@ -4,6 +4,8 @@
 #include <random>
 #include <thread>
 
+#include "utils/timer_wheel.h"
+
 // Enum for different weather types
 enum class WeatherType {
     CLEAR,
@@ -70,16 +72,26 @@ public:
     // Set weather with specified type and duration
     void setWeather(WeatherType type, int durationTicks);
 
-    void handleTick();
+    // Schedules the natural weather cycle on the timer wheel
+    void start();
 
 private:
     WeatherType currentWeather;
 
-    // Counters for natural weather
+    // Counters for natural weather, in ticks. The rain and thunder counters are only up to date while
+    // their timers are paused by a clear period.
     int clearCounter;    // Only active when /weather clear is used
     int rainCounter;
     int thunderCounter;
 
+    TimerId clearTimer = 0;
+    TimerId rainTimer = 0;
+    TimerId thunderTimer = 0;
+    TimerId lerpTimer = 0;
+    uint64_t clearDueTick = 0;
+    uint64_t rainDueTick = 0;
+    uint64_t thunderDueTick = 0;
+
     bool currentRainState;
     bool currentThunderState;
 
@@ -130,6 +142,21 @@ private:
     void setThunderLevel(float level);
     // Handle smooth transitions
     void handleLerping();
+    // Runs handleLerping every tick until both transitions are done
+    void startLerping();
+    // (Re)start the timers for the current counters
+    void scheduleClear();
+    void scheduleRain();
+    void scheduleThunder();
+    // Hold the rain and thunder timers for a clear period, and pick them back up afterward
+    void pauseNaturalWeather();
+    void resumeNaturalWeather();
+    // Timer callbacks
+    void onClearEnded();
+    void onRainTimer();
+    void onThunderTimer();
+    // Notify clients if rain or thunder changed the weather
+    void updateWeather();
     // Toggle rain on/off
     void toggleRain();
     // Toggle thunder on/off